@@ -0,0 +1,219 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include "Tortuino.h"
+# include "TortuinoMesures.h"
+# include "TortuinoEstimation.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+
+
+/**
+ * @file BancTortuino.cpp
+ * @brief Ce programme mesure ce que coûte chacun des dessins de TortuinoDessins.h.
+ * @version 1.0
+ *
+ * Le programme bancTortuino exécute sans robot tous les dessins de TortuinoDessins.h en faisant
+ * varier leur premier paramètre : le nombre de niveaux de 1 à 15 pour les dessins récursifs, le
+ * nombre de côtés ou la taille pour les autres. Pour chaque exécution, il affiche une ligne au
+ * format CSV avec :
+ * - le nombre de pas faits par chaque roue ;
+ * - le nombre de mouvements du feutre ;
+ * - la distance parcourue feutre levé et feutre baissé, en centimètres, une fois les commandes
+ *   combinées ;
+ * - le nombre d'appels aux fonctions de base avancer(), tournerGauche(), monterFeutre() et
+ *   descendreFeutre() ;
+ * - la profondeur de récursion maximale atteinte par le dessin, ou la hauteur maximale de la
+ *   pile de TortuinoLSysteme.cpp pour les fractales ;
+ * - la durée que mettrait le robot à le tracer, en secondes, aux vitesses choisies ;
+ * - le temps de calcul qu'il a fallu à l'ordinateur pour l'exécuter, en secondes ;
+ * - le nombre de pas de chaque roue et la durée que prévoit TortuinoEstimation.cpp, puis le temps
+ *   de calcul de cette estimation, en secondes.
+ *
+ * Toutes les colonnes sauf les temps de calcul sont déterministes : deux versions de la
+ * bibliothèque peuvent donc être comparées en comparant simplement leurs sorties. Les
+ * options sont :
+ *
+ * {@code
+ * 	./bancTortuino [-n niveauMax] [-v vitesse] [-d vitesseDeplacement] [-c tolerance] [-m pasMax] [-e 1] [dessin...]
+ * }
+ *
+ * où les vitesses sont celles de vitesse(int v) et vitesseDeplacement(int v), en tours par
+ * minute, où la tolérance active le mode continu de continu(float tolerance), et où les dessins
+ * donnés restreignent le banc à ceux-ci. Chaque pas étant simulé, un dessin dont une exécution
+ * dépasse pasMax pas, vingt millions par défaut, n'est pas mesuré aux valeurs suivantes : une
+ * courbe de Von Koch de niveau 15 demanderait plus de cent milliards de pas. L'option `-e 1` ne
+ * fait que les estimations, sans rien simuler : les colonnes mesurées restent alors vides, mais
+ * tous les niveaux sont estimés en un instant.
+ */
+
+
+
+/**
+ * Ce que l'observateur compte au fil des événements d'une exécution.
+ */
+struct Compteurs {
+	unsigned long long pasGauche;										/**< Le nombre de pas de la roue gauche. */
+	unsigned long long pasDroite;										/**< Le nombre de pas de la roue droite. */
+	unsigned long basculesFeutre;										/**< Le nombre de mouvements du feutre. */
+};
+
+Compteurs		compteurs;						/**< Les compteurs de l'exécution en cours. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui met à jour les compteurs.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	switch (evenement.type) {
+		case EVENEMENT_PAS_GAUCHE:
+			compteurs.pasGauche++;
+			break;
+		case EVENEMENT_PAS_DROITE:
+			compteurs.pasDroite++;
+			break;
+		case EVENEMENT_FEUTRE:
+			compteurs.basculesFeutre++;
+			break;
+	}
+}
+
+/**
+ * Exécute un dessin une fois et affiche la ligne de ses mesures.
+ *
+ * @param  figure                 Le dessin à exécuter.
+ * @param  parametres             Ses paramètres.
+ * @param  vitesseTrace           La vitesse des tracés, en tours par minute.
+ * @param  vitesseDeplacementLeve La vitesse des déplacements feutre levé, en tours par minute.
+ * @param  tolerance              La tolérance du mode continu, ou 0 pour le désactiver.
+ * @param  estimationSeule        Vrai pour ne faire que l'estimation, sans simuler le dessin.
+ * @return                        Le nombre de pas de la roue qui en a fait le plus, ou 0 si le
+ * 								  dessin n'a pas été simulé.
+ */
+unsigned long long mesurer(const Figure &figure, const float *parametres, int vitesseTrace, int vitesseDeplacementLeve, float tolerance, bool estimationSeule) {
+	initialiser();														// Le robot repart du même état à chaque exécution,
+	vitesse(vitesseTrace);
+	vitesseDeplacement(vitesseDeplacementLeve);
+	continu(tolerance);
+
+	clock_t debutEstimation = clock();									// L'estimation est faite avant,
+	estimationDemarrer();												// et ne fait bouger ni le robot ni l'horloge.
+	figure.tracer(parametres);
+	Estimation estimation = estimationTerminer();
+	double calculEstimation = (double)(clock() - debutEstimation) / CLOCKS_PER_SEC;
+
+	printf("%s,", figure.nom);
+	for (int i = 0; i < figure.nbParametres; i++) {
+		printf(i == 0 ? "%g" : " %g", parametres[i]);
+	}
+	if (estimationSeule) {
+		printf(",,,,,,,,,,%llu,%llu,%.2f,%.6f\n", estimation.pasGauche, estimation.pasDroite, estimation.duree, calculEstimation);
+		return 0;
+	}
+
+	memset(&compteurs, 0, sizeof(compteurs));							// et toutes les mesures repartent de zéro.
+	mesuresEffacer();
+	uint64_t debut = hoteInstant();
+	clock_t debutCalcul = clock();
+
+	figure.tracer(parametres);
+	terminer();
+
+	double calcul = (double)(clock() - debutCalcul) / CLOCKS_PER_SEC;
+	double duree = (double)(hoteInstant() - debut) / FREQUENCE_MOTEURS;
+
+	printf(",%llu,%llu,%lu,%.2f,%.2f,%lu,%d,%.2f,%.3f,%llu,%llu,%.2f,%.6f\n",
+		compteurs.pasGauche, compteurs.pasDroite, compteurs.basculesFeutre,
+		mesures.distanceLevee, mesures.distanceBaissee,
+		mesures.primitives, mesures.profondeurMax, duree, calcul,
+		estimation.pasGauche, estimation.pasDroite, estimation.duree, calculEstimation);
+	fflush(stdout);
+
+	return compteurs.pasGauche > compteurs.pasDroite ? compteurs.pasGauche : compteurs.pasDroite;
+}
+
+/**
+ * Indique si un dessin fait partie de ceux demandés sur la ligne de commande.
+ *
+ * @param  nom      Le nom du dessin.
+ * @param  demandes Les noms demandés.
+ * @param  nb       Le nombre de noms demandés ; 0 les demande tous.
+ * @return          Vrai si le dessin doit être mesuré.
+ */
+bool estDemande(const char *nom, char **demandes, int nb) {
+	for (int i = 0; i < nb; i++) {
+		if (strcmp(demandes[i], nom) == 0) {
+			return true;
+		}
+	}
+
+	return nb == 0;
+}
+
+int main(int argc, char **argv) {
+	int niveauMax = 15, vitesseTrace = 14, vitesseDeplacementLeve = 18;
+	float tolerance = 0;
+	bool estimationSeule = false;
+	unsigned long long pasMax = 20000000;
+	int i = 1;
+
+	for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {					// Lecture des options.
+		if (strcmp(argv[i], "-n") == 0) {
+			niveauMax = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-v") == 0) {
+			vitesseTrace = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-d") == 0) {
+			vitesseDeplacementLeve = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-c") == 0) {
+			tolerance = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-e") == 0) {
+			estimationSeule = atoi(argv[i + 1]) != 0;
+		}
+		else if (strcmp(argv[i], "-m") == 0) {
+			pasMax = strtoull(argv[i + 1], NULL, 10);
+		}
+		else {
+			fprintf(stderr, "Usage : %s [-n niveauMax] [-v vitesse] [-d vitesseDeplacement] [-c tolerance] [-m pasMax] [-e 1] [dessin...]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	hoteEnregistrer(false);												// Les plus grands dessins font des milliards de pas :
+	hoteObserver(observer);												// ils sont comptés au fil de l'eau, pas enregistrés.
+
+	printf("dessin,parametres,pas_gauche,pas_droite,bascules_feutre,distance_levee_cm,distance_baissee_cm,primitives,profondeur_max,duree_s,calcul_s,pas_gauche_estimes,pas_droite_estimes,duree_estimee_s,calcul_estimation_s\n");
+
+	for (int b = 0; b < nbBalayages; b++) {
+		const Balayage &balayage = balayages[b];
+		const Figure *figure = figureTrouver(balayage.nom);
+		if (figure == NULL || !estDemande(balayage.nom, argv + i, argc - i)) {
+			continue;
+		}
+
+		float parametres[NB_MAX_PARAMETRES];
+		memcpy(parametres, figure->parametresDefaut, sizeof(parametres));
+
+		if (figure->nbParametres == 0) {
+			mesurer(*figure, parametres, vitesseTrace, vitesseDeplacementLeve, tolerance, estimationSeule);
+			continue;
+		}
+
+		float fin = balayage.fin == 0 ? niveauMax : balayage.fin;
+		for (float valeur = balayage.debut; valeur <= fin; valeur += balayage.pas) {
+			parametres[0] = valeur;
+			if (mesurer(*figure, parametres, vitesseTrace, vitesseDeplacementLeve, tolerance, estimationSeule) > pasMax && valeur + balayage.pas <= fin) {
+				fprintf(stderr, "%s : plus de %llu pas au paramètre %g, les valeurs suivantes sont ignorées.\n", figure->nom, pasMax, valeur);
+				break;													// Le suivant serait encore plus long à simuler.
+			}
+		}
+	}
+
+	return 0;
+}
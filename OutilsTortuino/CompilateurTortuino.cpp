@@ -0,0 +1,245 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <vector>
+# include "Tortuino.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoLecteur.h"
+# include "TortuinoMesures.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+
+
+/**
+ * @file CompilateurTortuino.cpp
+ * @brief Ce programme écrit un des dessins dans un fichier lisible par dessinerFichier().
+ * @version 1.0
+ *
+ * Le programme compilateurTortuino exécute un des dessins de TortuinoDessins.h sur l'ordinateur
+ * en relevant les commandes réellement exécutées, une fois combinées par TortuinoCommandes.cpp,
+ * puis les écrit au format binaire de TortuinoLecteur.cpp. Les suites de commandes qui se
+ * répètent à l'identique, comme les côtés d'un polygone, sont écrites une seule fois dans une
+ * répétition, à condition de tenir dans un bloc de TAILLE_BLOC_FICHIER octets. Le fichier obtenu
+ * peut être copié sur la carte SD du robot :
+ *
+ * {@code
+ * 	./compilateurTortuino KOCH.TRT floconVonKoch 5 15
+ * }
+ *
+ * Le fichier est ensuite tracé sur l'ordinateur par dessinerFichier(), et les deux exécutions
+ * sont comparées sur la sortie d'erreur, avec le nombre de fois où la lecture a fait attendre
+ * le tracé. Les paramètres qui ne sont pas donnés prennent la valeur par défaut de la table de
+ * Figures.cpp.
+ */
+
+
+
+typedef std::vector<unsigned char> Code;
+
+const size_t	longueurMaxMotif	=	32;			/**< Le nombre maximal de commandes d'une répétition cherchée. */
+const long		tailleMaxMotif		=	TAILLE_BLOC_FICHIER;	/**< La taille maximale en octets d'une répétition, pour que dessinerFichier() ne relise jamais la carte. */
+
+std::vector<Code>	codes;							/**< Le code de chacune des commandes exécutées, dans l'ordre. */
+unsigned long		basculesFeutre	=	0;			/**< Le nombre de mouvements du feutre de l'exécution en cours. */
+
+
+/**
+ * Écrit un nombre positif sur un nombre variable d'octets.
+ *
+ * @param code   Le code auquel ajouter le nombre.
+ * @param nombre Le nombre à écrire.
+ */
+void ecrireNombre(Code &code, unsigned long nombre) {
+	while (nombre >= 0x80) {
+		code.push_back((nombre & 0x7F) | 0x80);
+		nombre >>= 7;
+	}
+	code.push_back(nombre);
+}
+
+/**
+ * Écrit un nombre signé, replié sur les positifs, sur un nombre variable d'octets.
+ *
+ * @param code   Le code auquel ajouter le nombre.
+ * @param valeur Le nombre décimal à écrire, arrondi à l'entier le plus proche.
+ */
+void ecrireNombreSigne(Code &code, double valeur) {
+	long entier = lround(valeur);
+	ecrireNombre(code, entier < 0 ? ((unsigned long)(-(entier + 1)) << 1) | 1 : (unsigned long)entier << 1);
+}
+
+/**
+ * L'observateur des commandes exécutées, qui les code au fil de l'eau.
+ *
+ * @param commande La commande qui va être exécutée.
+ */
+void coder(const Commande &commande) {
+	Code code;
+	switch (commande.type) {
+		case COMMANDE_AVANCER:
+			code.push_back(CODE_AVANCER);
+			ecrireNombreSigne(code, commande.valeur * UNITES_PAR_CENTIMETRE);
+			break;
+		case COMMANDE_TOURNER:
+			code.push_back(CODE_TOURNER);
+			ecrireNombreSigne(code, commande.valeur * UNITES_PAR_DEGRE);
+			break;
+		case COMMANDE_ARC:
+			code.push_back(CODE_ARC);
+			ecrireNombreSigne(code, commande.rayon * UNITES_PAR_CENTIMETRE);
+			ecrireNombreSigne(code, commande.valeur * UNITES_PAR_DEGRE);
+			break;
+		case COMMANDE_MONTER_FEUTRE:
+			code.push_back(CODE_MONTER_FEUTRE);
+			break;
+		case COMMANDE_DESCENDRE_FEUTRE:
+			code.push_back(CODE_DESCENDRE_FEUTRE);
+			break;
+	}
+	codes.push_back(code);
+}
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui compte les mouvements du feutre.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	if (evenement.type == EVENEMENT_FEUTRE) {
+		basculesFeutre++;
+	}
+}
+
+/**
+ * Compte combien de fois de suite un motif de commandes se répète à partir d'une position.
+ *
+ * @param  debut    La position du motif.
+ * @param  longueur Le nombre de commandes du motif.
+ * @return          Le nombre de répétitions, au moins 1.
+ */
+size_t compterRepetitions(size_t debut, size_t longueur) {
+	size_t nb = 1;
+	while (debut + (nb + 1) * longueur <= codes.size()) {
+		for (size_t i = 0; i < longueur; i++) {
+			if (codes[debut + i] != codes[debut + nb * longueur + i]) {
+				return nb;
+			}
+		}
+		nb++;
+	}
+
+	return nb;
+}
+
+/**
+ * Code toutes les commandes relevées, en plaçant dans une répétition chaque motif qui se
+ * répète assez pour que cela réduise la taille du fichier.
+ *
+ * @return Le contenu du fichier, en-tête et CODE_FIN compris.
+ */
+Code coderFichier() {
+	Code fichier(ENTETE_FICHIER, ENTETE_FICHIER + sizeof(ENTETE_FICHIER));
+
+	size_t i = 0;
+	while (i < codes.size()) {
+		size_t meilleureLongueur = 1, meilleurNombre = 1;
+		long meilleurGain = 0;
+
+		for (size_t longueur = 1; longueur <= longueurMaxMotif && i + 2 * longueur <= codes.size(); longueur++) {
+			size_t nombre = compterRepetitions(i, longueur);
+			long taille = 0;
+			for (size_t j = 0; j < longueur; j++) {
+				taille += codes[i + j].size();
+			}
+			if (taille > tailleMaxMotif) {
+				break;
+			}
+
+			Code entete;
+			ecrireNombre(entete, nombre);
+			long gain = (long)(nombre - 1) * taille - (long)entete.size() - 2;	// Les codes de début et de fin de la répétition.
+			if (nombre > 1 && gain > meilleurGain) {
+				meilleurGain = gain;
+				meilleureLongueur = longueur;
+				meilleurNombre = nombre;
+			}
+		}
+
+		if (meilleurNombre > 1) {
+			fichier.push_back(CODE_REPETER);
+			ecrireNombre(fichier, meilleurNombre);
+		}
+		for (size_t j = 0; j < meilleureLongueur; j++) {
+			fichier.insert(fichier.end(), codes[i + j].begin(), codes[i + j].end());
+		}
+		if (meilleurNombre > 1) {
+			fichier.push_back(CODE_FIN_REPETER);
+		}
+		i += meilleureLongueur * meilleurNombre;
+	}
+
+	fichier.push_back(CODE_FIN);
+	return fichier;
+}
+
+/**
+ * Affiche sur la sortie d'erreur le bilan d'une exécution.
+ *
+ * @param nom   Le nom de l'exécution.
+ * @param debut L'instant de son début selon hoteInstant().
+ */
+void afficherBilan(const char *nom, uint64_t debut) {
+	fprintf(stderr, "%-10s %10.2f cm levé %10.2f cm baissé %8lu mouvements du feutre %10.2f s %6lu lectures bloquantes\n", nom,
+		mesures.distanceLevee, mesures.distanceBaissee, basculesFeutre, (double)(hoteInstant() - debut) / FREQUENCE_MOTEURS,
+		mesures.lecturesBloquantes);
+}
+
+/**
+ * Remet à zéro les mesures avant une exécution.
+ *
+ * @return L'instant du début de l'exécution.
+ */
+uint64_t demarrer() {
+	initialiser();
+	mesuresEffacer();
+	basculesFeutre = 0;
+	return hoteInstant();
+}
+
+int main(int argc, char **argv) {
+	const Figure *figure = argc > 2 ? figureTrouver(argv[2]) : NULL;
+	if (figure == NULL) {
+		fprintf(stderr, "Usage : %s fichier dessin [paramètres...]\n", argv[0]);
+		return 1;
+	}
+
+	float parametres[NB_MAX_PARAMETRES];
+	for (int i = 0; i < NB_MAX_PARAMETRES; i++) {
+		parametres[i] = i + 3 < argc ? atof(argv[i + 3]) : figure->parametresDefaut[i];
+	}
+
+	hoteEnregistrer(false);
+	hoteObserver(observer);
+
+	uint64_t debut = demarrer();										// Exécution et relevé du dessin original.
+	mesures.observateur = coder;
+	figure->tracer(parametres);
+	terminer();
+	mesures.observateur = NULL;
+	afficherBilan("original", debut);
+
+	Code fichier = coderFichier();
+	FILE *sortie = fopen(argv[1], "wb");
+	if (sortie == NULL || fwrite(&fichier[0], 1, fichier.size(), sortie) != fichier.size() || fclose(sortie) != 0) {
+		fprintf(stderr, "Impossible d'écrire %s.\n", argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%lu commandes écrites en %lu octets\n", (unsigned long)codes.size(), (unsigned long)fichier.size());
+
+	debut = demarrer();													// Tracé du fichier écrit.
+	bool valide = dessinerFichier(argv[1]);
+	afficherBilan("fichier", debut);
+
+	return valide ? 0 : 1;
+}
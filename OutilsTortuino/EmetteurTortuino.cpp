@@ -0,0 +1,383 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <fcntl.h>
+# include <termios.h>
+# include <unistd.h>
+# include <vector>
+# include "Tortuino.h"
+# include "TortuinoLiaison.h"
+# include "TortuinoMesures.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+
+
+/**
+ * @file EmetteurTortuino.cpp
+ * @brief Ce programme planifie un dessin en blocs de pas et les envoie à TortuinoLiaison.cpp.
+ * @version 1.0
+ *
+ * Le programme emetteurTortuino exécute un des dessins de TortuinoDessins.h sur l'ordinateur,
+ * découpe la suite de pas obtenue en blocs de fenetreBloc interruptions au plus, puis les envoie
+ * selon le protocole de TortuinoLiaison.cpp en respectant les crédits accordés par le robot.
+ * Lorsque le robot rejette une trame, l'envoi reprend au bloc qu'il attend.
+ * Avec l'option -p, les blocs partent sur la liaison série d'une vraie carte dont le croquis
+ * appelle liaisonServir() après initialiser() :
+ *
+ * {@code
+ * 	./emetteurTortuino -p /dev/ttyACM0 floconVonKoch 5 15
+ * }
+ *
+ * Sans cette option, le robot est simulé dans le même programme, derrière la liaison série en
+ * mémoire de MaterielHote.cpp, et les deux exécutions du dessin, directe puis par la liaison,
+ * sont comparées sur la sortie d'erreur avec le nombre de fois où les moteurs ont manqué de
+ * blocs. Les paramètres qui ne sont pas donnés prennent la valeur par défaut de la table de
+ * Figures.cpp.
+ */
+
+
+
+const uint64_t	fenetreBloc			=	100;		/**< La durée maximale d'un bloc en interruptions du Timer2, soit 20 ms. */
+const int		intervalleMin		=	1000000 / FREQUENCE_MOTEURS;	/**< Le plus petit intervalle entre deux pas, en microsecondes. */
+
+/**
+ * Un bloc de pas planifié, avant son envoi.
+ */
+struct Bloc {
+	int pasGauche;														/**< Le nombre de pas signé de la roue gauche. */
+	int pasDroite;														/**< Le nombre de pas signé de la roue droite. */
+	unsigned int intervalle;											/**< L'intervalle en microsecondes entre deux pas de la roue qui en a le plus. */
+	bool feutreLeve;													/**< La position du feutre pendant le bloc. */
+};
+
+/**
+ * L'état de l'envoi des blocs au robot.
+ */
+struct Envoi {
+	size_t prochain;													/**< L'indice du prochain bloc à envoyer. */
+	int credits;														/**< Le nombre de blocs que le robot peut encore recevoir. */
+	bool attendCredits;													/**< Vrai si le prochain octet reçu est un nombre de crédits. */
+	bool attendRejet;													/**< Vrai si le prochain octet reçu est le numéro du bloc que le robot attend. */
+	bool finEnvoyee;													/**< Vrai une fois la TRAME_FIN envoyée. */
+	bool fini;															/**< Vrai une fois la REPONSE_FINI reçue. */
+	unsigned long renvois;												/**< Le nombre de blocs envoyés de nouveau après un rejet. */
+};
+
+/**
+ * Ce que l'observateur compte au fil des événements d'une exécution.
+ */
+struct Compteurs {
+	unsigned long long pasGauche;										/**< Le nombre de pas de la roue gauche. */
+	unsigned long long pasDroite;										/**< Le nombre de pas de la roue droite. */
+	unsigned long basculesFeutre;										/**< Le nombre de mouvements du feutre. */
+};
+
+Compteurs		compteurs;						/**< Les compteurs de l'exécution en cours. */
+int				port			=	-1;			/**< Le descripteur de la liaison série de la carte, ou -1 pour le robot simulé. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui met à jour les compteurs.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	switch (evenement.type) {
+		case EVENEMENT_PAS_GAUCHE:
+			compteurs.pasGauche++;
+			break;
+		case EVENEMENT_PAS_DROITE:
+			compteurs.pasDroite++;
+			break;
+		case EVENEMENT_FEUTRE:
+			compteurs.basculesFeutre++;
+			break;
+	}
+}
+
+/**
+ * Termine un bloc et l'ajoute à la liste s'il contient des pas.
+ *
+ * @param blocs La liste des blocs.
+ * @param bloc  Le bloc en cours, remis à zéro ensuite.
+ * @param debut L'instant du début du bloc.
+ * @param fin   L'instant de la fin du bloc.
+ */
+void fermerBloc(std::vector<Bloc> &blocs, Bloc &bloc, uint64_t debut, uint64_t fin) {
+	int pasMax = abs(bloc.pasGauche) > abs(bloc.pasDroite) ? abs(bloc.pasGauche) : abs(bloc.pasDroite);
+	if (pasMax > 0) {
+		unsigned long intervalle = (fin - debut) * 1000000 / FREQUENCE_MOTEURS / pasMax;
+		bloc.intervalle = intervalle < (unsigned long)intervalleMin ? intervalleMin : intervalle > 65535 ? 65535 : intervalle;
+		blocs.push_back(bloc);
+	}
+
+	bloc.pasGauche = 0;
+	bloc.pasDroite = 0;
+}
+
+/**
+ * Découpe une suite d'événements en blocs de pas. Un bloc se termine à la fin de sa fenêtre,
+ * lorsqu'une roue change de sens ou lorsque le feutre bouge ; sa durée donne son intervalle, si
+ * bien que les rampes d'accélération se retrouvent dans la cadence des blocs successifs.
+ *
+ * @param  evenements Les événements enregistrés par MaterielHote.cpp.
+ * @param  feutreLeve La position du feutre avant le premier événement.
+ * @return            Les blocs, dans l'ordre.
+ */
+std::vector<Bloc> planifier(const std::vector<Evenement> &evenements, bool feutreLeve) {
+	std::vector<Bloc> blocs;
+	Bloc bloc = {0, 0, 0, feutreLeve};
+	uint64_t debut = evenements.empty() ? 0 : evenements[0].instant;
+
+	for (size_t i = 0; i < evenements.size(); i++) {
+		const Evenement &evenement = evenements[i];
+
+		if (evenement.type == EVENEMENT_FEUTRE) {						// Le feutre ne bouge qu'entre deux blocs.
+			fermerBloc(blocs, bloc, debut, evenement.instant);
+			bloc.feutreLeve = evenement.valeur != 0;
+			debut = evenement.instant;
+			continue;
+		}
+
+		int &pas = evenement.type == EVENEMENT_PAS_GAUCHE ? bloc.pasGauche : bloc.pasDroite;
+		if (evenement.instant >= debut + fenetreBloc) {					// Fin de la fenêtre,
+			fermerBloc(blocs, bloc, debut, debut + fenetreBloc);
+			debut = evenement.instant >= debut + 2 * fenetreBloc ? evenement.instant - 1 : debut + fenetreBloc;	// sans compter les arrêts.
+		}
+		else if (pas != 0 && (pas > 0) != (evenement.valeur > 0)) {		// ou changement de sens.
+			fermerBloc(blocs, bloc, debut, evenement.instant - 1);
+			debut = evenement.instant - 1;
+		}
+		pas += evenement.valeur;
+	}
+	fermerBloc(blocs, bloc, debut, debut + fenetreBloc);
+
+	if (blocs.empty() || blocs.back().feutreLeve != bloc.feutreLeve) {	// Un bloc vide emporte la dernière position du feutre.
+		bloc.intervalle = intervalleMin;
+		blocs.push_back(bloc);
+	}
+
+	return blocs;
+}
+
+/**
+ * Envoie un octet au robot, simulé ou réel.
+ *
+ * @param octet L'octet à envoyer.
+ */
+void envoyer(unsigned char octet) {
+	if (port < 0) {
+		hoteSerieEnvoyer(octet);
+	}
+	else if (write(port, &octet, 1) != 1) {
+		perror("write");
+	}
+}
+
+/**
+ * Lit un octet envoyé par le robot, simulé ou réel, sans attendre.
+ *
+ * @return L'octet reçu, ou -1 si aucun n'attend.
+ */
+int recevoir() {
+	if (port < 0) {
+		return hoteSerieRecevoir();
+	}
+
+	unsigned char octet;
+	return read(port, &octet, 1) == 1 ? octet : -1;
+}
+
+/**
+ * Envoie un bloc sous forme de TRAME_BLOC.
+ *
+ * @param bloc   Le bloc à envoyer.
+ * @param numero Son indice dans la liste des blocs.
+ */
+void envoyerBloc(const Bloc &bloc, size_t numero) {
+	unsigned char trame[TAILLE_TRAME_BLOC] = {
+		TRAME_BLOC, (unsigned char)(numero & 0xFF),
+		(unsigned char)(bloc.pasGauche & 0xFF), (unsigned char)((bloc.pasGauche >> 8) & 0xFF),
+		(unsigned char)(bloc.pasDroite & 0xFF), (unsigned char)((bloc.pasDroite >> 8) & 0xFF),
+		(unsigned char)(bloc.intervalle & 0xFF), (unsigned char)((bloc.intervalle >> 8) & 0xFF),
+		(unsigned char)(bloc.feutreLeve ? DRAPEAU_FEUTRE_LEVE : 0), 0
+	};
+	for (int i = 1; i < TAILLE_TRAME_BLOC - 1; i++) {
+		trame[TAILLE_TRAME_BLOC - 1] += trame[i];
+	}
+	for (int i = 0; i < TAILLE_TRAME_BLOC; i++) {
+		envoyer(trame[i]);
+	}
+}
+
+/**
+ * Reprend l'envoi au bloc que le robot attend après avoir rejeté une trame : ce bloc et ceux
+ * qui l'ont suivi sont envoyés de nouveau, puis la TRAME_FIN. Le robot n'ayant rangé aucun
+ * d'eux, leurs crédits sont récupérés.
+ *
+ * @param envoi  L'état de l'envoi.
+ * @param numero Le numéro modulo 256 du bloc attendu.
+ */
+void reprendre(Envoi &envoi, unsigned char numero) {
+	size_t recul = (unsigned char)(envoi.prochain - numero);			// Le robot ne peut attendre qu'un bloc déjà envoyé,
+	if (recul > envoi.prochain) {										// ou le suivant.
+		return;
+	}
+
+	envoi.prochain -= recul;
+	envoi.credits += recul;
+	envoi.renvois += recul;
+	envoi.finEnvoyee = false;
+}
+
+/**
+ * Traite les réponses du robot puis envoie autant de blocs que ses crédits le permettent, et la
+ * TRAME_FIN après le dernier.
+ *
+ * @param envoi L'état de l'envoi.
+ * @param blocs Les blocs à envoyer.
+ */
+void pomper(Envoi &envoi, const std::vector<Bloc> &blocs) {
+	int octet;
+	while ((octet = recevoir()) >= 0) {
+		if (envoi.attendCredits) {
+			envoi.credits += octet;
+			envoi.attendCredits = false;
+		}
+		else if (envoi.attendRejet) {
+			reprendre(envoi, octet);
+			envoi.attendRejet = false;
+		}
+		else if (octet == REPONSE_CREDITS) {
+			envoi.attendCredits = true;
+		}
+		else if (octet == REPONSE_ERREUR) {
+			envoi.attendRejet = true;
+		}
+		else if (octet == REPONSE_FINI) {
+			envoi.fini = true;
+		}
+	}
+
+	while (envoi.credits > 0 && envoi.prochain < blocs.size()) {
+		envoyerBloc(blocs[envoi.prochain], envoi.prochain);
+		envoi.prochain++;
+		envoi.credits--;
+	}
+	if (envoi.prochain == blocs.size() && !envoi.finEnvoyee) {
+		envoyer(TRAME_FIN);
+		envoyer((unsigned char)(blocs.size() & 0xFF));
+		envoi.finEnvoyee = true;
+	}
+}
+
+/**
+ * Ouvre la liaison série d'une carte au débit DEBIT_LIAISON, sans attente à la lecture.
+ *
+ * @param  chemin Le chemin du port, comme /dev/ttyACM0.
+ * @return        Vrai si le port a pu être ouvert et configuré.
+ */
+bool ouvrirPort(const char *chemin) {
+	port = open(chemin, O_RDWR | O_NOCTTY);
+	if (port < 0) {
+		return false;
+	}
+
+	struct termios options;
+	if (tcgetattr(port, &options) != 0) {
+		return false;
+	}
+	cfmakeraw(&options);
+	cfsetispeed(&options, B115200);
+	cfsetospeed(&options, B115200);
+	options.c_cc[VMIN] = 0;												// Lecture sans attente.
+	options.c_cc[VTIME] = 0;
+	if (tcsetattr(port, TCSANOW, &options) != 0) {
+		return false;
+	}
+
+	sleep(2);															// L'ouverture du port redémarre la carte.
+	tcflush(port, TCIOFLUSH);
+	return true;
+}
+
+/**
+ * Affiche sur la sortie d'erreur le bilan d'une exécution.
+ *
+ * @param nom   Le nom de l'exécution.
+ * @param debut L'instant de son début selon hoteInstant().
+ */
+void afficherBilan(const char *nom, uint64_t debut) {
+	fprintf(stderr, "%-10s %10llu pas gauche %10llu pas droite %8lu mouvements du feutre %10.2f s %6lu famines\n", nom,
+		compteurs.pasGauche, compteurs.pasDroite, compteurs.basculesFeutre,
+		(double)(hoteInstant() - debut) / FREQUENCE_MOTEURS, mesures.famines);
+}
+
+int main(int argc, char **argv) {
+	const char *chemin = NULL;
+	int i = 1;
+	if (i + 1 < argc && strcmp(argv[i], "-p") == 0) {
+		chemin = argv[i + 1];
+		i += 2;
+	}
+
+	const Figure *figure = i < argc ? figureTrouver(argv[i]) : NULL;
+	if (figure == NULL) {
+		fprintf(stderr, "Usage : %s [-p port] dessin [paramètres...]\n", argv[0]);
+		return 1;
+	}
+
+	float parametres[NB_MAX_PARAMETRES];
+	for (int j = 0; j < NB_MAX_PARAMETRES; j++) {
+		parametres[j] = i + 1 + j < argc ? atof(argv[i + 1 + j]) : figure->parametresDefaut[j];
+	}
+
+	hoteObserver(observer);
+	initialiser();														// Exécution directe du dessin, dont on garde les pas.
+	hoteEnregistrer(true);
+	hoteEffacer();
+	mesuresEffacer();
+	memset(&compteurs, 0, sizeof(compteurs));
+	uint64_t debut = hoteInstant();
+	figure->tracer(parametres);
+	terminer();
+	afficherBilan("direct", debut);
+
+	std::vector<Bloc> blocs = planifier(hoteEvenements(), false);		// initialiser() laisse le feutre baissé.
+	hoteEnregistrer(false);
+	hoteEffacer();
+	fprintf(stderr, "%lu blocs de %d octets\n", (unsigned long)blocs.size(), TAILLE_TRAME_BLOC);
+
+	Envoi envoi = {0, 0, false, false, false, false, 0};
+	if (chemin != NULL) {												// Envoi à une vraie carte.
+		if (!ouvrirPort(chemin)) {
+			perror(chemin);
+			return 1;
+		}
+		envoyer(TRAME_BONJOUR);
+		while (!envoi.fini) {
+			pomper(envoi, blocs);
+			usleep(1000);
+		}
+		close(port);
+	}
+	else {																// Envoi au robot simulé.
+		initialiser();
+		mesuresEffacer();
+		memset(&compteurs, 0, sizeof(compteurs));
+		debut = hoteInstant();
+		liaisonDemarrer();
+		envoyer(TRAME_BONJOUR);
+		do {
+			pomper(envoi, blocs);
+			materielPatienter();
+		} while (liaisonActualiser());
+		pomper(envoi, blocs);
+		afficherBilan("liaison", debut);
+	}
+
+	if (envoi.renvois > 0) {
+		fprintf(stderr, "%lu blocs renvoyés après un rejet\n", envoi.renvois);
+	}
+	return envoi.fini ? 0 : 1;
+}
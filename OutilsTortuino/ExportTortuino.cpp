@@ -0,0 +1,127 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include "Tortuino.h"
+# include "TortuinoFeutre.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Rendu.h"
+
+
+/**
+ * @file ExportTortuino.cpp
+ * @brief Ce programme dessine ce que le robot aurait tracé, en SVG et en PNG.
+ * @version 1.0
+ *
+ * Le programme exportTortuino reconstruit grâce à Rendu.cpp les traits tracés feutre baissé, à
+ * partir des pas des moteurs et de la géométrie du robot, puis les écrit dans une image. Les pas
+ * viennent soit de l'exécution d'un des dessins de TortuinoDessins.h sur l'ordinateur, soit d'une
+ * trace enregistrée par traceTortuino :
+ *
+ * {@code
+ * 	./exportTortuino -s flocon.svg -p flocon.png floconVonKoch 3 12
+ * 	./traceTortuino floconVonKoch 3 12 > flocon.txt
+ * 	./exportTortuino -s flocon.svg -t flocon.txt
+ * }
+ *
+ * Les options sont `-s` pour le fichier SVG, `-p` pour le fichier PNG et `-r` pour la résolution
+ * de celui-ci, en pixels par centimètre, vingt par défaut. Sans fichier demandé, le SVG est écrit
+ * sur la sortie standard. Les paramètres qui ne sont pas donnés prennent la valeur par défaut de
+ * la table de Figures.cpp.
+ */
+
+
+
+/**
+ * Suit une trace écrite par traceTortuino, ligne par ligne.
+ *
+ * @param  nom Le chemin du fichier de la trace.
+ * @return     Vrai si la trace a pu être lue en entier.
+ */
+bool suivreTrace(const char *nom) {
+	FILE *fichier = fopen(nom, "r");
+	if (fichier == NULL) {
+		return false;
+	}
+
+	unsigned long long instant;
+	char lettre;
+	int valeur;
+	renduDemarrer(false);												// Le robot démarre feutre baissé, comme après initialiser().
+	while (fscanf(fichier, "%llu %c %d", &instant, &lettre, &valeur) == 3) {
+		Evenement evenement;
+		evenement.instant = instant;
+		evenement.type = lettre == 'G' ? EVENEMENT_PAS_GAUCHE : lettre == 'D' ? EVENEMENT_PAS_DROITE : EVENEMENT_FEUTRE;
+		evenement.valeur = valeur;
+		renduEvenement(evenement);
+	}
+
+	bool fin = feof(fichier);
+	fclose(fichier);
+	return fin;
+}
+
+int main(int argc, char **argv) {
+	const char *svg = NULL, *png = NULL, *trace = NULL;
+	double resolution = 20;
+	int i = 1;
+
+	for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {					// Lecture des options.
+		if (strcmp(argv[i], "-s") == 0) {
+			svg = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-p") == 0) {
+			png = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-r") == 0) {
+			resolution = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-t") == 0) {
+			trace = argv[i + 1];
+		}
+		else {
+			break;
+		}
+	}
+
+	const Figure *figure = i < argc ? figureTrouver(argv[i]) : NULL;
+	if ((trace == NULL) == (figure == NULL)) {
+		fprintf(stderr, "Usage : %s [-s fichier.svg] [-p fichier.png] [-r pixelsParCentimetre] (dessin [paramètres...] | -t trace.txt)\n", argv[0]);
+		return 1;
+	}
+
+	if (trace != NULL) {
+		if (!suivreTrace(trace)) {
+			fprintf(stderr, "Impossible de lire la trace %s.\n", trace);
+			return 1;
+		}
+	}
+	else {
+		float parametres[NB_MAX_PARAMETRES];
+		for (int j = 0; j < NB_MAX_PARAMETRES; j++) {					// Les paramètres donnés remplacent ceux par défaut.
+			parametres[j] = i + j + 1 < argc ? atof(argv[i + j + 1]) : figure->parametresDefaut[j];
+		}
+
+		hoteEnregistrer(false);											// Les pas sont suivis au fil de l'eau, pas enregistrés.
+		initialiser();
+		renduDemarrer(feutreEstLeve());
+		hoteObserver(renduEvenement);
+		figure->tracer(parametres);
+		terminer();
+	}
+
+	const std::vector<Trait> &traits = renduTraits();
+	if (svg == NULL && png == NULL) {
+		svg = "-";
+	}
+	if (svg != NULL && !renduEcrireSvg(svg, traits)) {
+		fprintf(stderr, "Impossible d'écrire %s.\n", svg);
+		return 1;
+	}
+	if (png != NULL && !renduEcrirePng(png, traits, resolution)) {
+		fprintf(stderr, "Impossible d'écrire %s.\n", png);
+		return 1;
+	}
+
+	return 0;
+}
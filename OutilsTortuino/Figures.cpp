@@ -0,0 +1,124 @@
+# include <string.h>
+# include "Figures.h"
+# include "TortuinoDessins.h"
+# include "TortuinoCourbes.h"
+# include "TortuinoHachures.h"
+
+
+/**
+ * @file Figures.cpp
+ * @brief Ce fichier rassemble les dessins de TortuinoDessins.cpp dans une table utilisable par les outils.
+ * @version 1.0
+ *
+ * Le fichier Figures.cpp associe à chaque dessin de TortuinoDessins.h son nom, son nombre de
+ * paramètres et des valeurs par défaut raisonnables pour ceux-ci. Les outils du dossier
+ * OutilsTortuino peuvent ainsi lancer n'importe quel dessin à partir de son nom, donné par
+ * exemple sur la ligne de commande. Les paramètres sont tous passés sous forme de `float`,
+ * les nombres de niveaux ou de côtés étant arrondis à l'entier inférieur. Les courbes de
+ * TortuinoCourbes.h et le remplissage de TortuinoHachures.h, qui ne sont pas des dessins, y
+ * figurent aussi sur une forme fixe dont seule la taille change, pour être vérifiés et mesurés
+ * comme eux.<br/>
+ *
+ * Une seconde table donne le balayage de chaque dessin, c'est-à-dire les valeurs que prend son
+ * premier paramètre lorsqu'un outil les essaie toutes, les autres gardant leur valeur par défaut :
+ * de la valeur de début à celle de fin, par pas donné. Une fin nulle signifie qu'il faut aller
+ * jusqu'au niveau maximal choisi par l'outil.
+ *
+ * @see figureTrouver(const char *nom)
+ */
+
+
+
+/**
+ * Les fonctions d'adaptation suivantes appellent chacune un dessin avec les paramètres donnés.
+ */
+void tracerTriangle(const float *p)				{ triangle(p[0]); }
+void tracerCarre(const float *p)				{ carre(p[0]); }
+void tracerPolygoneRegulier(const float *p)		{ polygoneRegulier((int)p[0], p[1]); }
+void tracerCercle(const float *p)				{ cercle(p[0]); }
+void tracerBezier(const float *p)				{ bezier(0, p[0], p[0], p[0], p[0], 0); }
+void tracerCatmullRom(const float *p) {
+	const float points[4][2] = {{p[0] / 2, p[0] / 2}, {p[0], 0}, {1.5f * p[0], p[0] / 2}, {2 * p[0], 0}};
+	catmullRom(points, 4);
+}
+void tracerHachurer(const float *p) {
+	const float cadre[8][2] = {{0, 0}, {p[0], 0}, {p[0], p[0]}, {0, p[0]},
+		{0.3f * p[0], 0.3f * p[0]}, {0.7f * p[0], 0.3f * p[0]}, {0.7f * p[0], 0.7f * p[0]}, {0.3f * p[0], 0.7f * p[0]}};
+	const int nbSommets[2] = {4, 4};
+	hachurer(cadre, nbSommets, 2, 0.5, 45);
+}
+void tracerArbre(const float *p)				{ arbre((int)p[0], p[1]); }
+void tracerArbreSymetrique(const float *p)		{ arbreSymetrique((int)p[0], p[1], p[2]); }
+void tracerArbreAsymetrique(const float *p)		{ arbreAsymetrique((int)p[0], p[1], p[2], p[3]); }
+void tracerSapin(const float *p)				{ sapin((int)p[0], p[1]); }
+void tracerCourbeVonKoch(const float *p)		{ courbeVonKoch((int)p[0], p[1]); }
+void tracerFloconVonKoch(const float *p)		{ floconVonKoch((int)p[0], p[1]); }
+void tracerTriangleSierpinski(const float *p)	{ triangleSierpinski((int)p[0], p[1]); }
+void tracerMaison(const float *p)				{ maison(); }
+void tracerSpiraleCarree(const float *p)		{ spiraleCarree((int)p[0], p[1], p[2]); }
+void tracerTangram(const float *p)				{ tangram(); }
+void tracerFlocon(const float *p)				{ flocon(); }
+
+const Figure figures[] = {						/**< La table de tous les dessins de TortuinoDessins.h. */
+	{"triangle",			1,	tracerTriangle,				{10}},
+	{"carre",				1,	tracerCarre,				{10}},
+	{"polygoneRegulier",	2,	tracerPolygoneRegulier,		{6, 5}},
+	{"cercle",				1,	tracerCercle,				{5}},
+	{"bezier",				1,	tracerBezier,				{10}},
+	{"catmullRom",			1,	tracerCatmullRom,			{10}},
+	{"hachurer",			1,	tracerHachurer,				{10}},
+	{"arbre",				2,	tracerArbre,				{5, 10}},
+	{"arbreSymetrique",		3,	tracerArbreSymetrique,		{5, 10, 60}},
+	{"arbreAsymetrique",	4,	tracerArbreAsymetrique,		{5, 10, 60, 10}},
+	{"sapin",				2,	tracerSapin,				{5, 10}},
+	{"courbeVonKoch",		2,	tracerCourbeVonKoch,		{4, 20}},
+	{"floconVonKoch",		2,	tracerFloconVonKoch,		{4, 15}},
+	{"triangleSierpinski",	2,	tracerTriangleSierpinski,	{4, 20}},
+	{"maison",				0,	tracerMaison,				{}},
+	{"spiraleCarree",		3,	tracerSpiraleCarree,		{20, 1, 1}},
+	{"tangram",				0,	tracerTangram,				{}},
+	{"flocon",				0,	tracerFlocon,				{}}
+};
+
+const int nbFigures = sizeof(figures) / sizeof(figures[0]);	/**< Le nombre de dessins de la table. */
+
+const Balayage balayages[] = {					/**< Les balayages de tous les dessins de la table. */
+	{"triangle",			5,	20,	5},
+	{"carre",				5,	20,	5},
+	{"polygoneRegulier",	3,	12,	1},
+	{"cercle",				1,	10,	3},
+	{"bezier",				5,	20,	5},
+	{"catmullRom",			5,	20,	5},
+	{"hachurer",			5,	20,	5},
+	{"arbre",				1,	0,	1},
+	{"arbreSymetrique",		1,	0,	1},
+	{"arbreAsymetrique",	1,	0,	1},
+	{"sapin",				1,	0,	1},
+	{"courbeVonKoch",		1,	0,	1},
+	{"floconVonKoch",		1,	0,	1},
+	{"triangleSierpinski",	1,	0,	1},
+	{"maison",				0,	0,	1},
+	{"spiraleCarree",		5,	40,	5},
+	{"tangram",				0,	0,	1},
+	{"flocon",				0,	0,	1}
+};
+
+const int nbBalayages = sizeof(balayages) / sizeof(balayages[0]);	/**< Le nombre de balayages de la table. */
+
+
+/**
+ * Cherche un dessin dans la table à partir de son nom.
+ *
+ * @param  nom Le nom du dessin, identique à celui de sa fonction dans TortuinoDessins.h,
+ * 				TortuinoCourbes.h ou TortuinoHachures.h.
+ * @return     L'entrée de la table correspondante, ou `NULL` si aucun dessin ne porte ce nom.
+ */
+const Figure *figureTrouver(const char *nom) {
+	for (int i = 0; i < nbFigures; i++) {
+		if (strcmp(figures[i].nom, nom) == 0) {
+			return &figures[i];
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file Figures.h
+ * @brief Définition de la table des dessins implémentée dans Figures.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de Figures.cpp. Il permet de préciser ce
+ * qui sera rendu accessible aux outils. Ici, ce sont une fonction et les types
+ * des entrées des tables.
+ */
+
+
+# ifndef TORTUINO_FIGURES_h
+#	define TORTUINO_FIGURES_h
+
+	const int	NB_MAX_PARAMETRES	=	4;
+
+	struct Figure {
+		const char *nom;
+		int nbParametres;
+		void (*tracer)(const float *parametres);
+		float parametresDefaut[NB_MAX_PARAMETRES];
+	};
+
+	struct Balayage {
+		const char *nom;
+		float debut;
+		float fin;
+		float pas;
+	};
+
+	extern const Figure		figures[];
+	extern const int		nbFigures;
+	extern const Balayage	balayages[];
+	extern const int		nbBalayages;
+
+	const Figure *figureTrouver(const char *nom);
+
+# endif
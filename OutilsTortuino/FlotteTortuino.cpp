@@ -0,0 +1,701 @@
+# include <math.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <algorithm>
+# include <string>
+# include <vector>
+# include "Tortuino.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoEstimation.h"
+# include "TortuinoFeutre.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Parcours.h"
+# include "Rendu.h"
+
+
+/**
+ * @file FlotteTortuino.cpp
+ * @brief Ce programme partage un grand dessin entre plusieurs robots qui le tracent ensemble.
+ * @version 1.0
+ *
+ * Le programme flotteTortuino exécute un des dessins de TortuinoDessins.h sur l'ordinateur en
+ * capturant ses traits grâce à Parcours.cpp, puis les répartit entre plusieurs robots posés côte
+ * à côte sur la même feuille, chacun identifié par sa couleur comme pour
+ * initialiser(char couleur) :
+ *
+ * {@code
+ * 	./flotteTortuino -f wjb -o sierpinski triangleSierpinski 6 80
+ * }
+ *
+ * Le dessin est découpé en bandes parallèles à son plus petit côté, une par robot, et les traits
+ * qui passent d'une bande à l'autre sont coupés à la frontière. La largeur des bandes équilibre
+ * les durées : chaque robot est estimé par TortuinoEstimation.cpp avec son propre profil, puis
+ * la part de chacun est corrigée selon la vitesse à laquelle il a avancé, jusqu'à ce que la durée
+ * du plus lent ne baisse plus.<br/>
+ *
+ * Pour que les robots ne se rencontrent pas, chacun balaie sa bande dans le même sens : elle est
+ * découpée en tranches de la taille d'un robot, tracées l'une après l'autre, les traits de chaque
+ * tranche étant ordonnés par parcoursOrdonner(). Les durées étant équilibrées, les robots avancent
+ * de front, à une bande les uns des autres. Cela est ensuite vérifié : chaque robot est simulé avec
+ * son profil, sa position est suivie au fil du temps grâce à Rendu.cpp, et si deux robots passent
+ * à moins de deux fois le rayon d'encombrement l'un de l'autre, celui qui le suit dans le sens du
+ * balayage est retardé au départ, jusqu'à ce que plus aucune rencontre n'ait lieu. Deux
+ * comparaisons terminent la vérification : les morceaux confiés aux robots doivent couvrir
+ * exactement les traits capturés, et ce que chaque robot simulé a tracé doit s'écarter de ses
+ * morceaux d'au plus ce dont le dessin d'un robot seul s'écarte de ses propres traits, ces écarts
+ * venant de l'arrondi des pas. Les durées des deux façons de faire sont enfin affichées.<br/>
+ *
+ * Les options sont `-f` pour les couleurs des robots, "wjb" par défaut, `-c` pour le rayon
+ * d'encombrement d'un robot, huit centimètres par défaut, et `-o` pour écrire le programme de
+ * chaque robot dans un fichier préfixe-couleur.ino ; sans elle, les programmes sont écrits sur la
+ * sortie standard. Chacun indique où poser le robot, et peut être collé tel quel dans la fonction
+ * `setup()` d'un croquis. Aucune bande, sauf la dernière, n'est plus étroite que trois rayons
+ * d'encombrement : deux robots voisins, chacun dans la même tranche de sa bande, restent ainsi à
+ * deux rayons l'un de l'autre. S'il y a plus de robots que de telles bandes dans le dessin, les
+ * derniers n'ont rien à tracer, et aucun programme ne leur est écrit. Le bilan est écrit sur la
+ * sortie d'erreur, et le programme se termine en erreur si les robots ne peuvent pas éviter de se
+ * rencontrer ou si le dessin partagé diffère de l'original.
+ */
+
+
+
+const int		nbMaxEquilibrages	=	8;			/**< Le nombre maximal de corrections des parts de chaque robot. */
+const double	intervalleSuivi		=	0.02;		/**< L'intervalle en secondes entre deux positions suivies d'un robot simulé. */
+const double	pasRetard			=	1.0;		/**< Le retard en secondes ajouté à un robot à chaque rencontre. */
+const double	toleranceDessin		=	0.01;		/**< L'écart maximal en centimètres entre les morceaux des robots et les traits capturés. */
+const double	toleranceTrace		=	0.05;		/**< L'écart en centimètres toujours accepté entre ce qu'un robot trace et ses morceaux. */
+const double	ecartMaxMesure		=	5;			/**< L'écart au-delà duquel renduEcart() n'est plus mesuré précisément. */
+const double	longueurNegligeable	=	0.01;		/**< En dessous de cette longueur en centimètres, un morceau de trait est ignoré. */
+
+/**
+ * Une position d'un robot simulé, datée depuis son départ.
+ */
+struct Echantillon {
+	double instant;
+	Point position;
+};
+
+/**
+ * Un robot de la flotte, sa bande du dessin et son programme.
+ */
+struct Robot {
+	char couleur;
+	double part;
+	double debut;
+	double fin;
+	Point depart;
+	std::vector<Trait> traits;
+	std::vector<Commande> commandes;
+	double dureeEstimee;
+	double duree;
+	double retard;
+	std::vector<Echantillon> suivi;
+	std::vector<Trait> traces;
+};
+
+bool		vertical		=	false;				/**< Vrai si les bandes sont découpées selon l'axe des y plutôt que celui des x. */
+const std::vector<Commande>	*commandesEstimees	=	NULL;	/**< Les commandes estimées par executerEstimees(). */
+Robot		*robotSuivi		=	NULL;				/**< Le robot en cours de simulation. */
+uint64_t	debutSuivi		=	0;					/**< L'instant de son départ selon hoteInstant(). */
+uint64_t	prochainSuivi	=	0;					/**< L'instant à partir duquel relever sa prochaine position. */
+
+
+/**
+ * Donne la coordonnée d'un point selon l'axe de découpe des bandes.
+ *
+ * @param  p Le point.
+ * @return   Son abscisse, ou son ordonnée si les bandes sont découpées selon les y.
+ */
+double le(const Point &p) {
+	return vertical ? p.y : p.x;
+}
+
+/**
+ * Donne la coordonnée d'un point selon l'autre axe, celui le long duquel s'étendent les bandes.
+ *
+ * @param  p Le point.
+ * @return   Son ordonnée, ou son abscisse si les bandes sont découpées selon les y.
+ */
+double travers(const Point &p) {
+	return vertical ? p.x : p.y;
+}
+
+/**
+ * Calcule la longueur d'un trait.
+ *
+ * @param  trait Le trait.
+ * @return       Sa longueur en centimètres.
+ */
+double longueur(const Trait &trait) {
+	double total = 0;
+	for (size_t i = 1; i < trait.size(); i++) {
+		total += hypot(trait[i].x - trait[i - 1].x, trait[i].y - trait[i - 1].y);
+	}
+
+	return total;
+}
+
+/**
+ * Calcule la longueur des traits qui se trouve en deçà d'une coordonnée selon l'axe de découpe.
+ *
+ * @param  traits Les traits.
+ * @param  limite La coordonnée.
+ * @return        La longueur en centimètres.
+ */
+double longueurAvant(const std::vector<Trait> &traits, double limite) {
+	double total = 0;
+	for (size_t t = 0; t < traits.size(); t++) {
+		for (size_t i = 1; i < traits[t].size(); i++) {
+			const Point &a = traits[t][i - 1], &b = traits[t][i];
+			double la = le(a), lb = le(b), segment = hypot(b.x - a.x, b.y - a.y);
+			if (fmax(la, lb) <= limite) {
+				total += segment;
+			}
+			else if (fmin(la, lb) < limite) {							// Le segment traverse la limite.
+				total += segment * (limite - fmin(la, lb)) / fabs(lb - la);
+			}
+		}
+	}
+
+	return total;
+}
+
+/**
+ * Place les frontières entre les bandes pour que chacune contienne la part de la longueur des
+ * traits donnée à son robot, sans qu'aucune, sauf la dernière, soit plus étroite qu'une largeur
+ * minimale, pour que les robots voisins ne se gênent pas.
+ *
+ * @param traits     Les traits du dessin.
+ * @param flotte     Les robots, dont les bandes sont placées.
+ * @param min        La plus petite coordonnée des traits selon l'axe de découpe.
+ * @param max        La plus grande.
+ * @param largeurMin La largeur minimale des bandes, qui doivent toutes tenir entre min et max.
+ */
+void placerBandes(const std::vector<Trait> &traits, std::vector<Robot> &flotte, double min, double max, double largeurMin) {
+	double total = longueurAvant(traits, max), cumul = 0;
+	double debut = min;
+	for (size_t r = 0; r < flotte.size(); r++) {
+		cumul += flotte[r].part;
+		double bas = debut, haut = max;
+		for (int i = 0; i < 50 && r + 1 < flotte.size(); i++) {			// Recherche dichotomique de la frontière.
+			double milieu = (bas + haut) / 2;
+			if (longueurAvant(traits, milieu) < cumul * total) {
+				bas = milieu;
+			}
+			else {
+				haut = milieu;
+			}
+		}
+		haut = fmin(fmax(haut, debut + largeurMin), max - (flotte.size() - 1 - r) * largeurMin);
+		flotte[r].debut = debut;
+		flotte[r].fin = r + 1 < flotte.size() ? haut : max;
+		debut = flotte[r].fin;
+	}
+}
+
+/**
+ * Trouve la bande qui contient un point.
+ *
+ * @param  flotte Les robots et leurs bandes.
+ * @param  p      Le point.
+ * @return        L'indice du robot ; une frontière appartient à la bande suivante.
+ */
+int bande(const std::vector<Robot> &flotte, const Point &p) {
+	int r = 0;
+	while (r + 1 < (int)flotte.size() && le(p) >= flotte[r].fin) {
+		r++;
+	}
+
+	return r;
+}
+
+/**
+ * Ajoute un morceau de trait à ceux d'une bande, s'il n'est pas négligeable.
+ *
+ * @param morceaux Les morceaux de chaque bande.
+ * @param r        L'indice de la bande.
+ * @param morceau  Le morceau.
+ */
+void garderMorceau(std::vector<std::vector<Trait> > &morceaux, int r, const Trait &morceau) {
+	if (morceau.size() > 1 && longueur(morceau) >= longueurNegligeable) {
+		morceaux[r].push_back(morceau);
+	}
+}
+
+/**
+ * Coupe les traits aux frontières des bandes.
+ *
+ * @param  traits Les traits du dessin.
+ * @param  flotte Les robots et leurs bandes.
+ * @return        Les morceaux de traits de chaque bande.
+ */
+std::vector<std::vector<Trait> > couperTraits(const std::vector<Trait> &traits, const std::vector<Robot> &flotte) {
+	std::vector<std::vector<Trait> > morceaux(flotte.size());
+	for (size_t t = 0; t < traits.size(); t++) {
+		const Trait &trait = traits[t];
+		int r = bande(flotte, trait[0]);
+		Trait morceau(1, trait[0]);
+
+		for (size_t i = 1; i < trait.size(); i++) {
+			const Point &a = trait[i - 1], &b = trait[i];
+			int rb = bande(flotte, b);
+			while (r != rb) {											// Le segment traverse une ou plusieurs frontières.
+				double frontiere = rb > r ? flotte[r].fin : flotte[r].debut;
+				double k = (frontiere - le(a)) / (le(b) - le(a));
+				Point coupe = {a.x + k * (b.x - a.x), a.y + k * (b.y - a.y)};
+				morceau.push_back(coupe);
+				garderMorceau(morceaux, r, morceau);
+				morceau.assign(1, coupe);
+				r += rb > r ? 1 : -1;
+			}
+			morceau.push_back(b);
+		}
+		garderMorceau(morceaux, r, morceau);
+	}
+
+	return morceaux;
+}
+
+/**
+ * Déplace des traits.
+ *
+ * @param traits Les traits, modifiés.
+ * @param dx     Le déplacement selon les x.
+ * @param dy     Le déplacement selon les y.
+ */
+void deplacer(std::vector<Trait> &traits, double dx, double dy) {
+	for (size_t t = 0; t < traits.size(); t++) {
+		for (size_t i = 0; i < traits[t].size(); i++) {
+			traits[t][i].x += dx;
+			traits[t][i].y += dy;
+		}
+	}
+}
+
+/**
+ * Ordonne les morceaux d'une bande en la balayant tranche par tranche, dans le sens de l'axe de
+ * découpe. Chaque tranche est ordonnée par parcoursOrdonner() depuis la fin de la précédente.
+ *
+ * @param robot    Le robot, dont les traits sont remplis.
+ * @param morceaux Les morceaux de sa bande.
+ * @param largeur  La largeur visée des tranches.
+ */
+void balayer(Robot &robot, const std::vector<Trait> &morceaux, double largeur) {
+	int nbTranches = std::max(1, (int)floor((robot.fin - robot.debut) / largeur));
+	double largeurTranche = (robot.fin - robot.debut) / nbTranches;
+	std::vector<std::vector<Trait> > tranches(nbTranches);
+	for (size_t m = 0; m < morceaux.size(); m++) {						// Un morceau va dans la tranche de son milieu.
+		const Trait &morceau = morceaux[m];
+		double milieu = (le(morceau.front()) + le(morceau.back())) / 2;
+		int i = (int)floor((milieu - robot.debut) / largeurTranche);
+		tranches[std::min(std::max(i, 0), nbTranches - 1)].push_back(morceau);
+	}
+
+	robot.traits.clear();
+	Point position = robot.depart;
+	for (int i = 0; i < nbTranches; i++) {
+		if (tranches[i].empty()) {
+			continue;
+		}
+		deplacer(tranches[i], -position.x, -position.y);				// parcoursOrdonner() part de l'origine.
+		std::vector<Trait> ordonnes = parcoursOrdonner(tranches[i]);
+		deplacer(ordonnes, position.x, position.y);
+		robot.traits.insert(robot.traits.end(), ordonnes.begin(), ordonnes.end());
+		position = robot.traits.back().back();
+	}
+
+	std::vector<Trait> locaux = robot.traits;							// Le robot part de son coin, tourné vers les x.
+	deplacer(locaux, -robot.depart.x, -robot.depart.y);
+	robot.commandes = parcoursCommandes(locaux);
+}
+
+/**
+ * Exécute des commandes comme le ferait le programme écrit pour le robot.
+ *
+ * @param commandes Les commandes.
+ */
+void executer(const std::vector<Commande> &commandes) {
+	commandesOuvrir();
+	for (size_t i = 0; i < commandes.size(); i++) {
+		switch (commandes[i].type) {
+			case COMMANDE_AVANCER:
+				avancer(commandes[i].valeur);
+				break;
+			case COMMANDE_TOURNER:
+				tournerGauche(commandes[i].valeur);
+				break;
+			case COMMANDE_MONTER_FEUTRE:
+				monterFeutre();
+				break;
+			case COMMANDE_DESCENDRE_FEUTRE:
+				descendreFeutre();
+				break;
+		}
+	}
+	commandesFermer();
+}
+
+/**
+ * Exécute les commandes à estimer, pour estimer().
+ */
+void executerEstimees() {
+	executer(*commandesEstimees);
+}
+
+/**
+ * Répartit les traits entre les robots selon leurs parts, et estime la durée de chacun avec son
+ * profil.
+ *
+ * @param  traits  Les traits du dessin.
+ * @param  flotte  Les robots, dont les bandes, les traits et les commandes sont remplis.
+ * @param  min     Le coin inférieur gauche du dessin.
+ * @param  max     Son coin supérieur droit.
+ * @param  largeur La largeur visée des tranches, le rayon d'encombrement d'un robot.
+ * @return         La durée estimée du robot le plus lent, en secondes.
+ */
+double repartir(const std::vector<Trait> &traits, std::vector<Robot> &flotte, const Point &min, const Point &max, double largeur) {
+	placerBandes(traits, flotte, le(min), le(max), 3 * largeur);		// Une tranche et deux rayons d'encombrement.
+	std::vector<std::vector<Trait> > morceaux = couperTraits(traits, flotte);
+
+	double plusLongue = 0;
+	for (size_t r = 0; r < flotte.size(); r++) {
+		Robot &robot = flotte[r];
+		robot.depart.x = vertical ? travers(min) : robot.debut;			// Les robots partent alignés au bord du dessin.
+		robot.depart.y = vertical ? robot.debut : travers(min);
+		balayer(robot, morceaux[r], largeur);
+
+		initialiser(robot.couleur);
+		commandesEstimees = &robot.commandes;
+		robot.dureeEstimee = estimer(executerEstimees).duree;
+		plusLongue = fmax(plusLongue, robot.dureeEstimee);
+	}
+
+	return plusLongue;
+}
+
+/**
+ * Corrige les parts des robots pour équilibrer leurs durées, en répartissant de nouveau tant que
+ * la durée du plus lent baisse. La part de chaque robot devient proportionnelle à la vitesse à
+ * laquelle il a tracé la sienne.
+ *
+ * @param  traits  Les traits du dessin.
+ * @param  flotte  Les robots, qui gardent la meilleure répartition trouvée.
+ * @param  min     Le coin inférieur gauche du dessin.
+ * @param  max     Son coin supérieur droit.
+ * @param  largeur La largeur visée des tranches.
+ * @return         La durée estimée du robot le plus lent, en secondes.
+ */
+double equilibrer(const std::vector<Trait> &traits, std::vector<Robot> &flotte, const Point &min, const Point &max, double largeur) {
+	std::vector<Robot> meilleure;
+	double meilleureDuree = HUGE_VAL;
+
+	for (int i = 0; i < nbMaxEquilibrages; i++) {
+		double duree = repartir(traits, flotte, min, max, largeur);
+		if (duree >= meilleureDuree) {
+			break;
+		}
+		meilleure = flotte;
+		meilleureDuree = duree;
+
+		double total = 0;
+		for (size_t r = 0; r < flotte.size(); r++) {					// Un robot sans rien à tracer est supposé rapide.
+			flotte[r].part /= fmax(flotte[r].dureeEstimee, 0.1);
+			total += flotte[r].part;
+		}
+		for (size_t r = 0; r < flotte.size(); r++) {
+			flotte[r].part /= total;
+		}
+	}
+
+	flotte = meilleure;
+	return meilleureDuree;
+}
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui reconstruit les traits du robot simulé
+ * et relève régulièrement sa position.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void suivre(const Evenement &evenement) {
+	renduEvenement(evenement);
+	if (evenement.instant >= prochainSuivi) {
+		Point position = renduPosition();
+		Echantillon echantillon = {(double)(evenement.instant - debutSuivi) / FREQUENCE_MOTEURS,
+				{position.x + robotSuivi->depart.x, position.y + robotSuivi->depart.y}};
+		robotSuivi->suivi.push_back(echantillon);
+		prochainSuivi = evenement.instant + (uint64_t)(intervalleSuivi * FREQUENCE_MOTEURS);
+	}
+}
+
+/**
+ * Simule un robot avec son profil : sa durée, ses traits et ses positions successives.
+ *
+ * @param robot Le robot.
+ */
+void simuler(Robot &robot) {
+	robotSuivi = &robot;
+	robot.suivi.clear();
+	initialiser(robot.couleur);
+	renduDemarrer(feutreEstLeve());
+	debutSuivi = prochainSuivi = hoteInstant();
+	hoteObserver(suivre);
+	executer(robot.commandes);
+	terminer();
+	hoteObserver(NULL);
+
+	robot.duree = (double)(hoteInstant() - debutSuivi) / FREQUENCE_MOTEURS;
+	Point position = renduPosition();
+	Echantillon fin = {robot.duree, {position.x + robot.depart.x, position.y + robot.depart.y}};
+	robot.suivi.push_back(fin);
+	robot.traces.clear();
+	const std::vector<Trait> &traces = renduTraits();
+	for (size_t t = 0; t < traces.size(); t++) {						// Le feutre posé au départ, puis levé, ne trace rien.
+		if (longueur(traces[t]) >= longueurNegligeable) {
+			robot.traces.push_back(traces[t]);
+		}
+	}
+	deplacer(robot.traces, robot.depart.x, robot.depart.y);
+}
+
+/**
+ * Donne la position d'un robot simulé à un instant donné, depuis le départ de toute la flotte.
+ *
+ * @param  robot   Le robot.
+ * @param  instant L'instant en secondes.
+ * @param  bouge   Vrai en sortie si le robot est en train de tracer son programme.
+ * @return         Sa position : celle de départ pendant son retard, la dernière une fois fini.
+ */
+Point positionA(const Robot &robot, double instant, bool &bouge) {
+	double t = instant - robot.retard;
+	bouge = t >= 0 && t < robot.duree;
+	if (t < 0 || robot.suivi.empty()) {
+		return robot.depart;
+	}
+
+	size_t bas = 0, haut = robot.suivi.size();							// Le dernier échantillon relevé avant t.
+	while (haut - bas > 1) {
+		size_t milieu = (bas + haut) / 2;
+		if (robot.suivi[milieu].instant <= t) {
+			bas = milieu;
+		}
+		else {
+			haut = milieu;
+		}
+	}
+
+	return robot.suivi[bas].instant <= t ? robot.suivi[bas].position : robot.depart;
+}
+
+/**
+ * Cherche la première rencontre entre deux robots de la flotte, compte tenu de leurs retards.
+ *
+ * @param  flotte     Les robots simulés.
+ * @param  distance   La distance minimale entre deux robots.
+ * @param  aRetarder  Reçoit l'indice du robot à retarder, ou -1 si aucun ne bouge.
+ * @return            L'instant de la rencontre en secondes, ou une valeur négative s'il n'y en a pas.
+ */
+double chercherRencontre(const std::vector<Robot> &flotte, double distance, int &aRetarder) {
+	double fin = 0;
+	for (size_t r = 0; r < flotte.size(); r++) {
+		fin = fmax(fin, flotte[r].retard + flotte[r].duree);
+	}
+
+	std::vector<Point> positions(flotte.size());
+	std::vector<bool> bougent(flotte.size());
+	for (double t = 0; t <= fin + intervalleSuivi; t += intervalleSuivi) {
+		for (size_t r = 0; r < flotte.size(); r++) {
+			bool bouge;
+			positions[r] = positionA(flotte[r], t, bouge);
+			bougent[r] = bouge;
+		}
+		for (size_t a = 0; a < flotte.size(); a++) {
+			for (size_t b = a + 1; b < flotte.size(); b++) {
+				if (hypot(positions[a].x - positions[b].x, positions[a].y - positions[b].y) >= distance) {
+					continue;
+				}
+				aRetarder = bougent[a] ? a : bougent[b] ? b : -1;		// Celui qui balaie derrière l'autre attend.
+				return t;
+			}
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Écrit le programme d'un robot, à coller dans la fonction `setup()` d'un croquis.
+ *
+ * @param fichier Le fichier ouvert en écriture.
+ * @param figure  Le dessin partagé.
+ * @param robot   Le robot.
+ * @param numero  Son numéro dans la flotte, à partir de 1.
+ * @param nb      Le nombre de robots de la flotte.
+ */
+void ecrireProgramme(FILE *fichier, const Figure &figure, const Robot &robot, int numero, int nb) {
+	fprintf(fichier, "// %s partagé par flotteTortuino : robot '%c', %d sur %d.\n", figure.nom, robot.couleur, numero, nb);
+	double x = fabs(robot.depart.x) < 0.05 ? 0 : robot.depart.x;		// Sans « -0.0 » pour un départ à l'origine.
+	double y = fabs(robot.depart.y) < 0.05 ? 0 : robot.depart.y;
+	fprintf(fichier, "// Poser le robot en (%.1f, %.1f) cm, tourné vers les x croissants.\n", x, y);
+	fprintf(fichier, "initialiser('%c');\n", robot.couleur);
+	if (robot.retard > 0) {
+		fprintf(fichier, "delay(%ld);\n", lround(robot.retard * 1000));
+	}
+	for (size_t i = 0; i < robot.commandes.size(); i++) {
+		switch (robot.commandes[i].type) {
+			case COMMANDE_AVANCER:
+				fprintf(fichier, "avancer(%.3f);\n", robot.commandes[i].valeur);
+				break;
+			case COMMANDE_TOURNER:
+				fprintf(fichier, "tournerGauche(%.3f);\n", robot.commandes[i].valeur);
+				break;
+			case COMMANDE_MONTER_FEUTRE:
+				fprintf(fichier, "monterFeutre();\n");
+				break;
+			case COMMANDE_DESCENDRE_FEUTRE:
+				fprintf(fichier, "descendreFeutre();\n");
+				break;
+		}
+	}
+	fprintf(fichier, "terminer();\n");
+}
+
+int main(int argc, char **argv) {
+	const char *couleurs = "wjb", *prefixe = NULL;
+	double rayon = 8;
+	int i = 1;
+
+	for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {					// Lecture des options.
+		if (strcmp(argv[i], "-f") == 0) {
+			couleurs = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-c") == 0) {
+			rayon = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-o") == 0) {
+			prefixe = argv[i + 1];
+		}
+		else {
+			break;
+		}
+	}
+
+	const Figure *figure = i < argc ? figureTrouver(argv[i]) : NULL;
+	if (figure == NULL || strlen(couleurs) == 0 || rayon <= 0) {
+		fprintf(stderr, "Usage : %s [-f couleurs] [-c rayonRobot] [-o prefixe] dessin [paramètres...]\n", argv[0]);
+		return 1;
+	}
+	float parametres[NB_MAX_PARAMETRES];
+	for (int j = 0; j < NB_MAX_PARAMETRES; j++) {						// Les paramètres donnés remplacent ceux par défaut.
+		parametres[j] = i + j + 1 < argc ? atof(argv[i + j + 1]) : figure->parametresDefaut[j];
+	}
+
+	std::vector<Robot> flotte(strlen(couleurs));
+	for (size_t r = 0; r < flotte.size(); r++) {
+		flotte[r].couleur = couleurs[r];
+		flotte[r].retard = 0;
+	}
+
+	hoteEnregistrer(false);												// Le dessin tracé par un seul robot,
+	initialiser(flotte[0].couleur);
+	renduDemarrer(feutreEstLeve());
+	hoteObserver(renduEvenement);
+	uint64_t debut = hoteInstant();
+	parcoursCapturer(true);												// dont les traits sont capturés.
+	figure->tracer(parametres);
+	terminer();
+	parcoursCapturer(false);
+	hoteObserver(NULL);
+	double dureeSeul = (double)(hoteInstant() - debut) / FREQUENCE_MOTEURS;
+	std::vector<Trait> original = renduTraits();
+	const std::vector<Trait> &traits = parcoursTraits();
+	if (traits.empty()) {
+		fprintf(stderr, "%s ne trace rien.\n", figure->nom);
+		return 1;
+	}
+
+	Point min = traits[0][0], max = traits[0][0];
+	for (size_t t = 0; t < traits.size(); t++) {
+		for (size_t p = 0; p < traits[t].size(); p++) {
+			min.x = fmin(min.x, traits[t][p].x);
+			min.y = fmin(min.y, traits[t][p].y);
+			max.x = fmax(max.x, traits[t][p].x);
+			max.y = fmax(max.y, traits[t][p].y);
+		}
+	}
+	vertical = max.y - min.y > max.x - min.x;							// Les bandes coupent le plus grand côté.
+	size_t nbPlaces = std::max(1, (int)floor((le(max) - le(min)) / (3 * rayon)));
+	if (flotte.size() > nbPlaces) {										// Les bandes ont au moins trois rayons de large.
+		fprintf(stderr, "Le dessin n'a de place que pour %lu robot%s côte à côte : '%s' n'%s rien à tracer.\n", (unsigned long)nbPlaces,
+				nbPlaces > 1 ? "s" : "", couleurs + nbPlaces, flotte.size() - nbPlaces > 1 ? "ont" : "a");
+		flotte.resize(nbPlaces);
+	}
+	for (size_t r = 0; r < flotte.size(); r++) {
+		flotte[r].part = 1.0 / flotte.size();
+	}
+	std::vector<Robot> seul(1, flotte[0]);								// Le premier robot seul, avec le même balayage,
+	seul[0].part = 1;
+	repartir(traits, seul, min, max, rayon);
+	simuler(seul[0]);
+	double estimee = equilibrer(traits, flotte, min, max, rayon);		// puis toute la flotte.
+
+	double dureeFlotte = 0;
+	for (size_t r = 0; r < flotte.size(); r++) {
+		simuler(flotte[r]);
+	}
+
+	int aRetarder = -1;
+	double rencontre;
+	while ((rencontre = chercherRencontre(flotte, 2 * rayon, aRetarder)) >= 0 && aRetarder >= 0 && flotte[aRetarder].retard < estimee) {	// Attendre plus longtemps ne serait plus travailler à plusieurs.
+		flotte[aRetarder].retard += pasRetard;
+	}
+	for (size_t r = 0; r < flotte.size(); r++) {
+		dureeFlotte = fmax(dureeFlotte, flotte[r].retard + flotte[r].duree);
+		fprintf(stderr, "robot '%c' : bande de %8.2f à %8.2f cm, %5lu traits, %10.2f s estimées, %10.2f s simulées, %6.1f s de retard\n",
+				flotte[r].couleur, flotte[r].debut, flotte[r].fin, (unsigned long)flotte[r].traits.size(),
+				flotte[r].dureeEstimee, flotte[r].duree, flotte[r].retard);
+	}
+
+	std::vector<Trait> morceaux;										// Les morceaux couvrent-ils tout le dessin,
+	double ecartTraces = 0, ecartSeul = renduEcart(original, traits, ecartMaxMesure);
+	for (size_t r = 0; r < flotte.size(); r++) {						// et chaque robot trace-t-il les siens ?
+		morceaux.insert(morceaux.end(), flotte[r].traits.begin(), flotte[r].traits.end());
+		ecartTraces = fmax(ecartTraces, renduEcart(flotte[r].traces, flotte[r].traits, ecartMaxMesure));
+	}
+	double ecartMorceaux = renduEcart(morceaux, traits, toleranceDessin);
+	bool fidele = ecartMorceaux <= toleranceDessin && ecartTraces <= fmax(toleranceTrace, ecartSeul);
+
+	fprintf(stderr, "dessin original : %.2f s ; balayé par un robot : %.2f s ; par %lu robot%s : %.2f s (%.2f s estimées), soit %.2f fois plus vite\n",
+			dureeSeul, seul[0].duree, (unsigned long)flotte.size(), flotte.size() > 1 ? "s" : "", dureeFlotte, estimee, seul[0].duree / dureeFlotte);
+	fprintf(stderr, "écarts : %.4f cm entre les morceaux et le dessin, %.4f cm entre les robots et leurs morceaux, %.4f cm pour un robot seul\n",
+			ecartMorceaux, ecartTraces, ecartSeul);
+
+	for (size_t r = 0; r < flotte.size(); r++) {
+		if (prefixe == NULL) {
+			ecrireProgramme(stdout, *figure, flotte[r], r + 1, flotte.size());
+			continue;
+		}
+
+		std::string nom = std::string(prefixe) + "-" + flotte[r].couleur + ".ino";
+		FILE *fichier = fopen(nom.c_str(), "w");
+		if (fichier == NULL) {
+			fprintf(stderr, "Impossible d'écrire %s.\n", nom.c_str());
+			return 1;
+		}
+		ecrireProgramme(fichier, *figure, flotte[r], r + 1, flotte.size());
+		fclose(fichier);
+	}
+
+	if (rencontre >= 0) {
+		fprintf(stderr, "Les robots se rencontrent à %.2f s : les bandes sont trop étroites pour %lu robots.\n", rencontre, (unsigned long)flotte.size());
+		return 1;
+	}
+	if (!fidele) {
+		fprintf(stderr, "Le dessin partagé diffère de l'original.\n");
+		return 1;
+	}
+
+	return 0;
+}
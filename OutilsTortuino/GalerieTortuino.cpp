@@ -0,0 +1,470 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+# include <stdint.h>
+# include <unistd.h>
+# include <sys/wait.h>
+# include <algorithm>
+# include <chrono>
+# include <map>
+# include <string>
+# include <vector>
+# include "Tortuino.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoEstimation.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Rendu.h"
+
+
+/**
+ * @file GalerieTortuino.cpp
+ * @brief Ce programme régénère les images de la documentation, en parallèle et seulement si nécessaire.
+ * @version 1.0
+ *
+ * Le programme galerieTortuino lit un manifeste qui donne, pour chaque image du dossier Images
+ * citée par les commentaires de TortuinoDessins.cpp, le dessin qui la produit, la direction du
+ * robot au départ, en degrés depuis la droite de l'image dans le sens trigonométrique, et les
+ * paramètres du dessin, une image par ligne :
+ *
+ * {@code
+ * 	# image				dessin				cap		paramètres
+ * 	arbre-10.png		arbre				90		10 10
+ * 	maison.png			maison				180
+ * }
+ *
+ * Chaque image est dessinée grâce à Rendu.cpp, puis tournée de ce cap pour que le dessin y soit
+ * droit. Les options sont :
+ *
+ * {@code
+ * 	./galerieTortuino [-m manifeste] [-d dossier] [-r pixelsParCentimetre] [-j nbTaches] [-f 1]
+ * }
+ *
+ * La bibliothèque gardant son état dans des variables globales, deux dessins ne peuvent pas être
+ * exécutés dans le même processus : chaque image l'est donc dans un processus fils, et nbTaches
+ * d'entre eux, autant que de processeurs par défaut, tournent à la fois. Dès que l'un se termine,
+ * le suivant de la file est lancé. La file est triée du plus long au plus court grâce aux
+ * estimations de TortuinoEstimation.cpp, qui ne coûtent presque rien : les grands arbres partent
+ * les premiers et les petits polygones comblent la fin, sans qu'un processeur attende seul.<br/>
+ *
+ * Le fichier galerie.empreintes du dossier garde deux empreintes par image. La première résume
+ * ce qui la produit : la ligne du manifeste, la résolution et le programme lui-même, dans lequel
+ * est compilé le code des dessins. Si elle n'a pas changé, l'image n'est pas refaite. Sinon elle
+ * est redessinée, mais le fichier n'est réécrit que si la seconde empreinte, celle des traits
+ * obtenus, a changé : un changement de la bibliothèque qui ne modifie pas un dessin laisse donc
+ * son image intacte, ainsi que sa date. L'option `-f 1` refait et réécrit toutes les images.
+ */
+
+
+
+const char	*manifesteDefaut	=	"OutilsTortuino/Galerie.txt";	/**< Le manifeste, depuis la racine du dépôt. */
+const char	*dossierDefaut		=	"Images";						/**< Le dossier des images, depuis la racine du dépôt. */
+const char	*nomEmpreintes		=	"galerie.empreintes";			/**< Le fichier des empreintes, dans le dossier des images. */
+
+const uint64_t	baseFnv			=	14695981039346656037ULL;	/**< La valeur de départ de l'empreinte FNV-1a sur 64 bits. */
+const uint64_t	premierFnv		=	1099511628211ULL;			/**< Le multiplicateur de l'empreinte FNV-1a sur 64 bits. */
+
+/**
+ * Une image du manifeste, avec ce qu'il faut pour la produire et savoir si elle a changé.
+ */
+struct Travail {
+	std::string image;
+	std::string ligne;
+	const Figure *figure;
+	float cap;
+	float parametres[NB_MAX_PARAMETRES];
+	float duree;
+	uint64_t entrees;
+	uint64_t traits;
+	pid_t processus;
+	int tube;
+};
+
+const Figure	*figureEstimee		=	NULL;		/**< Le dessin estimé par tracerEstime(). */
+const float		*parametresEstimes	=	NULL;		/**< Ses paramètres. */
+
+
+/**
+ * Ajoute des octets à une empreinte FNV-1a.
+ *
+ * @param  depart L'empreinte des octets précédents.
+ * @param  octets Les octets.
+ * @param  taille Leur nombre.
+ * @return        L'empreinte complétée.
+ */
+uint64_t empreinte(uint64_t depart, const void *octets, size_t taille) {
+	const unsigned char *p = (const unsigned char *)octets;
+	for (size_t i = 0; i < taille; i++) {
+		depart = (depart ^ p[i]) * premierFnv;
+	}
+
+	return depart;
+}
+
+/**
+ * Calcule l'empreinte d'un fichier.
+ *
+ * @param  nom Le chemin du fichier.
+ * @return     L'empreinte de son contenu, ou 0 s'il est illisible.
+ */
+uint64_t empreinteFichier(const char *nom) {
+	FILE *fichier = fopen(nom, "rb");
+	if (fichier == NULL) {
+		return 0;
+	}
+
+	uint64_t resultat = baseFnv;
+	unsigned char tampon[65536];
+	size_t lus;
+	while ((lus = fread(tampon, 1, sizeof(tampon), fichier)) > 0) {
+		resultat = empreinte(resultat, tampon, lus);
+	}
+
+	fclose(fichier);
+	return resultat;
+}
+
+/**
+ * Calcule l'empreinte de traits, au dix-millième de centimètre comme dans les références.
+ *
+ * @param  traits Les traits.
+ * @return        Leur empreinte.
+ */
+uint64_t empreinteTraits(const std::vector<Trait> &traits) {
+	uint64_t resultat = baseFnv;
+	for (size_t i = 0; i < traits.size(); i++) {
+		uint32_t nbPoints = traits[i].size();
+		resultat = empreinte(resultat, &nbPoints, sizeof(nbPoints));
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			int64_t coordonnees[2] = {llround(traits[i][j].x * 10000), llround(traits[i][j].y * 10000)};
+			resultat = empreinte(resultat, coordonnees, sizeof(coordonnees));
+		}
+	}
+
+	return resultat;
+}
+
+/**
+ * Lit les empreintes enregistrées par une exécution précédente.
+ *
+ * @param  chemin Le chemin du fichier des empreintes.
+ * @return        Pour chaque image, l'empreinte de ce qui la produit et celle de ses traits.
+ */
+std::map<std::string, std::pair<uint64_t, uint64_t> > lireEmpreintes(const char *chemin) {
+	std::map<std::string, std::pair<uint64_t, uint64_t> > empreintes;
+	FILE *fichier = fopen(chemin, "r");
+	if (fichier == NULL) {
+		return empreintes;
+	}
+
+	char image[256];
+	unsigned long long entrees, traits;
+	while (fscanf(fichier, "%255s %llx %llx", image, &entrees, &traits) == 3) {
+		empreintes[image] = std::make_pair((uint64_t)entrees, (uint64_t)traits);
+	}
+
+	fclose(fichier);
+	return empreintes;
+}
+
+/**
+ * Lit le manifeste : une image par ligne, suivie du nom du dessin, du cap de départ et des
+ * paramètres. Les lignes vides et celles qui commencent par # sont ignorées.
+ *
+ * @param  chemin   Le chemin du manifeste.
+ * @param  travaux  Les images à produire, à compléter.
+ * @return          Vrai si le manifeste a pu être lu et ne cite que des dessins connus.
+ */
+bool lireManifeste(const char *chemin, std::vector<Travail> &travaux) {
+	FILE *fichier = fopen(chemin, "r");
+	if (fichier == NULL) {
+		fprintf(stderr, "Impossible de lire le manifeste %s.\n", chemin);
+		return false;
+	}
+
+	char ligne[256];
+	bool correct = true;
+	while (fgets(ligne, sizeof(ligne), fichier) != NULL) {
+		char image[128], nom[64];
+		float cap;
+		int lus;
+		if (ligne[0] == '#' || sscanf(ligne, "%127s %63s %f%n", image, nom, &cap, &lus) != 3) {
+			continue;
+		}
+
+		Travail travail;
+		travail.cap = cap;
+		travail.figure = figureTrouver(nom);
+		if (travail.figure == NULL) {
+			fprintf(stderr, "%s : dessin inconnu %s.\n", image, nom);
+			correct = false;
+			continue;
+		}
+
+		memcpy(travail.parametres, travail.figure->parametresDefaut, sizeof(travail.parametres));
+		char *lecture = ligne + lus;
+		for (int i = 0; i < travail.figure->nbParametres; i++) {			// Les paramètres absents gardent leur valeur par défaut.
+			char *fin;
+			float valeur = strtof(lecture, &fin);
+			if (fin == lecture) {
+				break;
+			}
+			travail.parametres[i] = valeur;
+			lecture = fin;
+		}
+
+		travail.image = image;
+		travail.ligne = ligne;
+		travaux.push_back(travail);
+	}
+
+	fclose(fichier);
+	return correct;
+}
+
+/**
+ * Trace le dessin à estimer, pour estimer().
+ */
+void tracerEstime() {
+	figureEstimee->tracer(parametresEstimes);
+}
+
+/**
+ * Dessine une image et l'écrit si ses traits ont changé. Appelée dans un processus fils.
+ *
+ * @param  travail    L'image à produire.
+ * @param  chemin     Le chemin du fichier de l'image.
+ * @param  resolution La résolution en pixels par centimètre.
+ * @param  forcer     Vrai pour écrire l'image même si ses traits n'ont pas changé.
+ * @param  ecrite     Vrai en sortie si le fichier a été écrit.
+ * @return            L'empreinte des traits, ou 0 si l'image n'a pas pu être écrite.
+ */
+uint64_t produire(const Travail &travail, const std::string &chemin, double resolution, bool forcer, bool &ecrite) {
+	hoteEnregistrer(false);												// Les pas sont suivis au fil de l'eau, pas enregistrés.
+	initialiser();
+	renduDemarrer(feutreEstLeve());
+	hoteObserver(renduEvenement);
+	travail.figure->tracer(travail.parametres);
+	terminer();
+
+	std::vector<Trait> traits = renduTraits();
+	double cosinus = cos(travail.cap * M_PI / 180), sinus = sin(travail.cap * M_PI / 180);
+	for (size_t i = 0; i < traits.size(); i++) {						// Le robot partait vers la droite.
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			Point p = traits[i][j];
+			traits[i][j].x = p.x * cosinus - p.y * sinus;
+			traits[i][j].y = p.x * sinus + p.y * cosinus;
+		}
+	}
+
+	uint64_t resultat = empreinteTraits(traits);
+	ecrite = forcer || resultat != travail.traits || access(chemin.c_str(), F_OK) != 0;
+	if (ecrite && !renduEcrirePng(chemin.c_str(), traits, resolution)) {
+		return 0;
+	}
+
+	return resultat;
+}
+
+/**
+ * Lance un processus fils qui produit une image et renvoie par un tube l'empreinte de ses traits.
+ *
+ * @param  travail    L'image à produire, qui reçoit le processus et le tube.
+ * @param  chemin     Le chemin du fichier de l'image.
+ * @param  resolution La résolution en pixels par centimètre.
+ * @param  forcer     Vrai pour écrire l'image même si ses traits n'ont pas changé.
+ * @return            Vrai si le processus a pu être lancé.
+ */
+bool lancer(Travail &travail, const std::string &chemin, double resolution, bool forcer) {
+	int tube[2];
+	if (pipe(tube) != 0) {
+		return false;
+	}
+
+	fflush(stdout);														// Sinon le fils récrirait ce qui attend d'être affiché.
+	travail.processus = fork();
+	if (travail.processus < 0) {
+		close(tube[0]);
+		close(tube[1]);
+		return false;
+	}
+
+	if (travail.processus == 0) {
+		close(tube[0]);
+		bool ecrite = false;
+		uint64_t traits = produire(travail, chemin, resolution, forcer, ecrite);
+		char reponse[64];
+		int taille = snprintf(reponse, sizeof(reponse), "%llx %d\n", (unsigned long long)traits, ecrite ? 1 : 0);
+		bool envoyee = write(tube[1], reponse, taille) == taille;
+		_exit(traits != 0 && envoyee ? 0 : 1);
+	}
+
+	close(tube[1]);
+	travail.tube = tube[0];
+	return true;
+}
+
+/**
+ * Attend la fin d'un des processus fils et récupère son résultat.
+ *
+ * @param  travaux Les images, dont celles en cours de production.
+ * @param  ecrite  Vrai en sortie si le fichier de l'image a été écrit.
+ * @return         L'indice de l'image terminée, ou -1 si sa production a échoué.
+ */
+int attendre(std::vector<Travail> &travaux, bool &ecrite) {
+	int statut;
+	pid_t processus = wait(&statut);
+	for (size_t i = 0; i < travaux.size(); i++) {
+		if (travaux[i].processus != processus) {
+			continue;
+		}
+
+		char reponse[64] = "";
+		ssize_t lus = read(travaux[i].tube, reponse, sizeof(reponse) - 1);
+		close(travaux[i].tube);
+		travaux[i].processus = 0;
+
+		unsigned long long traits;
+		int drapeau;
+		if (lus <= 0 || !WIFEXITED(statut) || WEXITSTATUS(statut) != 0 || sscanf(reponse, "%llx %d", &traits, &drapeau) != 2) {
+			printf("%s : ÉCHEC\n", travaux[i].image.c_str());
+			return -1;
+		}
+
+		travaux[i].traits = traits;
+		ecrite = drapeau != 0;
+		return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Compare deux images par leur durée estimée, la plus longue en premier.
+ *
+ * @param  a La première image.
+ * @param  b La seconde image.
+ * @return   Vrai si la première doit être lancée avant la seconde.
+ */
+bool plusLongue(const Travail *a, const Travail *b) {
+	return a->duree > b->duree;
+}
+
+int main(int argc, char **argv) {
+	const char *manifeste = manifesteDefaut, *dossier = dossierDefaut;
+	double resolution = 20;
+	long nbTaches = sysconf(_SC_NPROCESSORS_ONLN);
+	bool forcer = false;
+	int i = 1;
+
+	for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {					// Lecture des options.
+		if (strcmp(argv[i], "-m") == 0) {
+			manifeste = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-d") == 0) {
+			dossier = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-r") == 0) {
+			resolution = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-j") == 0) {
+			nbTaches = atol(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-f") == 0) {
+			forcer = atoi(argv[i + 1]) != 0;
+		}
+		else {
+			break;
+		}
+	}
+	if (i < argc || resolution <= 0) {
+		fprintf(stderr, "Usage : %s [-m manifeste] [-d dossier] [-r pixelsParCentimetre] [-j nbTaches] [-f 1]\n", argv[0]);
+		return 1;
+	}
+	nbTaches = nbTaches < 1 ? 1 : nbTaches;
+
+	std::vector<Travail> travaux;
+	if (!lireManifeste(manifeste, travaux)) {
+		return 1;
+	}
+	std::string cheminEmpreintes = std::string(dossier) + "/" + nomEmpreintes;
+	std::map<std::string, std::pair<uint64_t, uint64_t> > empreintes = lireEmpreintes(cheminEmpreintes.c_str());
+
+	uint64_t programme = empreinteFichier("/proc/self/exe");			// Le code des dessins est compilé dans le programme.
+	if (programme == 0) {
+		programme = empreinteFichier(argv[0]);
+	}
+
+	hoteEnregistrer(false);
+	initialiser();
+	std::vector<Travail *> file;
+	for (size_t j = 0; j < travaux.size(); j++) {
+		Travail &travail = travaux[j];
+		travail.entrees = empreinte(programme, travail.ligne.c_str(), travail.ligne.size());
+		travail.entrees = empreinte(travail.entrees, &resolution, sizeof(resolution));
+		travail.traits = empreintes.count(travail.image) ? empreintes[travail.image].second : 0;
+		travail.processus = 0;
+
+		std::string chemin = std::string(dossier) + "/" + travail.image;
+		if (!forcer && empreintes.count(travail.image) && empreintes[travail.image].first == travail.entrees && access(chemin.c_str(), F_OK) == 0) {
+			continue;
+		}
+
+		figureEstimee = travail.figure;									// L'estimation ne fait pas bouger le robot.
+		parametresEstimes = travail.parametres;
+		travail.duree = estimer(tracerEstime).duree;
+		file.push_back(&travail);
+	}
+	std::stable_sort(file.begin(), file.end(), plusLongue);
+
+	std::chrono::steady_clock::time_point debut = std::chrono::steady_clock::now();
+	size_t prochain = 0;
+	int nbEnCours = 0, nbEcrites = 0, nbEchecs = 0;
+	while (prochain < file.size() || nbEnCours > 0) {
+		while (nbEnCours < nbTaches && prochain < file.size()) {
+			Travail &travail = *file[prochain++];
+			if (!lancer(travail, std::string(dossier) + "/" + travail.image, resolution, forcer)) {
+				printf("%s : ÉCHEC\n", travail.image.c_str());
+				nbEchecs++;
+				continue;
+			}
+			nbEnCours++;
+		}
+		if (nbEnCours == 0) {
+			break;
+		}
+
+		bool ecrite = false;
+		int fini = attendre(travaux, ecrite);
+		nbEnCours--;
+		if (fini < 0) {
+			nbEchecs++;
+			continue;
+		}
+
+		empreintes[travaux[fini].image] = std::make_pair(travaux[fini].entrees, travaux[fini].traits);
+		nbEcrites += ecrite ? 1 : 0;
+		printf("%s : %s\n", travaux[fini].image.c_str(), ecrite ? "écrite" : "inchangée");
+	}
+
+	FILE *fichier = fopen(cheminEmpreintes.c_str(), "w");
+	if (fichier == NULL) {
+		fprintf(stderr, "Impossible d'écrire %s.\n", cheminEmpreintes.c_str());
+		return 1;
+	}
+	for (size_t j = 0; j < travaux.size(); j++) {						// Les images sorties du manifeste sont oubliées.
+		if (empreintes.count(travaux[j].image)) {
+			const std::pair<uint64_t, uint64_t> &e = empreintes[travaux[j].image];
+			fprintf(fichier, "%s %016llx %016llx\n", travaux[j].image.c_str(), (unsigned long long)e.first, (unsigned long long)e.second);
+		}
+	}
+	fclose(fichier);
+
+	double duree = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+	printf("%lu image%s à jour, %lu refaite%s dont %d écrite%s, %d échec%s, en %.2f s sur %ld tâches\n",
+			(unsigned long)(travaux.size() - file.size()), travaux.size() - file.size() > 1 ? "s" : "",
+			(unsigned long)file.size(), file.size() > 1 ? "s" : "", nbEcrites, nbEcrites > 1 ? "s" : "",
+			nbEchecs, nbEchecs > 1 ? "s" : "", duree, nbTaches);
+	return nbEchecs == 0 ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+# include <stddef.h>
+# include <stdio.h>
+# include <deque>
+# include "MaterielHote.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoProfils.h"
+
+
+/**
+ * @file MaterielHote.cpp
+ * @brief Ce fichier permet d'exécuter la bibliothèque Tortuino sur un ordinateur, sans robot.
+ * @version 1.0
+ *
+ * Le fichier MaterielHote.cpp implémente les fonctions de TortuinoMateriel.h pour un ordinateur.
+ * Au lieu d'alimenter des bobines et de commander un servomoteur, il enregistre chaque pas de
+ * chaque roue et chaque mouvement du feutre sous la forme d'un événement daté. Le temps n'y est
+ * pas réel : c'est une horloge virtuelle comptée en interruptions du Timer2, qui n'avance que
+ * lorsque la bibliothèque attend. Chaque attente appelle alors directement moteursInterruption(),
+ * comme le ferait le Timer2, si bien qu'un dessin s'exécute aussi vite que le permet l'ordinateur
+ * tout en produisant exactement la même suite de pas, aux mêmes instants, que sur le robot.<br/>
+ *
+ * Le bouton de démarrage différé est considéré comme appuyé puis relâché dès qu'on le lit, ce qui
+ * fait que initialiser() rend la main immédiatement ; les appuis surveillés par interruption sont
+ * simulés par hoteBouton(). La carte SD est remplacée par les fichiers
+ * de l'ordinateur, et sa lecture ne fait pas avancer l'horloge virtuelle. La liaison série est
+ * remplacée par une boucle dans la mémoire de l'ordinateur : les outils y écrivent avec
+ * hoteSerieEnvoyer() et y lisent avec hoteSerieRecevoir(). Les octets n'arrivent au robot qu'au
+ * rythme que permet le débit choisi, en comptant dix bits par octet comme sur une vraie liaison.
+ *
+ * @see hoteEvenements()
+ */
+
+
+
+std::vector<Evenement>	evenements;						/**< Les événements enregistrés, dans l'ordre où ils se sont produits. */
+bool					enregistrement	=	true;		/**< Vrai si les événements doivent être enregistrés. */
+void					(*observateur)(const Evenement &)	=	NULL;	/**< La fonction à qui transmettre chaque événement, enregistré ou non. */
+uint64_t				instant			=	0;			/**< L'horloge virtuelle, en nombre d'interruptions du Timer2 depuis le démarrage. */
+unsigned char			phases[2]		=	{0, 0};		/**< La dernière phase écrite sur chacun des deux moteurs. */
+unsigned long			lecturesBouton	=	0;			/**< Le nombre de lectures du bouton, dont la parité donne son état simulé. */
+void					(*rappelBouton)(bool)	=	NULL;	/**< La fonction à qui transmettre les appuis simulés par hoteBouton(), ou NULL. */
+FILE					*fichier		=	NULL;		/**< Le fichier ouvert par materielFichierOuvrir(), qui tient lieu de carte SD. */
+std::deque<unsigned char>	versRobot;				/**< Les octets envoyés par hoteSerieEnvoyer() que le robot n'a pas encore lus. */
+std::deque<unsigned char>	versHote;				/**< Les octets envoyés par le robot que hoteSerieRecevoir() n'a pas encore lus. */
+unsigned long			debitSerie		=	0;			/**< Le débit simulé de la liaison série, en bits par seconde, ou 0 si elle est fermée. */
+uint64_t				budgetSerie		=	0;			/**< Les bits que la liaison a pu transmettre vers le robot, multipliés par FREQUENCE_MOTEURS. */
+
+
+/**
+ * Transmet un événement daté de l'instant actuel à l'observateur, s'il y en a un, et l'enregistre
+ * si l'enregistrement est actif.
+ *
+ * @param type   Le type de l'événement : EVENEMENT_PAS_GAUCHE, EVENEMENT_PAS_DROITE ou EVENEMENT_FEUTRE.
+ * @param valeur Le sens du pas, 1 ou -1, ou la position du feutre, 1 pour levé et 0 pour baissé.
+ */
+void enregistrer(unsigned char type, signed char valeur) {
+	Evenement evenement;
+	evenement.instant = instant;
+	evenement.type = type;
+	evenement.valeur = valeur;
+
+	if (observateur != NULL) {
+		observateur(evenement);
+	}
+	if (enregistrement) {
+		evenements.push_back(evenement);
+	}
+}
+
+/**
+ * N'a rien à préparer : comme `millis()` sur l'Arduino, l'horloge virtuelle n'est jamais remise à
+ * zéro, même si initialiser() est appelée plusieurs fois.
+ */
+void materielInitialiser() {
+}
+
+/**
+ * Enregistre le pas que provoque le changement de phase d'un moteur. Le sens du pas se déduit
+ * de l'écart avec la phase précédente : +1 ou -1 modulo PHASES_BOBINES.
+ *
+ * @param moteur Le moteur concerné : MOTEUR_GAUCHE ou MOTEUR_DROITE.
+ * @param phase  La nouvelle phase, de 0 à PHASES_BOBINES - 1.
+ */
+void materielBobines(unsigned char moteur, unsigned char phase) {
+	signed char sens = ((phase - phases[moteur]) & (PHASES_BOBINES - 1)) == 1 ? 1 : -1;
+	phases[moteur] = phase;
+	enregistrer(moteur == MOTEUR_GAUCHE ? EVENEMENT_PAS_GAUCHE : EVENEMENT_PAS_DROITE, sens);
+}
+
+/**
+ * Enregistre un mouvement du feutre.
+ *
+ * @param leve Vrai pour la position haute, faux pour la position basse.
+ */
+void materielFeutre(bool leve) {
+	enregistrer(EVENEMENT_FEUTRE, leve ? 1 : 0);
+}
+
+/**
+ * Simule un bouton appuyé à chaque lecture paire et relâché à chaque lecture impaire.
+ *
+ * @return Vrai si le bouton est considéré comme appuyé.
+ */
+bool materielBoutonAppuye() {
+	return lecturesBouton++ % 2 == 0;
+}
+
+/**
+ * Retient la fonction à qui transmettre les changements d'état du bouton simulés par hoteBouton().
+ *
+ * @param rappel La fonction qui reçoit le nouvel état du bouton, ou NULL.
+ */
+void materielBoutonSurveiller(void (*rappel)(bool appuye)) {
+	rappelBouton = rappel;
+}
+
+/**
+ * Donne le temps écoulé selon l'horloge virtuelle.
+ *
+ * @return Le temps en millisecondes.
+ */
+unsigned long materielMillis() {
+	return instant * 1000 / FREQUENCE_MOTEURS;
+}
+
+/**
+ * Donne le temps écoulé selon l'horloge virtuelle, à une interruption près. Les calculs de la
+ * bibliothèque n'y prennent donc aucun temps.
+ *
+ * @return Le temps en microsecondes.
+ */
+unsigned long materielMicros() {
+	return instant * 1000000 / FREQUENCE_MOTEURS;
+}
+
+/**
+ * Fait avancer l'horloge virtuelle d'une durée donnée, en faisant tourner les moteurs pendant
+ * ce temps.
+ *
+ * @param ms La durée en millisecondes.
+ */
+void materielDelai(unsigned long ms) {
+	for (uint64_t i = (uint64_t)ms * FREQUENCE_MOTEURS / 1000; i > 0; i--) {
+		materielPatienter();
+	}
+}
+
+/**
+ * Fait avancer l'horloge virtuelle d'une interruption et réalise celle-ci.
+ */
+void materielPatienter() {
+	instant++;
+	if (!versRobot.empty()) {											// La liaison transmet pendant ce temps.
+		budgetSerie += debitSerie;
+	}
+	moteursInterruption();
+}
+
+/**
+ * Ouvre un fichier de l'ordinateur en lecture, en fermant celui qui l'était.
+ *
+ * @param  nom Le chemin du fichier.
+ * @return     Vrai si le fichier a pu être ouvert.
+ */
+bool materielFichierOuvrir(const char *nom) {
+	materielFichierFermer();
+	fichier = fopen(nom, "rb");
+	return fichier != NULL;
+}
+
+/**
+ * Lit une partie du fichier ouvert par materielFichierOuvrir().
+ *
+ * @param  position La position en octets du début de la lecture dans le fichier.
+ * @param  tampon   Le tampon où écrire les octets lus.
+ * @param  taille   Le nombre d'octets à lire.
+ * @return          Le nombre d'octets lus, plus petit que taille à la fin du fichier, ou -1
+ * 					en cas d'erreur.
+ */
+int materielFichierLire(unsigned long position, unsigned char *tampon, int taille) {
+	if (fichier == NULL || fseek(fichier, position, SEEK_SET) != 0) {
+		return -1;
+	}
+
+	return (int)fread(tampon, 1, taille, fichier);
+}
+
+/**
+ * Ferme le fichier ouvert par materielFichierOuvrir(), s'il y en a un.
+ */
+void materielFichierFermer() {
+	if (fichier != NULL) {
+		fclose(fichier);
+		fichier = NULL;
+	}
+}
+
+/**
+ * Ouvre la liaison série simulée, en oubliant tout ce qui y était en attente.
+ *
+ * @param debit Le débit de la liaison, en bits par seconde.
+ */
+void materielSerieOuvrir(unsigned long debit) {
+	versRobot.clear();
+	versHote.clear();
+	debitSerie = debit;
+	budgetSerie = 0;
+}
+
+/**
+ * Lit un octet envoyé par hoteSerieEnvoyer(), s'il a eu le temps d'arriver.
+ *
+ * @return L'octet reçu, ou -1 si aucun n'attend.
+ */
+int materielSerieLire() {
+	const uint64_t coutOctet = 10 * FREQUENCE_MOTEURS;					// Dix bits par octet, départ et arrêt compris.
+	if (versRobot.empty() || budgetSerie < coutOctet) {
+		return -1;
+	}
+
+	budgetSerie -= coutOctet;
+	unsigned char octet = versRobot.front();
+	versRobot.pop_front();
+	return octet;
+}
+
+/**
+ * Envoie un octet à hoteSerieRecevoir().
+ *
+ * @param octet L'octet à envoyer.
+ */
+void materielSerieEcrire(unsigned char octet) {
+	versHote.push_back(octet);
+}
+
+/**
+ * Envoie un octet au robot par la liaison série simulée. Il ne lui parvient qu'après le temps
+ * de transmission de ceux qui le précèdent.
+ *
+ * @param octet L'octet à envoyer.
+ */
+void hoteSerieEnvoyer(unsigned char octet) {
+	versRobot.push_back(octet);
+}
+
+/**
+ * Lit un octet envoyé par le robot sur la liaison série simulée.
+ *
+ * @return L'octet reçu, ou -1 si aucun n'attend.
+ */
+int hoteSerieRecevoir() {
+	if (versHote.empty()) {
+		return -1;
+	}
+
+	unsigned char octet = versHote.front();
+	versHote.pop_front();
+	return octet;
+}
+
+/**
+ * Simule un changement d'état du bouton surveillé, comme le ferait son interruption sur le robot.
+ * Il n'a aucun effet sur les lectures de materielBoutonAppuye().
+ *
+ * @param appuye Vrai si le bouton vient d'être appuyé, faux s'il vient d'être relâché.
+ */
+void hoteBouton(bool appuye) {
+	if (rappelBouton != NULL) {
+		rappelBouton(appuye);
+	}
+}
+
+/**
+ * Active ou désactive l'enregistrement des événements. Le désactiver permet d'exécuter de très
+ * grands dessins sans en garder tous les pas en mémoire.
+ *
+ * @param actif Vrai pour enregistrer les événements.
+ */
+void hoteEnregistrer(bool actif) {
+	enregistrement = actif;
+}
+
+/**
+ * Choisit une fonction à qui transmettre chaque événement au moment où il se produit. Elle permet
+ * d'analyser de très grands dessins au fil de l'eau, l'enregistrement étant alors désactivé.
+ *
+ * @param nouveau La fonction à appeler pour chaque événement, ou `NULL` pour n'en appeler aucune.
+ */
+void hoteObserver(void (*nouveau)(const Evenement &evenement)) {
+	observateur = nouveau;
+}
+
+/**
+ * Oublie tous les événements enregistrés jusqu'ici.
+ */
+void hoteEffacer() {
+	evenements.clear();
+}
+
+/**
+ * Donne les événements enregistrés depuis le démarrage ou depuis le dernier appel à hoteEffacer().
+ *
+ * @return Les événements, dans l'ordre où ils se sont produits.
+ */
+const std::vector<Evenement> &hoteEvenements() {
+	return evenements;
+}
+
+/**
+ * Donne l'instant actuel de l'horloge virtuelle.
+ *
+ * @return Le nombre d'interruptions du Timer2 simulées depuis le démarrage.
+ */
+uint64_t hoteInstant() {
+	return instant;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file MaterielHote.h
+ * @brief Définition des fonctions propres à la version ordinateur du matériel.
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de MaterielHote.cpp. En plus des fonctions de
+ * TortuinoMateriel.h, il donne accès à ce qui a été enregistré pendant l'exécution
+ * de la bibliothèque sur un ordinateur. Ici, ce sont des fonctions et le type des
+ * événements enregistrés.
+ */
+
+
+# ifndef TORTUINO_MATERIEL_HOTE_h
+#	define TORTUINO_MATERIEL_HOTE_h
+
+#	include <stdint.h>
+#	include <vector>
+#	include "TortuinoMateriel.h"
+
+	const unsigned char	EVENEMENT_PAS_GAUCHE	=	0;
+	const unsigned char	EVENEMENT_PAS_DROITE	=	1;
+	const unsigned char	EVENEMENT_FEUTRE		=	2;
+
+	struct Evenement {
+		uint64_t instant;
+		unsigned char type;
+		signed char valeur;
+	};
+
+	void hoteEnregistrer(bool actif);
+	void hoteObserver(void (*observateur)(const Evenement &evenement));
+	void hoteEffacer();
+	const std::vector<Evenement> &hoteEvenements();
+	uint64_t hoteInstant();
+	void hoteSerieEnvoyer(unsigned char octet);
+	int hoteSerieRecevoir();
+	void hoteBouton(bool appuye);
+
+# endif
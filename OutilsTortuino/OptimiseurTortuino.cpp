@@ -0,0 +1,126 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include "Tortuino.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoMesures.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Parcours.h"
+
+
+/**
+ * @file OptimiseurTortuino.cpp
+ * @brief Ce programme réordonne les traits d'un dessin et en écrit le code plus rapide à tracer.
+ * @version 1.0
+ *
+ * Le programme optimiseurTortuino exécute un des dessins de TortuinoDessins.h sur l'ordinateur en
+ * capturant ses traits, en retire les morceaux qui repassent sur de l'encre déjà posée et
+ * réordonne les autres grâce à Parcours.cpp, puis écrit sur la sortie standard le code Arduino
+ * qui les trace dans ce nouvel ordre. Ce code peut être collé tel quel dans la fonction `setup()`
+ * d'un croquis. Le nouvel ordre est aussi exécuté sur l'ordinateur, et les deux exécutions sont
+ * comparées sur la sortie d'erreur :
+ *
+ * {@code
+ * 	./optimiseurTortuino triangleSierpinski 6 20 > sierpinski.ino
+ * }
+ *
+ * Les paramètres qui ne sont pas donnés prennent la valeur par défaut de la table de Figures.cpp.
+ */
+
+
+
+unsigned long	basculesFeutre	=	0;				/**< Le nombre de mouvements du feutre de l'exécution en cours. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui compte les mouvements du feutre.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	if (evenement.type == EVENEMENT_FEUTRE) {
+		basculesFeutre++;
+	}
+}
+
+/**
+ * Affiche sur la sortie d'erreur le bilan d'une exécution.
+ *
+ * @param nom   Le nom de l'exécution.
+ * @param debut L'instant de son début selon hoteInstant().
+ */
+void afficherBilan(const char *nom, uint64_t debut) {
+	fprintf(stderr, "%-10s %10.2f cm levé %10.2f cm baissé %8lu mouvements du feutre %10.2f s\n", nom,
+		mesures.distanceLevee, mesures.distanceBaissee, basculesFeutre, (double)(hoteInstant() - debut) / FREQUENCE_MOTEURS);
+}
+
+/**
+ * Remet à zéro les mesures avant une exécution.
+ *
+ * @return L'instant du début de l'exécution.
+ */
+uint64_t demarrer() {
+	initialiser();
+	mesuresEffacer();
+	basculesFeutre = 0;
+	return hoteInstant();
+}
+
+int main(int argc, char **argv) {
+	const Figure *figure = argc > 1 ? figureTrouver(argv[1]) : NULL;
+	if (figure == NULL) {
+		fprintf(stderr, "Usage : %s dessin [paramètres...]\n", argv[0]);
+		return 1;
+	}
+
+	float parametres[NB_MAX_PARAMETRES];
+	for (int i = 0; i < NB_MAX_PARAMETRES; i++) {
+		parametres[i] = i + 2 < argc ? atof(argv[i + 2]) : figure->parametresDefaut[i];
+	}
+
+	hoteEnregistrer(false);
+	hoteObserver(observer);
+
+	uint64_t debut = demarrer();										// Exécution et capture du dessin original.
+	parcoursCapturer(true);
+	figure->tracer(parametres);
+	terminer();
+	parcoursCapturer(false);
+	afficherBilan("original", debut);
+
+	std::vector<Trait> neufs = parcoursSansRepasses(parcoursTraits());
+	fprintf(stderr, "%.2f cm de repasses retirés\n", parcoursBilan(parcoursTraits()).distanceBaissee - parcoursBilan(neufs).distanceBaissee);
+
+	std::vector<Trait> ordonnes = parcoursOrdonner(neufs);
+	std::vector<Commande> commandes = parcoursCommandes(ordonnes);
+	BilanParcours bilan = parcoursBilan(ordonnes);
+	fprintf(stderr, "%lu traits, %d levers du feutre prévus\n", (unsigned long)ordonnes.size(), bilan.nbLevers);
+
+	debut = demarrer();													// Exécution du nouvel ordre,
+	commandesOuvrir();													// avec la même anticipation que les dessins.
+	printf("// %s réordonné par optimiseurTortuino.\n", figure->nom);
+	for (size_t i = 0; i < commandes.size(); i++) {
+		switch (commandes[i].type) {
+			case COMMANDE_AVANCER:
+				printf("avancer(%.3f);\n", commandes[i].valeur);
+				avancer(commandes[i].valeur);
+				break;
+			case COMMANDE_TOURNER:
+				printf("tournerGauche(%.3f);\n", commandes[i].valeur);
+				tournerGauche(commandes[i].valeur);
+				break;
+			case COMMANDE_MONTER_FEUTRE:
+				printf("monterFeutre();\n");
+				monterFeutre();
+				break;
+			case COMMANDE_DESCENDRE_FEUTRE:
+				printf("descendreFeutre();\n");
+				descendreFeutre();
+				break;
+		}
+	}
+	commandesFermer();
+	afficherBilan("réordonné", debut);
+
+	return 0;
+}
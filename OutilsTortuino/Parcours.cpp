@@ -0,0 +1,587 @@
+# include <math.h>
+# include <stdint.h>
+# include <algorithm>
+# include <unordered_map>
+# include "Parcours.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoMesures.h"
+
+
+/**
+ * @file Parcours.cpp
+ * @brief Ce fichier réordonne les traits d'un dessin pour réduire les déplacements feutre levé.
+ * @version 1.0
+ *
+ * Le fichier Parcours.cpp capture un dessin sous la forme de ses traits, c'est-à-dire des lignes
+ * brisées tracées feutre baissé, en suivant la position du robot au fil des commandes exécutées ;
+ * les arcs y sont découpés en cordes de pasAngleArc degrés.
+ * L'ordre dans lequel les dessins récursifs tracent leurs traits est dicté par la récursion et
+ * non par la géométrie : triangleSierpinski() ou flocon() passent ainsi une bonne partie de leur
+ * temps à se replacer feutre levé. parcoursOrdonner() cherche un meilleur ordre, et un meilleur
+ * sens pour chaque trait :
+ * - une première solution est construite en allant toujours au trait le plus proche, par l'une
+ *   ou l'autre de ses extrémités ;
+ * - elle est ensuite améliorée par 2-opt : inverser l'ordre et le sens d'une suite de traits ne
+ *   change que les deux liaisons à ses bords, ce qui se teste en temps constant ;
+ * - les boucles, qui reviennent à leur point de départ, sont enfin commencées par le sommet le
+ *   plus proche de leurs voisines, et le 2-opt est relancé tant que cela améliore le parcours.
+ *
+ * Le coût d'une liaison entre deux traits est la distance à parcourir feutre levé, plus un coût
+ * fixe lorsqu'il faut effectivement lever le feutre : deux traits qui se touchent sont enchaînés
+ * sans le lever. parcoursCommandes() transforme enfin les traits ordonnés en commandes avancer()
+ * et tournerGauche(), en reculant plutôt que de faire demi-tour. Quelques milliers de traits sont
+ * ordonnés en moins d'une seconde.
+ *
+ * Certains dessins repassent aussi sur de l'encre déjà posée : maison() retrace, après sa porte,
+ * le bas qu'elle a déjà tracé, et une étoile tracée par allers et retours depuis son centre
+ * parcourt chaque branche deux fois. parcoursSansRepasses() retire des traits, avant de les
+ * ordonner, les morceaux qui recouvrent un segment déjà tracé : ils ne sont plus parcourus que
+ * feutre levé, et seulement si c'est le plus court chemin vers la suite. Les segments déjà tracés
+ * sont rangés dans une grille dont la taille est bornée par nbMaxEntreesIndex : une fois pleine,
+ * elle est vidée, et seules les repasses proches dans l'ordre du dessin sont alors reconnues.
+ *
+ * @see parcoursOrdonner(const std::vector<Trait> &traits)
+ */
+
+
+
+const double	ecartNegligeable	=	0.01;		/**< En dessous de cette distance en centimètres, deux points sont confondus : c'est moins d'un pas. */
+const double	coutLever			=	2.0;		/**< Le coût en centimètres d'un lever de feutre : à peu près la distance parcourue pendant que le feutre se pose. */
+const int		nbPassesMax			=	100;		/**< Le nombre maximal de passes de 2-opt. */
+const double	pasAngleArc			=	5;			/**< L'angle en degrés de chacune des cordes par lesquelles un arc est capturé. */
+const double	coteCaseIndex		=	1.0;		/**< Le côté en centimètres d'une case de la grille des segments déjà tracés. */
+const size_t	nbMaxEntreesIndex	=	1 << 20;	/**< Le nombre maximal de segments rangés dans les cases de cette grille, en comptant chaque case traversée. */
+
+std::vector<Trait>	traits;							/**< Les traits capturés. */
+bool				traitOuvert		=	false;		/**< Vrai si le dernier trait capturé peut encore être prolongé. */
+bool				feutreLeveCapture	=	false;	/**< La position du feutre pendant la capture. */
+Point				positionCapture;				/**< La position du robot pendant la capture, en centimètres. */
+double				capCapture		=	0;			/**< L'orientation du robot pendant la capture, en degrés vers la gauche depuis l'axe des x. */
+
+
+/**
+ * Calcule la distance entre deux points.
+ *
+ * @param  a Le premier point.
+ * @param  b Le second point.
+ * @return   La distance en centimètres.
+ */
+double distance(const Point &a, const Point &b) {
+	return hypot(a.x - b.x, a.y - b.y);
+}
+
+/**
+ * Calcule le coût d'une liaison feutre levé entre deux points.
+ *
+ * @param  a Le point de départ.
+ * @param  b Le point d'arrivée.
+ * @return   La distance, plus coutLever si les deux points ne sont pas confondus.
+ */
+double coutLiaison(const Point &a, const Point &b) {
+	double d = distance(a, b);
+	return d < ecartNegligeable ? d : d + coutLever;
+}
+
+/**
+ * L'observateur des commandes exécutées, qui suit la position du robot et construit les traits.
+ *
+ * @param commande La commande qui vient d'être exécutée.
+ */
+void capturer(const Commande &commande) {
+	switch (commande.type) {
+		case COMMANDE_AVANCER:
+			if (!feutreLeveCapture && !traitOuvert) {					// Un tracé commence un nouveau trait
+				traits.push_back(Trait(1, positionCapture));			// s'il n'en prolonge pas un.
+				traitOuvert = true;
+			}
+			positionCapture.x += commande.valeur * cos(capCapture * M_PI / 180);
+			positionCapture.y += commande.valeur * sin(capCapture * M_PI / 180);
+			if (!feutreLeveCapture) {
+				traits.back().push_back(positionCapture);
+			}
+			break;
+		case COMMANDE_TOURNER:
+			capCapture += commande.valeur;								// Une rotation ne fait qu'ajouter un sommet au trait.
+			break;
+		case COMMANDE_ARC:
+			if (!feutreLeveCapture && !traitOuvert) {
+				traits.push_back(Trait(1, positionCapture));
+				traitOuvert = true;
+			}
+			for (int i = 0, nb = (int)ceil(fabs(commande.valeur) / pasAngleArc); i < nb; i++) {	// Un arc est capturé comme une ligne brisée.
+				double pas = commande.valeur / nb;
+				double corde = 2 * commande.rayon * sin(fabs(pas) * M_PI / 360);
+				capCapture += pas / 2;
+				positionCapture.x += corde * cos(capCapture * M_PI / 180);
+				positionCapture.y += corde * sin(capCapture * M_PI / 180);
+				capCapture += pas / 2;
+				if (!feutreLeveCapture) {
+					traits.back().push_back(positionCapture);
+				}
+			}
+			break;
+		case COMMANDE_MONTER_FEUTRE:
+			feutreLeveCapture = true;
+			traitOuvert = false;
+			break;
+		case COMMANDE_DESCENDRE_FEUTRE:
+			feutreLeveCapture = false;
+			break;
+	}
+}
+
+/**
+ * Démarre ou arrête la capture des traits. Au démarrage, les traits précédents sont oubliés et
+ * le robot est considéré comme étant à l'origine, tourné vers l'axe des x.
+ *
+ * @param actif Vrai pour démarrer la capture, faux pour l'arrêter.
+ */
+void parcoursCapturer(bool actif) {
+	if (actif) {
+		traits.clear();
+		traitOuvert = false;
+		feutreLeveCapture = feutreEstLeve();
+		positionCapture.x = 0;
+		positionCapture.y = 0;
+		capCapture = 0;
+	}
+
+	mesures.observateur = actif ? capturer : NULL;
+}
+
+/**
+ * Donne les traits capturés.
+ *
+ * @return Les traits, dans l'ordre où ils ont été tracés.
+ */
+const std::vector<Trait> &parcoursTraits() {
+	return traits;
+}
+
+/**
+ * La grille des segments déjà tracés, qui permet de reconnaître les repasses.
+ */
+struct IndexSegments {
+	std::vector<Point> extremites;										/**< Les deux extrémités de chaque segment rangé, à la suite. */
+	std::unordered_map<int64_t, std::vector<int> > cases;				/**< Pour chaque case, le numéro de chaque segment qui la traverse. */
+	size_t nbEntrees;													/**< Le nombre de numéros rangés dans l'ensemble des cases. */
+};
+
+/**
+ * Calcule la clé de la case de la grille des segments qui contient un point, ou d'une voisine.
+ *
+ * @param  p  Le point.
+ * @param  dx Le décalage en cases selon l'axe des x.
+ * @param  dy Le décalage en cases selon l'axe des y.
+ * @return    La clé de la case.
+ */
+int64_t caseIndex(const Point &p, int dx, int dy) {
+	int64_t x = (int64_t)floor(p.x / coteCaseIndex) + dx, y = (int64_t)floor(p.y / coteCaseIndex) + dy;
+	return (x << 32) ^ (y & 0xFFFFFFFF);
+}
+
+/**
+ * Range un segment tracé dans la grille : il est échantillonné tous les demi-côtés de case, et
+ * inscrit dans les cases de ses échantillons. La grille est d'abord vidée si elle est pleine.
+ *
+ * @param index La grille.
+ * @param a     La première extrémité du segment.
+ * @param b     La seconde.
+ */
+void indexer(IndexSegments &index, const Point &a, const Point &b) {
+	if (index.nbEntrees >= nbMaxEntreesIndex) {
+		index.extremites.clear();
+		index.cases.clear();
+		index.nbEntrees = 0;
+	}
+
+	int numero = index.extremites.size() / 2;
+	index.extremites.push_back(a);
+	index.extremites.push_back(b);
+	int nb = (int)ceil(distance(a, b) / (coteCaseIndex / 2));
+	for (int k = 0; k <= nb; k++) {
+		Point p = {a.x + (b.x - a.x) * k / (nb > 0 ? nb : 1), a.y + (b.y - a.y) * k / (nb > 0 ? nb : 1)};
+		std::vector<int> &segments = index.cases[caseIndex(p, 0, 0)];
+		if (segments.empty() || segments.back() != numero) {
+			segments.push_back(numero);
+			index.nbEntrees++;
+		}
+	}
+}
+
+/**
+ * Cherche les morceaux d'un segment qui ne recouvrent aucun segment de la grille. Seuls comptent
+ * les segments rangés portés par la même droite, à ecartNegligeable près, dans les cases voisines
+ * de celles que traverse le segment ; les morceaux plus courts que ecartNegligeable sont ignorés.
+ *
+ * @param  index La grille des segments déjà tracés.
+ * @param  a     La première extrémité du segment, qui doit être plus long que ecartNegligeable.
+ * @param  b     La seconde.
+ * @return       Le début et la fin de chaque morceau neuf, en centimètres depuis a et dans l'ordre.
+ */
+std::vector<std::pair<double, double> > morceauxNeufs(const IndexSegments &index, const Point &a, const Point &b) {
+	double longueur = distance(a, b);
+	Point u = {(b.x - a.x) / longueur, (b.y - a.y) / longueur};
+
+	std::vector<int> voisins;
+	int nb = (int)ceil(longueur / (coteCaseIndex / 2));
+	for (int k = 0; k <= nb; k++) {
+		Point p = {a.x + u.x * longueur * k / nb, a.y + u.y * longueur * k / nb};
+		for (int dx = -1; dx <= 1; dx++) {
+			for (int dy = -1; dy <= 1; dy++) {
+				std::unordered_map<int64_t, std::vector<int> >::const_iterator voisine = index.cases.find(caseIndex(p, dx, dy));
+				if (voisine != index.cases.end()) {
+					voisins.insert(voisins.end(), voisine->second.begin(), voisine->second.end());
+				}
+			}
+		}
+	}
+	std::sort(voisins.begin(), voisins.end());
+	voisins.erase(std::unique(voisins.begin(), voisins.end()), voisins.end());
+
+	std::vector<std::pair<double, double> > couverts;					// Les morceaux recouverts, en centimètres depuis a.
+	for (size_t s = 0; s < voisins.size(); s++) {
+		const Point &c = index.extremites[2 * voisins[s]], &d = index.extremites[2 * voisins[s] + 1];
+		if (fabs(u.x * (c.y - a.y) - u.y * (c.x - a.x)) >= ecartNegligeable || fabs(u.x * (d.y - a.y) - u.y * (d.x - a.x)) >= ecartNegligeable) {
+			continue;													// Le segment n'est pas sur la même droite.
+		}
+		double tc = u.x * (c.x - a.x) + u.y * (c.y - a.y), td = u.x * (d.x - a.x) + u.y * (d.y - a.y);
+		couverts.push_back(std::make_pair(fmin(tc, td), fmax(tc, td)));
+	}
+	std::sort(couverts.begin(), couverts.end());
+
+	std::vector<std::pair<double, double> > neufs;
+	double debut = 0;
+	for (size_t i = 0; i < couverts.size() && debut < longueur; i++) {
+		double fin = fmin(couverts[i].first, longueur);
+		if (fin - debut >= ecartNegligeable) {
+			neufs.push_back(std::make_pair(debut, fin));
+		}
+		debut = fmax(debut, couverts[i].second);
+	}
+	if (longueur - debut >= ecartNegligeable) {
+		neufs.push_back(std::make_pair(debut, longueur));
+	}
+
+	return neufs;
+}
+
+/**
+ * Retire des traits les morceaux qui repassent sur un segment déjà tracé, dans l'ordre du dessin.
+ * Un trait dont un morceau est retiré est coupé en deux ; un trait entièrement recouvert
+ * disparaît. L'encre posée reste la même, mais le robot n'a plus à parcourir les morceaux retirés
+ * que feutre levé, lorsque parcoursOrdonner() y trouve le chemin le plus court.
+ *
+ * @param  traits Les traits, dans l'ordre où ils ont été tracés.
+ * @return        Les morceaux de traits neufs, dans le même ordre.
+ */
+std::vector<Trait> parcoursSansRepasses(const std::vector<Trait> &traits) {
+	IndexSegments index;
+	index.nbEntrees = 0;
+	std::vector<Trait> resultat;
+
+	for (size_t t = 0; t < traits.size(); t++) {
+		bool ouvert = false;											// Vrai si le dernier trait du résultat s'arrête là où en est ce trait.
+
+		for (size_t p = 1; p < traits[t].size(); p++) {
+			const Point &a = traits[t][p - 1], &b = traits[t][p];
+			double longueur = distance(a, b);
+			if (longueur < ecartNegligeable) {							// Un segment trop court pour être comparé
+				if (ouvert) {											// n'est gardé que pour ne pas couper un trait.
+					resultat.back().push_back(b);
+				}
+				continue;
+			}
+
+			std::vector<std::pair<double, double> > neufs = morceauxNeufs(index, a, b);
+			for (size_t i = 0; i < neufs.size(); i++) {
+				Point debut = {a.x + (b.x - a.x) * neufs[i].first / longueur, a.y + (b.y - a.y) * neufs[i].first / longueur};
+				Point fin = {a.x + (b.x - a.x) * neufs[i].second / longueur, a.y + (b.y - a.y) * neufs[i].second / longueur};
+				if (!ouvert || neufs[i].first >= ecartNegligeable) {
+					resultat.push_back(Trait(1, debut));
+				}
+				resultat.back().push_back(fin);
+			}
+			ouvert = !neufs.empty() && neufs.back().second > longueur - ecartNegligeable;
+			indexer(index, a, b);
+		}
+	}
+
+	return resultat;
+}
+
+/**
+ * Indique si un trait est une boucle, qui revient à son point de départ. Une boucle peut être
+ * tracée en partant de n'importe lequel de ses sommets.
+ *
+ * @param  trait Le trait.
+ * @return       Vrai si ses deux extrémités sont confondues.
+ */
+bool estBoucle(const Trait &trait) {
+	return trait.size() > 2 && distance(trait.front(), trait.back()) < ecartNegligeable;
+}
+
+/**
+ * Donne un trait tel qu'il sera tracé : en partant du sommet d'entrée pour une boucle, et dans
+ * le sens inverse si demandé.
+ *
+ * @param  trait   Le trait d'origine.
+ * @param  entree  L'indice du sommet de départ d'une boucle, 0 pour un trait ouvert.
+ * @param  inverse Vrai pour tracer le trait dans l'autre sens.
+ * @return         Le trait à tracer.
+ */
+Trait orienter(const Trait &trait, int entree, bool inverse) {
+	Trait resultat;
+	if (entree == 0) {
+		resultat = trait;
+	}
+	else {																// Une boucle tournée : son dernier sommet est confondu avec le premier.
+		resultat.insert(resultat.end(), trait.begin() + entree, trait.end() - 1);
+		resultat.insert(resultat.end(), trait.begin(), trait.begin() + entree + 1);
+	}
+	if (inverse) {
+		std::reverse(resultat.begin(), resultat.end());
+	}
+
+	return resultat;
+}
+
+/**
+ * Cherche le sommet d'une boucle par lequel y entrer et en sortir au moindre coût.
+ *
+ * @param  trait   La boucle.
+ * @param  avant   Le point d'où l'on vient.
+ * @param  apres   Le point où l'on va ensuite, ou `NULL` si la boucle est le dernier trait.
+ * @return         L'indice du meilleur sommet.
+ */
+int meilleureEntree(const Trait &trait, const Point &avant, const Point *apres) {
+	int meilleur = 0;
+	double meilleurCout = 0;
+
+	for (size_t v = 0; v + 1 < trait.size(); v++) {
+		double cout = coutLiaison(avant, trait[v]) + (apres != NULL ? coutLiaison(trait[v], *apres) : 0);
+		if (v == 0 || cout < meilleurCout) {
+			meilleur = v;
+			meilleurCout = cout;
+		}
+	}
+
+	return meilleur;
+}
+
+/**
+ * Cherche un ordre et un sens des traits qui réduit les déplacements feutre levé, en partant de
+ * l'origine. Les boucles, comme les triangles de triangleSierpinski(), peuvent en plus être
+ * commencées par n'importe lequel de leurs sommets.
+ *
+ * @param  traits Les traits à ordonner.
+ * @return        Les mêmes traits, réordonnés et éventuellement inversés ou tournés.
+ */
+std::vector<Trait> parcoursOrdonner(const std::vector<Trait> &traits) {
+	int nb = traits.size();
+	std::vector<int> ordre, entree;
+	std::vector<bool> inverse;
+	std::vector<bool> place(nb, false);
+	Point origine = {0, 0};
+	Point position = origine;
+
+	for (int k = 0; k < nb; k++) {										// Construction gloutonne : le trait le plus proche.
+		int meilleur = -1, meilleureEntreeTrait = 0;
+		bool meilleurInverse = false;
+		double meilleurCout = 0;
+
+		for (int t = 0; t < nb; t++) {
+			if (place[t]) {
+				continue;
+			}
+
+			int v = estBoucle(traits[t]) ? meilleureEntree(traits[t], position, NULL) : 0;
+			double coutDebut = coutLiaison(position, traits[t][v]);
+			double coutFin = coutLiaison(position, traits[t].back());
+			if (meilleur < 0 || coutDebut < meilleurCout) {
+				meilleur = t;
+				meilleureEntreeTrait = v;
+				meilleurInverse = false;
+				meilleurCout = coutDebut;
+			}
+			if (v == 0 && coutFin < meilleurCout) {
+				meilleur = t;
+				meilleureEntreeTrait = 0;
+				meilleurInverse = true;
+				meilleurCout = coutFin;
+			}
+		}
+
+		place[meilleur] = true;
+		ordre.push_back(meilleur);
+		entree.push_back(meilleureEntreeTrait);
+		inverse.push_back(meilleurInverse);
+		position = meilleurInverse ? traits[meilleur].front() : meilleureEntreeTrait > 0 ? traits[meilleur][meilleureEntreeTrait] : traits[meilleur].back();
+	}
+
+	std::vector<Point> debuts(nb), fins(nb);							// Les extrémités de chaque trait dans l'ordre courant.
+	for (int k = 0; k < nb; k++) {
+		const Trait &trait = traits[ordre[k]];
+		if (entree[k] > 0) {
+			debuts[k] = fins[k] = trait[entree[k]];
+		}
+		else {
+			debuts[k] = inverse[k] ? trait.back() : trait.front();
+			fins[k] = inverse[k] ? trait.front() : trait.back();
+		}
+	}
+
+	bool ameliore = true;
+	for (int passe = 0; ameliore && passe < nbPassesMax; passe++) {
+		ameliore = false;
+
+		for (int i = 0; i < nb; i++) {									// Amélioration par 2-opt.
+			const Point &avant = i == 0 ? origine : fins[i - 1];
+			double coutAvant = coutLiaison(avant, debuts[i]);
+
+			for (int j = i; j < nb; j++) {								// Inverser les traits de i à j ne change que deux liaisons.
+				double gain = coutAvant - coutLiaison(avant, fins[j]);
+				if (j + 1 < nb) {
+					gain += coutLiaison(fins[j], debuts[j + 1]) - coutLiaison(debuts[i], debuts[j + 1]);
+				}
+
+				if (gain > 1e-9) {
+					std::reverse(ordre.begin() + i, ordre.begin() + j + 1);
+					std::reverse(entree.begin() + i, entree.begin() + j + 1);
+					std::reverse(inverse.begin() + i, inverse.begin() + j + 1);
+					std::reverse(debuts.begin() + i, debuts.begin() + j + 1);
+					std::reverse(fins.begin() + i, fins.begin() + j + 1);
+					for (int k = i; k <= j; k++) {
+						inverse[k] = !inverse[k];
+						std::swap(debuts[k], fins[k]);
+					}
+					coutAvant = coutLiaison(avant, debuts[i]);
+					ameliore = true;
+				}
+			}
+		}
+
+		for (int k = 0; k < nb; k++) {									// Puis chaque boucle est réouverte au meilleur sommet
+			const Trait &trait = traits[ordre[k]];						// compte tenu de ses nouveaux voisins.
+			if (!estBoucle(trait)) {
+				continue;
+			}
+
+			int v = meilleureEntree(trait, k == 0 ? origine : fins[k - 1], k + 1 < nb ? &debuts[k + 1] : NULL);
+			if (distance(trait[v], debuts[k]) >= ecartNegligeable) {
+				entree[k] = v;
+				debuts[k] = fins[k] = trait[v];
+				ameliore = true;
+			}
+		}
+	}
+
+	std::vector<Trait> resultat;
+	for (int k = 0; k < nb; k++) {
+		resultat.push_back(orienter(traits[ordre[k]], entree[k], inverse[k]));
+	}
+
+	return resultat;
+}
+
+/**
+ * Ajoute les commandes qui amènent le robot d'une position à un point, en tournant le moins
+ * possible : au-delà d'un quart de tour, il vaut mieux reculer.
+ *
+ * @param commandes Les commandes auxquelles ajouter le déplacement.
+ * @param position  La position du robot, mise à jour.
+ * @param cap       L'orientation du robot en degrés, mise à jour.
+ * @param cible     Le point à atteindre.
+ */
+void allerVers(std::vector<Commande> &commandes, Point &position, double &cap, const Point &cible) {
+	double longueur = distance(position, cible);
+	if (longueur < ecartNegligeable / 10) {
+		return;
+	}
+
+	double rotation = atan2(cible.y - position.y, cible.x - position.x) * 180 / M_PI - cap;
+	rotation -= 360 * floor((rotation + 180) / 360);					// On ramène la rotation entre -180 et 180 degrés,
+	if (fabs(rotation) > 90) {											// puis entre -90 et 90 en reculant si nécessaire.
+		rotation -= rotation > 0 ? 180 : -180;
+		longueur = -longueur;
+	}
+
+	Commande commande;
+	commande.feutreLeve = false;
+	if (fabs(rotation) > 1e-6) {
+		commande.type = COMMANDE_TOURNER;
+		commande.valeur = rotation;
+		commandes.push_back(commande);
+		cap += rotation;
+	}
+	commande.type = COMMANDE_AVANCER;
+	commande.valeur = longueur;
+	commandes.push_back(commande);
+	position = cible;
+}
+
+/**
+ * Transforme des traits en commandes qui les tracent dans l'ordre, en partant de l'origine,
+ * tourné vers l'axe des x et feutre baissé.
+ *
+ * @param  traits Les traits à tracer.
+ * @return        Les commandes, de types COMMANDE_AVANCER, COMMANDE_TOURNER, COMMANDE_MONTER_FEUTRE
+ *                et COMMANDE_DESCENDRE_FEUTRE.
+ */
+std::vector<Commande> parcoursCommandes(const std::vector<Trait> &traits) {
+	std::vector<Commande> commandes;
+	Point position = {0, 0};
+	double cap = 0;
+	bool leve = false;
+	Commande feutre;
+	feutre.valeur = 0;
+
+	for (size_t t = 0; t < traits.size(); t++) {
+		const Trait &trait = traits[t];
+
+		if (distance(position, trait.front()) >= ecartNegligeable) {	// Il faut rejoindre le trait feutre levé.
+			if (!leve) {
+				feutre.type = COMMANDE_MONTER_FEUTRE;
+				feutre.feutreLeve = leve = true;
+				commandes.push_back(feutre);
+			}
+			allerVers(commandes, position, cap, trait.front());
+		}
+		if (leve) {
+			feutre.type = COMMANDE_DESCENDRE_FEUTRE;
+			feutre.feutreLeve = leve = false;
+			commandes.push_back(feutre);
+		}
+
+		for (size_t p = 1; p < trait.size(); p++) {
+			allerVers(commandes, position, cap, trait[p]);
+		}
+	}
+
+	return commandes;
+}
+
+/**
+ * Calcule ce que coûte le tracé de traits dans l'ordre donné, en partant de l'origine.
+ *
+ * @param  traits Les traits dans l'ordre où ils seront tracés.
+ * @return        Les distances parcourues feutre levé et baissé, et le nombre de levers du feutre.
+ */
+BilanParcours parcoursBilan(const std::vector<Trait> &traits) {
+	BilanParcours bilan = {0, 0, 0};
+	Point position = {0, 0};
+
+	for (size_t t = 0; t < traits.size(); t++) {
+		double ecart = distance(position, traits[t].front());
+		if (ecart >= ecartNegligeable) {
+			bilan.distanceLevee += ecart;
+			bilan.nbLevers++;
+		}
+		for (size_t p = 1; p < traits[t].size(); p++) {
+			bilan.distanceBaissee += distance(traits[t][p - 1], traits[t][p]);
+		}
+		position = traits[t].back();
+	}
+
+	return bilan;
+}
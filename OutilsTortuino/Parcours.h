@@ -0,0 +1,38 @@
+/**
+ * @file Parcours.h
+ * @brief Définition des fonctions implémentées dans Parcours.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de Parcours.cpp. Il permet de préciser ce
+ * qui sera rendu accessible aux outils. Ici, ce sont des fonctions et les types
+ * des traits capturés.
+ */
+
+
+# ifndef TORTUINO_PARCOURS_h
+#	define TORTUINO_PARCOURS_h
+
+#	include <vector>
+#	include "TortuinoCommandes.h"
+
+	struct Point {
+		double x;
+		double y;
+	};
+
+	typedef std::vector<Point> Trait;
+
+	struct BilanParcours {
+		double distanceLevee;
+		double distanceBaissee;
+		int nbLevers;
+	};
+
+	void parcoursCapturer(bool actif);
+	const std::vector<Trait> &parcoursTraits();
+	std::vector<Trait> parcoursSansRepasses(const std::vector<Trait> &traits);
+	std::vector<Trait> parcoursOrdonner(const std::vector<Trait> &traits);
+	std::vector<Commande> parcoursCommandes(const std::vector<Trait> &traits);
+	BilanParcours parcoursBilan(const std::vector<Trait> &traits);
+
+# endif
@@ -0,0 +1,250 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+# include <time.h>
+# include <string>
+# include "Tortuino.h"
+# include "TortuinoFeutre.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Rendu.h"
+
+
+/**
+ * @file RegressionTortuino.cpp
+ * @brief Ce programme vérifie que les dessins tracent toujours la même chose que leurs références.
+ * @version 1.0
+ *
+ * Le programme regressionTortuino exécute sans robot les dessins de TortuinoDessins.h, reconstruit
+ * grâce à Rendu.cpp ce que chacun trace feutre baissé, et le compare au tracé de référence
+ * enregistré pour lui. Deux tracés sont égaux si aucun point de l'un n'est à plus de la tolérance
+ * d'un trait de l'autre : l'ordre des traits, leur sens ou le découpage des mouvements peuvent
+ * donc changer, mais pas le dessin sur la feuille. Les options sont :
+ *
+ * {@code
+ * 	./regressionTortuino [-d dossier] [-t tolerance] [-r 1] [-n niveauMax] [-m pasMax] [dessin...]
+ * }
+ *
+ * Chaque dessin a sa référence dans un fichier texte du dossier donné, OutilsTortuino/References
+ * par défaut, qui contient les traits de chacune des valeurs de son balayage de Figures.cpp.
+ * Sans l'option `-r 1`, toutes les valeurs qu'il contient sont vérifiées, avec une tolérance de
+ * 0,05 cm par défaut, et le programme se termine en erreur si un dessin a changé. Avec `-r 1`,
+ * les références des dessins donnés, ou de tous, sont réécrites : le balayage s'arrête au niveau
+ * maximal, quinze par défaut, ou dès qu'une exécution dépasse pasMax pas, deux millions par
+ * défaut, pour que la vérification complète ne prenne que quelques secondes.
+ */
+
+
+
+const char	*dossierDefaut	=	"OutilsTortuino/References";	/**< Le dossier des références, depuis la racine du dépôt. */
+
+unsigned long long	pasExecution	=	0;		/**< Le nombre de pas faits par les deux roues pendant l'exécution en cours. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui reconstruit les traits et compte les pas.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	if (evenement.type != EVENEMENT_FEUTRE) {
+		pasExecution++;
+	}
+	renduEvenement(evenement);
+}
+
+/**
+ * Exécute un dessin une fois en reconstruisant ses traits.
+ *
+ * @param  figure     Le dessin à exécuter.
+ * @param  parametres Ses paramètres.
+ * @return            Les traits tracés.
+ */
+const std::vector<Trait> &executer(const Figure &figure, const float *parametres) {
+	initialiser();														// Le robot repart du même état à chaque exécution.
+	renduDemarrer(feutreEstLeve());
+	pasExecution = 0;
+	figure.tracer(parametres);
+	terminer();
+
+	return renduTraits();
+}
+
+/**
+ * Écrit les paramètres d'une exécution, tels qu'ils apparaissent dans les références.
+ *
+ * @param  figure     Le dessin.
+ * @param  parametres Ses paramètres.
+ * @return            Les paramètres séparés par des espaces.
+ */
+std::string ecrireParametres(const Figure &figure, const float *parametres) {
+	std::string texte;
+	char nombre[32];
+	for (int i = 0; i < figure.nbParametres; i++) {
+		snprintf(nombre, sizeof(nombre), i == 0 ? "%g" : " %g", parametres[i]);
+		texte += nombre;
+	}
+
+	return texte;
+}
+
+/**
+ * Réécrit la référence d'un dessin en parcourant son balayage.
+ *
+ * @param  figure    Le dessin.
+ * @param  balayage  Son balayage.
+ * @param  chemin    Le chemin du fichier de référence.
+ * @param  niveauMax Le niveau maximal des dessins récursifs.
+ * @param  pasMax    Le nombre de pas au-delà duquel le balayage s'arrête.
+ * @return           Vrai si la référence a pu être écrite.
+ */
+bool enregistrer(const Figure &figure, const Balayage &balayage, const char *chemin, int niveauMax, unsigned long long pasMax) {
+	FILE *fichier = fopen(chemin, "w");
+	if (fichier == NULL) {
+		return false;
+	}
+
+	float parametres[NB_MAX_PARAMETRES];
+	memcpy(parametres, figure.parametresDefaut, sizeof(parametres));
+	float fin = figure.nbParametres == 0 ? balayage.debut : balayage.fin == 0 ? niveauMax : balayage.fin;
+
+	for (float valeur = balayage.debut; valeur <= fin; valeur += balayage.pas) {
+		parametres[0] = valeur;
+		const std::vector<Trait> &traits = executer(figure, parametres);
+		fprintf(fichier, "parametres %s\n", ecrireParametres(figure, parametres).c_str());
+		renduEcrire(fichier, traits);
+		printf("%s %s : %lu traits enregistrés\n", figure.nom, ecrireParametres(figure, parametres).c_str(), (unsigned long)traits.size());
+
+		if (pasExecution > pasMax) {									// Le suivant serait encore plus long à vérifier.
+			break;
+		}
+	}
+
+	return fclose(fichier) == 0;
+}
+
+/**
+ * Vérifie un dessin pour chacune des valeurs de sa référence.
+ *
+ * @param  figure    Le dessin.
+ * @param  chemin    Le chemin du fichier de référence.
+ * @param  tolerance L'écart maximal accepté, en centimètres.
+ * @return           Le nombre de valeurs dont le tracé a changé, ou 1 si la référence est
+ * 					 illisible.
+ */
+int verifier(const Figure &figure, const char *chemin, double tolerance) {
+	FILE *fichier = fopen(chemin, "r");
+	if (fichier == NULL) {
+		printf("%s : pas de référence dans %s\n", figure.nom, chemin);
+		return 1;
+	}
+
+	int nbDifferences = 0;
+	char ligne[256];
+	std::vector<Trait> references;
+	while (fgets(ligne, sizeof(ligne), fichier) != NULL) {
+		if (strncmp(ligne, "parametres", 10) != 0) {
+			continue;
+		}
+
+		float parametres[NB_MAX_PARAMETRES];							// Les paramètres absents de la référence gardent leur valeur par défaut.
+		memcpy(parametres, figure.parametresDefaut, sizeof(parametres));
+		char *lecture = ligne + 10;
+		for (int i = 0; i < figure.nbParametres; i++) {
+			parametres[i] = strtof(lecture, &lecture);
+		}
+		if (!renduLire(fichier, references)) {
+			printf("%s : référence illisible dans %s\n", figure.nom, chemin);
+			fclose(fichier);
+			return nbDifferences + 1;
+		}
+
+		double ecart = renduEcart(executer(figure, parametres), references, tolerance);
+		bool identique = ecart <= tolerance;
+		nbDifferences += identique ? 0 : 1;
+		if (ecart == HUGE_VAL) {
+			printf("%s %s : DIFFÉRENT, écart de plus de %g cm\n", figure.nom, ecrireParametres(figure, parametres).c_str(), 2 * tolerance);
+		}
+		else {
+			printf("%s %s : %s, écart de %.4f cm\n", figure.nom, ecrireParametres(figure, parametres).c_str(), identique ? "identique" : "DIFFÉRENT", ecart);
+		}
+	}
+
+	fclose(fichier);
+	return nbDifferences;
+}
+
+/**
+ * Indique si un dessin fait partie de ceux demandés sur la ligne de commande.
+ *
+ * @param  nom      Le nom du dessin.
+ * @param  demandes Les noms demandés.
+ * @param  nb       Le nombre de noms demandés ; 0 les demande tous.
+ * @return          Vrai si le dessin doit être traité.
+ */
+bool estDemande(const char *nom, char **demandes, int nb) {
+	for (int i = 0; i < nb; i++) {
+		if (strcmp(demandes[i], nom) == 0) {
+			return true;
+		}
+	}
+
+	return nb == 0;
+}
+
+int main(int argc, char **argv) {
+	const char *dossier = dossierDefaut;
+	double tolerance = 0.05;
+	bool reecrire = false;
+	int niveauMax = 15;
+	unsigned long long pasMax = 2000000;
+	int i = 1;
+
+	for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {					// Lecture des options.
+		if (strcmp(argv[i], "-d") == 0) {
+			dossier = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "-t") == 0) {
+			tolerance = atof(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-r") == 0) {
+			reecrire = atoi(argv[i + 1]) != 0;
+		}
+		else if (strcmp(argv[i], "-n") == 0) {
+			niveauMax = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-m") == 0) {
+			pasMax = strtoull(argv[i + 1], NULL, 10);
+		}
+		else {
+			fprintf(stderr, "Usage : %s [-d dossier] [-t tolerance] [-r 1] [-n niveauMax] [-m pasMax] [dessin...]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	hoteEnregistrer(false);												// Les pas sont suivis au fil de l'eau, pas enregistrés.
+	hoteObserver(observer);
+	clock_t debut = clock();
+	int nbDifferences = 0;
+
+	for (int b = 0; b < nbBalayages; b++) {
+		const Balayage &balayage = balayages[b];
+		const Figure *figure = figureTrouver(balayage.nom);
+		if (figure == NULL || !estDemande(balayage.nom, argv + i, argc - i)) {
+			continue;
+		}
+
+		std::string chemin = std::string(dossier) + "/" + figure->nom + ".txt";
+		if (reecrire && !enregistrer(*figure, balayage, chemin.c_str(), niveauMax, pasMax)) {
+			fprintf(stderr, "Impossible d'écrire %s.\n", chemin.c_str());
+			return 1;
+		}
+		else if (!reecrire) {
+			nbDifferences += verifier(*figure, chemin.c_str(), tolerance);
+		}
+	}
+
+	printf("%d différence%s en %.2f s\n", nbDifferences, nbDifferences > 1 ? "s" : "", (double)(clock() - debut) / CLOCKS_PER_SEC);
+	return nbDifferences == 0 ? 0 : 1;
+}
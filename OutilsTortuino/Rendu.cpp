@@ -0,0 +1,738 @@
+# include <math.h>
+# include <stdint.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unordered_map>
+# include "Rendu.h"
+# include "TortuinoOdometrie.h"
+
+
+/**
+ * @file Rendu.cpp
+ * @brief Ce fichier reconstruit le dessin tracé à partir des pas enregistrés, et l'exporte ou le compare.
+ * @version 1.0
+ *
+ * Le fichier Rendu.cpp suit la position du feutre pas après pas, à partir des événements de
+ * MaterielHote.cpp et de la géométrie du robot : chaque pas d'une roue la fait avancer du
+ * périmètre divisé par le nombre de pas par tour. Les deux roues faisant leurs pas dans la même
+ * interruption, les pas d'un même instant sont appliqués ensemble, comme le mouvement d'un robot
+ * à deux roues : le feutre avance de la moitié de la différence des deux roues, et le robot tourne
+ * de leur somme divisée par deux fois le braquage. Appliqués l'un après l'autre, chacun autour de
+ * l'autre roue, deux pas opposés d'une rotation sur place déplaceraient le feutre, et l'erreur
+ * grandirait à chaque virage. Contrairement à
+ * Parcours.cpp, qui suit les commandes, c'est donc bien ce que les moteurs ont fait qui est
+ * reconstruit, avec les arrondis des pas et les coins arrondis du mode continu.<br/>
+ *
+ * Les traits tracés feutre baissé sont simplifiés au fil des pas, pour ne pas garder un sommet
+ * par pas : tant que toutes les positions suivies depuis le dernier sommet restent à moins de
+ * ecartSimplification d'un même segment, seule l'extrémité de ce segment est déplacée. Il suffit
+ * pour cela de garder l'intervalle des directions qui passent à moins de cet écart de chacune
+ * des positions, un fourreau qui se resserre à chaque pas ; lorsque la direction du nouveau pas
+ * en sort, un sommet est ajouté. Une droite de mille pas ne coûte ainsi que deux sommets.<br/>
+ *
+ * Les traits peuvent ensuite être écrits en SVG, dessinés dans une image PNG, enregistrés dans
+ * un fichier texte ou comparés à d'autres traits avec une tolérance géométrique. L'image est
+ * compressée sans bibliothèque, d'une façon simple qui suffit à un dessin au trait : chaque ligne
+ * est écrite comme sa différence avec la précédente, ce qui donne surtout des zéros, et les
+ * répétitions d'un même octet sont codées en une fois avec les codes de Huffman fixes du format
+ * deflate.
+ *
+ * @see renduEvenement(const Evenement &evenement)
+ * @see renduEcart(const std::vector<Trait> &traits, const std::vector<Trait> &references, double tolerance)
+ */
+
+
+
+const double	ecartSimplification	=	0.01;		/**< L'écart maximal en centimètres entre les positions suivies et le trait simplifié : un peu moins d'un pas, plus que le va-et-vient du feutre pendant une rotation. */
+const double	epaisseurFeutre		=	0.05;		/**< L'épaisseur en centimètres du trait du feutre dans les fichiers SVG et PNG. */
+const double	margeImage			=	0.5;		/**< La marge en centimètres laissée autour du dessin dans les fichiers SVG et PNG. */
+const long		nbMaxPixels			=	100000000;	/**< Le nombre maximal de pixels d'une image PNG. */
+const int		longueurMaxRepetition	=	258;	/**< La plus longue répétition que le format deflate sait coder en une fois. */
+
+std::vector<Trait>	traitsRendu;					/**< Les traits reconstruits depuis renduDemarrer(). */
+bool				feutreLeveRendu	=	true;		/**< La position du feutre d'après les événements. */
+Point				positionRendu;					/**< La position du feutre en centimètres. */
+Point				capRendu;						/**< Le vecteur unitaire de l'orientation du robot. */
+double				demiPasRendu	=	0;			/**< L'avance du feutre en centimètres lorsqu'une seule roue fait un pas. */
+double				rotationRendu	=	0;			/**< La rotation du robot en radians lorsque la roue droite fait un pas en avant. */
+Point				rotationPas[3];					/**< Le cosinus et le sinus de la rotation du robot pour zéro, un et deux pas qui tournent à gauche. */
+Point				demiRotationPas[3];				/**< Le cosinus et le sinus de la moitié de ces rotations. */
+uint64_t			instantPas		=	0;			/**< L'instant des pas qui n'ont pas encore été appliqués. */
+int					pasGaucheAttente	=	0;		/**< La somme des pas de la roue gauche à cet instant. */
+int					pasDroiteAttente	=	0;		/**< La somme des pas de la roue droite à cet instant. */
+bool				directionConnue	=	false;		/**< Vrai si le fourreau du segment en cours de simplification est ouvert. */
+Point				fourreauBas;					/**< La direction unitaire qui borne le fourreau dans le sens des aiguilles d'une montre. */
+Point				fourreauHaut;					/**< La direction unitaire qui le borne dans l'autre sens. */
+double				distanceMax		=	0;			/**< La plus grande distance entre le dernier sommet et les positions suivies depuis. */
+
+
+/**
+ * Commence un nouveau trait à la position actuelle du feutre. Ses deux premiers points sont
+ * confondus : le premier est un sommet, le second l'extrémité qui suivra le feutre.
+ */
+void commencerTrait() {
+	traitsRendu.push_back(Trait(2, positionRendu));
+	directionConnue = false;
+	distanceMax = 0;
+}
+
+/**
+ * Calcule le produit vectoriel de deux vecteurs, positif si le second est à gauche du premier.
+ *
+ * @param  a Le premier vecteur.
+ * @param  b Le second vecteur.
+ * @return   Le produit vectoriel.
+ */
+double vectoriel(const Point &a, const Point &b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * Tourne un vecteur d'un angle donné par son cosinus et son sinus.
+ *
+ * @param  v        Le vecteur.
+ * @param  cosinus  Le cosinus de l'angle.
+ * @param  sinus    Le sinus de l'angle, négatif pour tourner vers la droite.
+ * @return          Le vecteur tourné.
+ */
+Point tourner(const Point &v, double cosinus, double sinus) {
+	Point tourne = {v.x * cosinus - v.y * sinus, v.x * sinus + v.y * cosinus};
+	return tourne;
+}
+
+/**
+ * Prolonge le trait en cours jusqu'à la position actuelle du feutre, en déplaçant son extrémité
+ * si le fourreau le permet, et en ajoutant un sommet sinon. Le fourreau est gardé sous la forme
+ * de ses deux directions limites, ce qui évite tout calcul d'angle.
+ */
+void prolongerTrait() {
+	Trait &trait = traitsRendu.back();
+	const Point &sommet = trait[trait.size() - 2];
+	double dx = positionRendu.x - sommet.x, dy = positionRendu.y - sommet.y;
+	double d = sqrt(dx * dx + dy * dy);
+
+	if (d >= distanceMax - ecartSimplification) {						// Un retour en arrière casse toujours le segment.
+		if (d <= ecartSimplification) {									// Trop près du sommet pour avoir une direction.
+			trait.back() = positionRendu;
+			distanceMax = fmax(distanceMax, d);
+			return;
+		}
+
+		Point direction = {dx / d, dy / d};
+		double sinus = ecartSimplification / d, cosinus = sqrt(1 - sinus * sinus);
+		Point bas = tourner(direction, cosinus, -sinus), haut = tourner(direction, cosinus, sinus);
+		if (!directionConnue) {
+			directionConnue = true;
+			fourreauBas = bas;
+			fourreauHaut = haut;
+			distanceMax = d;
+			trait.back() = positionRendu;
+			return;
+		}
+
+		if (vectoriel(fourreauBas, direction) >= 0 && vectoriel(direction, fourreauHaut) >= 0
+				&& direction.x * fourreauBas.x + direction.y * fourreauBas.y > 0) {	// Le fourreau se resserre autour du pas.
+			if (vectoriel(fourreauBas, bas) > 0) {
+				fourreauBas = bas;
+			}
+			if (vectoriel(haut, fourreauHaut) > 0) {
+				fourreauHaut = haut;
+			}
+			distanceMax = fmax(distanceMax, d);
+			trait.back() = positionRendu;
+			return;
+		}
+	}
+
+	trait.push_back(positionRendu);										// L'ancienne extrémité devient un sommet.
+	directionConnue = false;
+	distanceMax = hypot(positionRendu.x - trait[trait.size() - 2].x, positionRendu.y - trait[trait.size() - 2].y);
+}
+
+/**
+ * Applique à une position et à une orientation les pas en attente, comme un seul mouvement : le
+ * feutre avance dans la direction du robot prise à mi-rotation. Les rotations d'un ou deux pas,
+ * les seules que fait l'interruption, sont tournées sans calculer de sinus.
+ *
+ * @param position La position du feutre, déplacée.
+ * @param cap      L'orientation du robot, tournée.
+ */
+void appliquerPas(Point &position, Point &cap) {
+	double avance = (pasDroiteAttente - pasGaucheAttente) * demiPasRendu;	// Les moteurs se font face.
+	int nbPas = pasDroiteAttente + pasGaucheAttente;					// Un pas en avant de la roue droite, ou en arrière de la gauche, tourne à gauche.
+	double sens = nbPas < 0 ? -1 : 1;
+	Point rotation, demiRotation;
+	if (abs(nbPas) <= 2) {
+		rotation = rotationPas[abs(nbPas)];
+		demiRotation = demiRotationPas[abs(nbPas)];
+	} else {
+		rotation.x = cos(abs(nbPas) * rotationRendu);
+		rotation.y = sin(abs(nbPas) * rotationRendu);
+		demiRotation.x = cos(abs(nbPas) * rotationRendu / 2);
+		demiRotation.y = sin(abs(nbPas) * rotationRendu / 2);
+	}
+	Point milieu = tourner(cap, demiRotation.x, sens * demiRotation.y);
+
+	position.x += avance * milieu.x;
+	position.y += avance * milieu.y;
+	cap = tourner(cap, rotation.x, sens * rotation.y);
+}
+
+/**
+ * Applique les pas en attente au feutre, et prolonge le trait en cours s'il est baissé.
+ */
+void terminerPas() {
+	if (pasGaucheAttente == 0 && pasDroiteAttente == 0) {
+		return;
+	}
+
+	appliquerPas(positionRendu, capRendu);
+	pasGaucheAttente = 0;
+	pasDroiteAttente = 0;
+	if (!feutreLeveRendu) {
+		prolongerTrait();
+	}
+}
+
+/**
+ * Oublie les traits reconstruits et place le feutre à l'origine, le robot tourné vers l'axe des x.
+ * Le déplacement que provoque un pas est calculé une fois pour toutes à partir de la géométrie
+ * actuelle du robot.
+ *
+ * @param feutreLeve La position du feutre au départ.
+ */
+void renduDemarrer(bool feutreLeve) {
+	const Geometrie &geometrie = odometrieGeometrie();
+	double pas = geometrie.perimetre / geometrie.pasParTour;			// Un pas fait avancer la roue de cette longueur,
+	rotationRendu = pas / (2 * geometrie.braquage);						// donc tourner le robot autour de l'autre roue.
+	demiPasRendu = pas / 2;
+	for (int n = 0; n < 3; n++) {
+		rotationPas[n].x = cos(n * rotationRendu);
+		rotationPas[n].y = sin(n * rotationRendu);
+		demiRotationPas[n].x = cos(n * rotationRendu / 2);
+		demiRotationPas[n].y = sin(n * rotationRendu / 2);
+	}
+	pasGaucheAttente = 0;
+	pasDroiteAttente = 0;
+
+	traitsRendu.clear();
+	positionRendu.x = 0;
+	positionRendu.y = 0;
+	capRendu.x = 1;
+	capRendu.y = 0;
+	feutreLeveRendu = feutreLeve;
+	if (!feutreLeve) {
+		commencerTrait();
+	}
+}
+
+/**
+ * Suit un événement de MaterielHote.cpp : un pas est mis en attente jusqu'à ce qu'un événement
+ * d'un autre instant arrive, pour être appliqué avec celui de l'autre roue, puis déplace le
+ * feutre et prolonge le trait en cours s'il est baissé ; un mouvement du feutre commence ou
+ * termine un trait. Elle peut être donnée à hoteObserver(), ou appelée par l'observateur d'un
+ * outil.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void renduEvenement(const Evenement &evenement) {
+	if (evenement.instant != instantPas) {
+		terminerPas();
+		instantPas = evenement.instant;
+	}
+
+	if (evenement.type == EVENEMENT_FEUTRE) {
+		terminerPas();													// Le feutre bouge après les pas du même instant.
+		bool leve = evenement.valeur != 0;
+		if (!leve && feutreLeveRendu) {
+			commencerTrait();
+		}
+		feutreLeveRendu = leve;
+	} else if (evenement.type == EVENEMENT_PAS_DROITE) {
+		pasDroiteAttente += evenement.valeur;
+	} else {
+		pasGaucheAttente += evenement.valeur;
+	}
+}
+
+/**
+ * Donne les traits reconstruits, une fois appliqués les derniers pas en attente.
+ *
+ * @return Les traits tracés feutre baissé depuis renduDemarrer(), dans l'ordre où ils l'ont été.
+ */
+const std::vector<Trait> &renduTraits() {
+	terminerPas();
+	return traitsRendu;
+}
+
+/**
+ * Donne la position actuelle du feutre, qu'il soit levé ou baissé. Les pas en attente y sont
+ * comptés sans être appliqués, pour ne pas séparer ceux des deux roues d'un même instant.
+ *
+ * @return La position en centimètres, depuis l'endroit où était le robot à renduDemarrer().
+ */
+Point renduPosition() {
+	Point position = positionRendu, cap = capRendu;
+	appliquerPas(position, cap);
+	return position;
+}
+
+/**
+ * Calcule le rectangle qui contient tous les traits, marge comprise.
+ *
+ * @param traits Les traits.
+ * @param min    Reçoit le coin inférieur gauche.
+ * @param max    Reçoit le coin supérieur droit.
+ */
+void encadrer(const std::vector<Trait> &traits, Point &min, Point &max) {
+	min.x = min.y = HUGE_VAL;
+	max.x = max.y = -HUGE_VAL;
+	for (size_t i = 0; i < traits.size(); i++) {
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			min.x = fmin(min.x, traits[i][j].x);
+			min.y = fmin(min.y, traits[i][j].y);
+			max.x = fmax(max.x, traits[i][j].x);
+			max.y = fmax(max.y, traits[i][j].y);
+		}
+	}
+	if (min.x > max.x) {												// Un dessin vide est un point à l'origine.
+		min.x = min.y = max.x = max.y = 0;
+	}
+
+	min.x -= margeImage;
+	min.y -= margeImage;
+	max.x += margeImage;
+	max.y += margeImage;
+}
+
+/**
+ * Écrit des traits dans un fichier SVG, en centimètres. L'axe des y est retourné pour que le
+ * dessin apparaisse tel qu'il est sur la feuille, vu de dessus.
+ *
+ * @param  nom    Le chemin du fichier à écrire, ou "-" pour la sortie standard.
+ * @param  traits Les traits.
+ * @return        Vrai si le fichier a pu être écrit.
+ */
+bool renduEcrireSvg(const char *nom, const std::vector<Trait> &traits) {
+	FILE *fichier = strcmp(nom, "-") == 0 ? stdout : fopen(nom, "w");
+	if (fichier == NULL) {
+		return false;
+	}
+
+	Point min, max;
+	encadrer(traits, min, max);
+	fprintf(fichier, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	fprintf(fichier, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.2fcm\" height=\"%.2fcm\" viewBox=\"%.3f %.3f %.3f %.3f\">\n",
+		max.x - min.x, max.y - min.y, min.x, -max.y, max.x - min.x, max.y - min.y);
+	fprintf(fichier, "<g fill=\"none\" stroke=\"black\" stroke-width=\"%g\" stroke-linecap=\"round\" stroke-linejoin=\"round\">\n", epaisseurFeutre);
+	for (size_t i = 0; i < traits.size(); i++) {
+		fprintf(fichier, "<polyline points=\"");
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			fprintf(fichier, j == 0 ? "%.3f,%.3f" : " %.3f,%.3f", traits[i][j].x, -traits[i][j].y);
+		}
+		fprintf(fichier, "\"/>\n");
+	}
+	fprintf(fichier, "</g>\n</svg>\n");
+
+	return fichier == stdout ? fflush(fichier) == 0 : fclose(fichier) == 0;
+}
+
+/**
+ * Calcule la distance d'un point à un segment.
+ *
+ * @param  p Le point.
+ * @param  a La première extrémité du segment.
+ * @param  b La seconde extrémité.
+ * @return   La distance en centimètres.
+ */
+double distanceSegment(const Point &p, const Point &a, const Point &b) {
+	double dx = b.x - a.x, dy = b.y - a.y;
+	double longueur = dx * dx + dy * dy;
+	double t = longueur > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / longueur : 0;
+	t = fmin(1, fmax(0, t));
+	return hypot(p.x - a.x - t * dx, p.y - a.y - t * dy);
+}
+
+/**
+ * Dessine un segment dans une image en niveaux de gris, avec un bord lissé : chaque pixel proche
+ * du segment est assombri selon sa distance à celui-ci.
+ *
+ * @param image   Les pixels, ligne par ligne, 255 pour le blanc.
+ * @param largeur La largeur de l'image en pixels.
+ * @param hauteur Sa hauteur en pixels.
+ * @param a       La première extrémité du segment, en pixels.
+ * @param b       La seconde extrémité, en pixels.
+ * @param rayon   La demi-épaisseur du trait, en pixels.
+ */
+void dessinerSegment(std::vector<unsigned char> &image, long largeur, long hauteur, const Point &a, const Point &b, double rayon) {
+	long x0 = (long)floor(fmin(a.x, b.x) - rayon - 1), x1 = (long)ceil(fmax(a.x, b.x) + rayon + 1);
+	long y0 = (long)floor(fmin(a.y, b.y) - rayon - 1), y1 = (long)ceil(fmax(a.y, b.y) + rayon + 1);
+
+	for (long y = y0 < 0 ? 0 : y0; y <= y1 && y < hauteur; y++) {
+		for (long x = x0 < 0 ? 0 : x0; x <= x1 && x < largeur; x++) {
+			Point centre = {x + 0.5, y + 0.5};
+			double couverture = fmin(1, fmax(0, rayon + 0.5 - distanceSegment(centre, a, b)));
+			unsigned char gris = (unsigned char)lround(255 * (1 - couverture));
+			if (gris < image[y * largeur + x]) {
+				image[y * largeur + x] = gris;
+			}
+		}
+	}
+}
+
+/**
+ * Ajoute un entier de 32 bits à des octets, poids fort en premier comme le veut le format PNG.
+ *
+ * @param octets Les octets à compléter.
+ * @param valeur L'entier.
+ */
+void ajouterMot(std::vector<unsigned char> &octets, uint32_t valeur) {
+	for (int decalage = 24; decalage >= 0; decalage -= 8) {
+		octets.push_back((valeur >> decalage) & 0xFF);
+	}
+}
+
+/**
+ * Écrit un bloc d'un fichier PNG : sa taille, son type, ses données et leur CRC-32.
+ *
+ * @param fichier Le fichier PNG.
+ * @param type    Le type du bloc, en quatre lettres.
+ * @param donnees Les données du bloc.
+ */
+void ecrireBlocPng(FILE *fichier, const char *type, const std::vector<unsigned char> &donnees) {
+	std::vector<unsigned char> bloc;
+	ajouterMot(bloc, donnees.size());
+	bloc.insert(bloc.end(), type, type + 4);
+	bloc.insert(bloc.end(), donnees.begin(), donnees.end());
+
+	uint32_t crc = 0xFFFFFFFF;											// Le CRC-32 porte sur le type et les données.
+	for (size_t i = 4; i < bloc.size(); i++) {
+		crc ^= bloc[i];
+		for (int k = 0; k < 8; k++) {
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+		}
+	}
+	ajouterMot(bloc, crc ^ 0xFFFFFFFF);
+
+	fwrite(&bloc[0], 1, bloc.size(), fichier);
+}
+
+/**
+ * Le flux de bits d'un bloc deflate, rempli en commençant par les bits de poids faible.
+ */
+struct FluxBits {
+	std::vector<unsigned char> &octets;
+	uint32_t tampon;
+	int nbBits;
+};
+
+/**
+ * Ajoute des bits au flux, poids faible en premier.
+ *
+ * @param flux   Le flux.
+ * @param valeur Les bits à ajouter.
+ * @param nb     Leur nombre, au plus seize.
+ */
+void ecrireBits(FluxBits &flux, uint32_t valeur, int nb) {
+	flux.tampon |= valeur << flux.nbBits;
+	flux.nbBits += nb;
+	while (flux.nbBits >= 8) {
+		flux.octets.push_back(flux.tampon & 0xFF);
+		flux.tampon >>= 8;
+		flux.nbBits -= 8;
+	}
+}
+
+/**
+ * Ajoute au flux le code de Huffman fixe d'un symbole deflate : un octet, la fin du bloc ou une
+ * longueur de répétition.
+ *
+ * @param flux    Le flux.
+ * @param symbole Le symbole, de 0 à 287.
+ */
+void ecrireSymbole(FluxBits &flux, int symbole) {
+	uint32_t code = symbole < 144 ? 0x30 + symbole : symbole < 256 ? 0x190 + symbole - 144 : symbole < 280 ? symbole - 256 : 0xC0 + symbole - 280;
+	int longueur = symbole < 144 ? 8 : symbole < 256 ? 9 : symbole < 280 ? 7 : 8;
+
+	uint32_t inverse = 0;												// Les codes de Huffman s'écrivent poids fort en premier.
+	for (int i = 0; i < longueur; i++) {
+		inverse = (inverse << 1) | ((code >> i) & 1);
+	}
+	ecrireBits(flux, inverse, longueur);
+}
+
+/**
+ * Ajoute au flux la répétition de l'octet précédent, c'est-à-dire une copie à distance un.
+ *
+ * @param flux     Le flux.
+ * @param longueur Le nombre de répétitions, de 3 à longueurMaxRepetition.
+ */
+void ecrireRepetition(FluxBits &flux, int longueur) {
+	static const int bases[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+	static const int extras[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+	int k = sizeof(bases) / sizeof(bases[0]) - 1;
+	while (bases[k] > longueur) {
+		k--;
+	}
+
+	ecrireSymbole(flux, 257 + k);
+	ecrireBits(flux, longueur - bases[k], extras[k]);
+	ecrireBits(flux, 0, 5);												// Le code fixe de la distance un.
+}
+
+/**
+ * Compresse des octets dans un flux zlib fait d'un seul bloc deflate à codes fixes, où toute
+ * suite d'au moins trois octets identiques devient une répétition.
+ *
+ * @param brutes Les octets à compresser.
+ * @param zlib   Les octets compressés, à compléter.
+ */
+void compresser(const std::vector<unsigned char> &brutes, std::vector<unsigned char> &zlib) {
+	zlib.push_back(0x78);												// L'en-tête zlib,
+	zlib.push_back(0x01);
+
+	FluxBits flux = {zlib, 0, 0};
+	ecrireBits(flux, 1, 1);												// le dernier et seul bloc,
+	ecrireBits(flux, 1, 2);												// à codes fixes,
+	for (size_t i = 0; i < brutes.size(); ) {
+		size_t longueur = 0;
+		while (i > 0 && longueur < (size_t)longueurMaxRepetition && i + longueur < brutes.size() && brutes[i + longueur] == brutes[i - 1]) {
+			longueur++;
+		}
+
+		if (longueur >= 3) {
+			ecrireRepetition(flux, longueur);
+			i += longueur;
+		}
+		else {
+			ecrireSymbole(flux, brutes[i]);
+			i++;
+		}
+	}
+	ecrireSymbole(flux, 256);
+	if (flux.nbBits > 0) {
+		zlib.push_back(flux.tampon & 0xFF);
+	}
+
+	uint32_t a = 1, b = 0;
+	for (size_t i = 0; i < brutes.size(); i++) {
+		a = (a + brutes[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	ajouterMot(zlib, (b << 16) | a);									// et la somme Adler-32 des données.
+}
+
+/**
+ * Dessine des traits dans une image PNG en niveaux de gris, noir sur blanc, vus de dessus.
+ *
+ * @param  nom                 Le chemin du fichier à écrire.
+ * @param  traits              Les traits.
+ * @param  pixelsParCentimetre La résolution de l'image.
+ * @return                     Vrai si le fichier a pu être écrit.
+ */
+bool renduEcrirePng(const char *nom, const std::vector<Trait> &traits, double pixelsParCentimetre) {
+	Point min, max;
+	encadrer(traits, min, max);
+	long largeur = (long)ceil((max.x - min.x) * pixelsParCentimetre);
+	long hauteur = (long)ceil((max.y - min.y) * pixelsParCentimetre);
+	if (pixelsParCentimetre <= 0 || (double)largeur * hauteur > nbMaxPixels) {
+		return false;
+	}
+
+	std::vector<unsigned char> image(largeur * hauteur, 255);
+	double rayon = fmax(0.5, epaisseurFeutre * pixelsParCentimetre / 2);
+	for (size_t i = 0; i < traits.size(); i++) {
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			const Point &a = traits[i][j == 0 ? 0 : j - 1], &b = traits[i][j];	// Un trait d'un seul point est un point.
+			Point pa = {(a.x - min.x) * pixelsParCentimetre, (max.y - a.y) * pixelsParCentimetre};
+			Point pb = {(b.x - min.x) * pixelsParCentimetre, (max.y - b.y) * pixelsParCentimetre};
+			dessinerSegment(image, largeur, hauteur, pa, pb, rayon);
+		}
+	}
+
+	std::vector<unsigned char> brutes;									// Chaque ligne est précédée de son filtre,
+	for (long y = 0; y < hauteur; y++) {								// ici la différence avec la ligne du dessus.
+		brutes.push_back(2);
+		for (long x = 0; x < largeur; x++) {
+			brutes.push_back(image[y * largeur + x] - (y == 0 ? 0 : image[(y - 1) * largeur + x]));
+		}
+	}
+
+	std::vector<unsigned char> zlib;
+	compresser(brutes, zlib);
+
+	std::vector<unsigned char> entete;
+	ajouterMot(entete, largeur);
+	ajouterMot(entete, hauteur);
+	const unsigned char format[] = {8, 0, 0, 0, 0};						// 8 bits par pixel en niveaux de gris, sans entrelacement.
+	entete.insert(entete.end(), format, format + sizeof(format));
+
+	FILE *fichier = fopen(nom, "wb");
+	if (fichier == NULL) {
+		return false;
+	}
+	const unsigned char signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	fwrite(signature, 1, sizeof(signature), fichier);
+	ecrireBlocPng(fichier, "IHDR", entete);
+	ecrireBlocPng(fichier, "IDAT", zlib);
+	ecrireBlocPng(fichier, "IEND", std::vector<unsigned char>());
+
+	return fclose(fichier) == 0;
+}
+
+/**
+ * Enregistre des traits dans un fichier texte : une ligne donnant leur nombre, puis une ligne
+ * par trait donnant son nombre de points suivi de leurs coordonnées.
+ *
+ * @param fichier Le fichier ouvert en écriture.
+ * @param traits  Les traits.
+ * @see renduLire(FILE *fichier, std::vector<Trait> &traits)
+ */
+void renduEcrire(FILE *fichier, const std::vector<Trait> &traits) {
+	fprintf(fichier, "%lu traits\n", (unsigned long)traits.size());
+	for (size_t i = 0; i < traits.size(); i++) {
+		fprintf(fichier, "%lu", (unsigned long)traits[i].size());
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			fprintf(fichier, " %.4f %.4f", traits[i][j].x, traits[i][j].y);
+		}
+		fprintf(fichier, "\n");
+	}
+}
+
+/**
+ * Relit des traits enregistrés par renduEcrire().
+ *
+ * @param  fichier Le fichier ouvert en lecture, placé au début des traits.
+ * @param  traits  Reçoit les traits.
+ * @return         Vrai si les traits ont pu être lus en entier.
+ */
+bool renduLire(FILE *fichier, std::vector<Trait> &traits) {
+	unsigned long nbTraits, nbPoints;
+	if (fscanf(fichier, "%lu traits", &nbTraits) != 1) {
+		return false;
+	}
+
+	traits.assign(nbTraits, Trait());
+	for (size_t i = 0; i < nbTraits; i++) {
+		if (fscanf(fichier, "%lu", &nbPoints) != 1) {
+			return false;
+		}
+		traits[i].resize(nbPoints);
+		for (size_t j = 0; j < nbPoints; j++) {
+			if (fscanf(fichier, "%lf %lf", &traits[i][j].x, &traits[i][j].y) != 2) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Une grille de cases carrées, dont chacune connaît les segments qui la traversent. Elle permet
+ * de trouver les segments proches d'un point sans les parcourir tous.
+ */
+struct Grille {
+	double cote;														/**< Le côté d'une case en centimètres. */
+	std::unordered_map<int64_t, std::vector<const Point *> > cases;		/**< Pour chaque case, la première extrémité de chaque segment qui la traverse, la seconde étant le point suivant. */
+};
+
+/**
+ * Calcule la clé de la case d'une grille qui contient un point.
+ *
+ * @param  grille La grille.
+ * @param  p      Le point.
+ * @param  dx     Le décalage en cases selon x.
+ * @param  dy     Le décalage en cases selon y.
+ * @return        La clé de la case.
+ */
+int64_t caseGrille(const Grille &grille, const Point &p, int dx, int dy) {
+	int64_t x = (int64_t)floor(p.x / grille.cote) + dx, y = (int64_t)floor(p.y / grille.cote) + dy;
+	return (x << 32) ^ (y & 0xFFFFFFFF);
+}
+
+/**
+ * Range les segments de traits dans une grille : chaque segment est échantillonné tous les
+ * demi-côtés de case, et inscrit dans les cases de ses échantillons.
+ *
+ * @param grille La grille, dont le côté est déjà choisi.
+ * @param traits Les traits, qui doivent rester en place tant que la grille sert.
+ */
+void remplirGrille(Grille &grille, const std::vector<Trait> &traits) {
+	for (size_t i = 0; i < traits.size(); i++) {
+		for (size_t j = 0; j + 1 < traits[i].size(); j++) {
+			const Point &a = traits[i][j], &b = traits[i][j + 1];
+			int nb = (int)ceil(hypot(b.x - a.x, b.y - a.y) / (grille.cote / 2));
+			for (int k = 0; k <= nb; k++) {
+				Point p = {a.x + (b.x - a.x) * k / (nb > 0 ? nb : 1), a.y + (b.y - a.y) * k / (nb > 0 ? nb : 1)};
+				std::vector<const Point *> &segments = grille.cases[caseGrille(grille, p, 0, 0)];
+				if (segments.empty() || segments.back() != &a) {
+					segments.push_back(&a);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Calcule le plus grand écart entre des traits et ceux rangés dans une grille : les traits sont
+ * échantillonnés tous les quarts de côté de case, et chaque échantillon est comparé aux segments
+ * des cases voisines de la sienne.
+ *
+ * @param  traits Les traits à mesurer.
+ * @param  grille La grille des traits de comparaison.
+ * @return        Le plus grand écart en centimètres, ou HUGE_VAL si un échantillon n'a aucun
+ * 				  segment à moins d'une case.
+ */
+double ecartGrille(const std::vector<Trait> &traits, const Grille &grille) {
+	double ecart = 0;
+	for (size_t i = 0; i < traits.size(); i++) {
+		for (size_t j = 0; j < traits[i].size(); j++) {
+			const Point &a = traits[i][j == 0 ? 0 : j - 1], &b = traits[i][j];
+			int nb = (int)ceil(hypot(b.x - a.x, b.y - a.y) / (grille.cote / 4));
+			for (int k = j == 0 ? 0 : 1; k <= nb; k++) {
+				Point p = {a.x + (b.x - a.x) * k / (nb > 0 ? nb : 1), a.y + (b.y - a.y) * k / (nb > 0 ? nb : 1)};
+				double plusProche = HUGE_VAL;
+				for (int dx = -1; dx <= 1; dx++) {
+					for (int dy = -1; dy <= 1; dy++) {
+						std::unordered_map<int64_t, std::vector<const Point *> >::const_iterator voisine = grille.cases.find(caseGrille(grille, p, dx, dy));
+						if (voisine == grille.cases.end()) {
+							continue;
+						}
+						for (size_t s = 0; s < voisine->second.size(); s++) {
+							plusProche = fmin(plusProche, distanceSegment(p, voisine->second[s][0], voisine->second[s][1]));
+						}
+					}
+				}
+				if (plusProche == HUGE_VAL) {
+					return HUGE_VAL;
+				}
+				ecart = fmax(ecart, plusProche);
+			}
+		}
+	}
+
+	return ecart;
+}
+
+/**
+ * Compare deux dessins : l'écart est la plus grande distance entre un point de l'un et le trait
+ * le plus proche de l'autre, dans un sens comme dans l'autre. L'ordre et le sens des traits
+ * n'importent donc pas, seul ce qui est tracé sur la feuille compte. Les distances sont
+ * cherchées dans une grille dont les cases font le double de la tolérance : au-delà, elles ne
+ * sont plus mesurées exactement.
+ *
+ * @param  traits     Les traits du dessin à vérifier.
+ * @param  references Les traits du dessin de référence.
+ * @param  tolerance  L'écart en centimètres en dessous duquel les dessins sont considérés égaux.
+ * @return            Le plus grand écart en centimètres s'il est de l'ordre de la tolérance, ou
+ * 					  HUGE_VAL s'il la dépasse largement.
+ */
+double renduEcart(const std::vector<Trait> &traits, const std::vector<Trait> &references, double tolerance) {
+	Grille grilleTraits, grilleReferences;
+	grilleTraits.cote = grilleReferences.cote = 2 * tolerance;
+	remplirGrille(grilleTraits, traits);
+	remplirGrille(grilleReferences, references);
+
+	return fmax(ecartGrille(traits, grilleReferences), ecartGrille(references, grilleTraits));
+}
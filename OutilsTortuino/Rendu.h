@@ -0,0 +1,30 @@
+/**
+ * @file Rendu.h
+ * @brief Définition des fonctions implémentées dans Rendu.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de Rendu.cpp. Il permet de préciser ce
+ * qui sera rendu accessible aux outils. Ici, ce sont des fonctions, les traits
+ * étant ceux de Parcours.h.
+ */
+
+
+# ifndef TORTUINO_RENDU_h
+#	define TORTUINO_RENDU_h
+
+#	include <stdio.h>
+#	include <vector>
+#	include "Parcours.h"
+#	include "MaterielHote.h"
+
+	void renduDemarrer(bool feutreLeve);
+	void renduEvenement(const Evenement &evenement);
+	const std::vector<Trait> &renduTraits();
+	Point renduPosition();
+	bool renduEcrireSvg(const char *nom, const std::vector<Trait> &traits);
+	bool renduEcrirePng(const char *nom, const std::vector<Trait> &traits, double pixelsParCentimetre);
+	void renduEcrire(FILE *fichier, const std::vector<Trait> &traits);
+	bool renduLire(FILE *fichier, std::vector<Trait> &traits);
+	double renduEcart(const std::vector<Trait> &traits, const std::vector<Trait> &references, double tolerance);
+
+# endif
@@ -0,0 +1,63 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include "Tortuino.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+
+
+/**
+ * @file TraceTortuino.cpp
+ * @brief Ce programme exécute un dessin sur l'ordinateur et en affiche la suite de pas.
+ * @version 1.0
+ *
+ * Le programme traceTortuino exécute sans robot un des dessins de TortuinoDessins.h grâce à
+ * MaterielHote.cpp, puis affiche chacun des événements enregistrés sur une ligne : l'instant en
+ * interruptions du Timer2, la lettre G ou D pour un pas de la roue gauche ou droite suivie de son
+ * sens, ou la lettre F pour le feutre suivie de 1 s'il est levé et de 0 s'il est baissé. Par
+ * exemple, pour un flocon de Von Koch de niveau 3 et de 12 centimètres :
+ *
+ * {@code
+ * 	./traceTortuino floconVonKoch 3 12 > flocon.txt
+ * }
+ *
+ * Les paramètres qui ne sont pas donnés prennent la valeur par défaut de la table de Figures.cpp.
+ */
+
+
+
+/**
+ * Affiche la liste des dessins disponibles avec leur nombre de paramètres.
+ *
+ * @param programme Le nom du programme tel qu'appelé.
+ */
+void afficherUsage(const char *programme) {
+	fprintf(stderr, "Usage : %s dessin [paramètres...]\nDessins :\n", programme);
+	for (int i = 0; i < nbFigures; i++) {
+		fprintf(stderr, "\t%s (%d paramètres)\n", figures[i].nom, figures[i].nbParametres);
+	}
+}
+
+int main(int argc, char **argv) {
+	const Figure *figure = argc > 1 ? figureTrouver(argv[1]) : NULL;
+	if (figure == NULL) {
+		afficherUsage(argv[0]);
+		return 1;
+	}
+
+	float parametres[NB_MAX_PARAMETRES];
+	for (int i = 0; i < NB_MAX_PARAMETRES; i++) {						// Les paramètres donnés remplacent ceux par défaut.
+		parametres[i] = i + 2 < argc ? atof(argv[i + 2]) : figure->parametresDefaut[i];
+	}
+
+	initialiser();
+	figure->tracer(parametres);
+	terminer();
+
+	const char lettres[] = {'G', 'D', 'F'};
+	const std::vector<Evenement> &evenements = hoteEvenements();
+	for (size_t i = 0; i < evenements.size(); i++) {
+		printf("%llu %c %d\n", (unsigned long long)evenements[i].instant, lettres[evenements[i].type], evenements[i].valeur);
+	}
+
+	return 0;
+}
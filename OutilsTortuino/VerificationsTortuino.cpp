@@ -0,0 +1,701 @@
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+# include <vector>
+# include "Tortuino.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoOdometrie.h"
+# include "TortuinoLiaison.h"
+# include "TortuinoPilote.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoDessins.h"
+# include "MaterielHote.h"
+# include "Figures.h"
+# include "Parcours.h"
+# include "Rendu.h"
+
+
+/**
+ * @file VerificationsTortuino.cpp
+ * @brief Ce programme vérifie sur l'ordinateur des propriétés précises de la bibliothèque.
+ * @version 1.0
+ *
+ * Le programme verificationsTortuino exécute sans robot une suite de vérifications qui ne se
+ * voient pas sur un dessin fini, et que regressionTortuino ne peut donc pas faire : des bornes
+ * sur le nombre de pas, sur leurs instants ou sur ce que trace un algorithme. Chacune affiche
+ * une ligne avec son nom, son résultat et ce qu'elle a mesuré. Les options sont :
+ *
+ * {@code
+ * 	./verificationsTortuino [verification...]
+ * }
+ *
+ * Sans argument, toutes les vérifications sont faites. Le programme se termine en erreur si
+ * l'une d'elles échoue.
+ */
+
+
+
+/**
+ * Une vérification : son nom et la fonction qui la fait.
+ */
+struct Verification {
+	const char *nom;													/**< Le nom de la vérification, à donner sur la ligne de commande. */
+	bool (*verifier)(char *mesure, size_t taille);						/**< La fonction qui la fait, écrit ce qu'elle a mesuré et renvoie vrai si elle réussit. */
+};
+
+
+/**
+ * Vérifie que le report du résidu de chaque roue garde le total des pas d'une longue suite de
+ * petits segments à moins d'un pas du total exact, là où tronquer chaque segment en perd un
+ * grand nombre.
+ *
+ * @param  mesure Où écrire les écarts mesurés.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si l'écart reste inférieur à un pas sur chaque roue.
+ */
+bool verifierResidus(char *mesure, size_t taille) {
+	const int nbSegments = 3000;
+	const float longueur = 0.0173;										// Une fraction de pas qui ne tombe jamais juste.
+
+	initialiser();
+	int32_t avance = multiplierQ16(versQ16(longueur), odometriePasParCentimetre());
+	long totalGauche = 0, totalDroite = 0, totalTronque = 0;
+	for (int i = 0; i < nbSegments; i++) {
+		long pasGauche, pasDroite;
+		odometrieTranslation(versQ16(longueur), pasGauche, pasDroite);
+		totalGauche += pasGauche;
+		totalDroite += pasDroite;
+		totalTronque += avance / 65536;
+	}
+
+	double exact = (double)avance * nbSegments / 65536;
+	double ecartGauche = fabs(-totalGauche - exact), ecartDroite = fabs(totalDroite - exact);
+	snprintf(mesure, taille, "écart de %.2f et %.2f pas sur %.1f, %.1f perdus en tronquant",
+		ecartGauche, ecartDroite, exact, exact - totalTronque);
+
+	return ecartGauche < 1 && ecartDroite < 1;
+}
+
+
+unsigned long			pasObserves		=	0;		/**< Le nombre de pas des deux roues vus par observer() depuis sa remise à zéro. */
+std::vector<uint64_t>	instantsDroite;			/**< Les instants des pas de la roue droite vus par observer() depuis sa remise à zéro. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp, qui compte les pas.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observer(const Evenement &evenement) {
+	if (evenement.type != EVENEMENT_FEUTRE) {
+		pasObserves++;
+	}
+	if (evenement.type == EVENEMENT_PAS_DROITE) {
+		instantsDroite.push_back(evenement.instant);
+	}
+}
+
+/**
+ * Cherche le premier pas de la roue droite fait plus tôt que ne le permet le profil de tracé
+ * pour des moteurs à l'arrêt à un instant donné : partis de la vitesse de démarrage et accélérant
+ * au plus vite, ils ne peuvent pas avoir fait plus de pas que la distance parcourue depuis.
+ *
+ * @param  depart L'instant où les moteurs étaient arrêtés.
+ * @param  avance Reçoit l'avance en pas du premier pas trop tôt, ou la plus grande marge restante.
+ * @return        Le numéro du premier pas trop tôt, compté depuis l'instant donné, ou 0 s'il n'y
+ * 				  en a pas.
+ */
+long pasTropTot(uint64_t depart, double &avance) {
+	float limites[3];
+	moteursLimites(PROFIL_TRACE, limites);
+	double vitesse = limites[0] / FREQUENCE_MOTEURS;					// En pas par interruption,
+	double acceleration = limites[2] / FREQUENCE_MOTEURS / FREQUENCE_MOTEURS;	// et par interruption au carré.
+
+	long nbPas = 0;
+	avance = -HUGE_VAL;
+	for (size_t i = 0; i < instantsDroite.size(); i++) {
+		if (instantsDroite[i] < depart) {
+			continue;
+		}
+
+		double duree = instantsDroite[i] - depart;
+		double possibles = vitesse * duree + acceleration * duree * (duree + 1) / 2 + 1;
+		avance = fmax(avance, ++nbPas - possibles);
+		if (nbPas > possibles) {
+			return nbPas;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Cherche le premier intervalle entre deux pas de la roue droite plus court que ne le permet le
+ * profil de tracé pour des moteurs à l'arrêt à un instant donné : leur vitesse ne peut pas avoir
+ * dépassé celle de démarrage augmentée de l'accélération depuis cet instant. Contrairement à
+ * pasTropTot(), qui borne le total des pas, elle voit un saut de vitesse dès qu'il a lieu.
+ *
+ * @param  depart L'instant où les moteurs étaient arrêtés.
+ * @param  exces  Reçoit le rapport entre la vitesse du premier intervalle trop court et celle que
+ * 				  permet le profil, ou le plus grand de ces rapports s'il n'y en a pas.
+ * @return        Le numéro du pas qui termine le premier intervalle trop court, compté depuis
+ * 				  l'instant donné, ou 0 s'il n'y en a pas.
+ */
+long intervalleTropCourt(uint64_t depart, double &exces) {
+	float limites[3];
+	moteursLimites(PROFIL_TRACE, limites);
+	double vitesse = limites[0] / FREQUENCE_MOTEURS;					// En pas par interruption,
+	double acceleration = limites[2] / FREQUENCE_MOTEURS / FREQUENCE_MOTEURS;	// et par interruption au carré.
+
+	long nbPas = 0;
+	exces = 0;
+	for (size_t i = 1; i < instantsDroite.size(); i++) {
+		if (instantsDroite[i - 1] < depart) {
+			continue;
+		}
+
+		double duree = instantsDroite[i] - depart;						// Avec la phase de l'accumulateur, un intervalle de
+		double rapport = 1 / ((instantsDroite[i] - instantsDroite[i - 1] + 1) * (vitesse + acceleration * duree));	// n interruptions vient d'une vitesse d'au moins 1/(n+1).
+		exces = fmax(exces, rapport);
+		nbPas++;
+		if (rapport > 1) {
+			return nbPas;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Vérifie qu'un segment enchaîné qui arrive alors que les moteurs se sont déjà arrêtés ne part
+ * pas de sa vitesse d'entrée, ce qui ferait décrocher les moteurs, mais de celle de démarrage.
+ *
+ * @param  mesure Où écrire l'avance mesurée.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si aucun pas n'est fait plus tôt que le profil ne le permet.
+ */
+bool verifierJonction(char *mesure, size_t taille) {
+	const long nbPas = 2000;
+	float limites[3];
+
+	initialiser();
+	moteursLimites(PROFIL_TRACE, limites);
+	hoteObserver(observer);
+	instantsDroite.clear();
+
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0, 0.8 * limites[1]);	// Le programme principal l'a cru rejoint à temps,
+	moteursAttendre();
+	materielDelai(100);													// mais les moteurs se sont arrêtés.
+	uint64_t depart = hoteInstant();
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0.8 * limites[1], 0);
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0, 0);
+	moteursAttendre();
+	hoteObserver(NULL);
+
+	double avance;
+	long numero = pasTropTot(depart, avance);
+	snprintf(mesure, taille, numero == 0 ? "marge minimale de %.1f pas sur le profil" : "pas %.0f en avance de %.1f pas",
+		numero == 0 ? -avance : (double)numero, avance);
+
+	return numero == 0;
+}
+
+/**
+ * Vérifie que des moteurs suspendus au milieu d'une chaîne de segments, puis repartis de la
+ * vitesse de démarrage, ne retrouvent pas en fin de segment la vitesse de sortie prévue avant la
+ * pause, et que les segments suivants de la chaîne ne partent pas de leur vitesse d'entrée.
+ *
+ * @param  mesure Où écrire l'avance mesurée.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si aucun pas n'est fait après la reprise plus tôt que le profil ne le permet.
+ */
+bool verifierPause(char *mesure, size_t taille) {
+	const long nbPas = 2000;
+	const size_t pasAvantPause = nbPas - 20;							// Trop peu de pas restent pour réaccélérer.
+	float limites[3];
+
+	initialiser();
+	moteursLimites(PROFIL_TRACE, limites);
+	hoteObserver(observer);
+	instantsDroite.clear();
+
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0, 0.8 * limites[1]);
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0.8 * limites[1], 0.8 * limites[1]);
+	moteursAjouterEnchaine(-nbPas, nbPas, PROFIL_TRACE, 0.8 * limites[1], 0);
+	while (instantsDroite.size() < pasAvantPause) {
+		materielPatienter();
+	}
+	moteursSuspendre(true);
+	materielDelai(100);
+	uint64_t depart = hoteInstant();
+	moteursSuspendre(false);
+	moteursAttendre();
+	hoteObserver(NULL);
+
+	double exces;
+	long numero = intervalleTropCourt(depart, exces);
+	if (numero == 0) {
+		snprintf(mesure, taille, "vitesse d'au plus %.0f %% du profil après la reprise, %lu pas", 100 * exces, (unsigned long)instantsDroite.size());
+	}
+	else {
+		snprintf(mesure, taille, "pas %ld à %.1f %% du profil après la reprise", numero, 100 * exces);
+	}
+
+	return numero == 0 && instantsDroite.size() == 3 * nbPas;
+}
+
+/**
+ * Envoie au robot simulé une trame de bloc, éventuellement privée d'un de ses octets.
+ *
+ * @param numero    Le numéro du bloc dans la session.
+ * @param pasGauche Le nombre de pas de la roue gauche.
+ * @param pasDroite Le nombre de pas de la roue droite.
+ * @param perdu     L'indice de l'octet à ne pas envoyer, ou -1 pour les envoyer tous.
+ */
+void envoyerTrame(int numero, int pasGauche, int pasDroite, int perdu) {
+	unsigned char trame[TAILLE_TRAME_BLOC] = {
+		TRAME_BLOC, (unsigned char)numero,
+		(unsigned char)(pasGauche & 0xFF), (unsigned char)((pasGauche >> 8) & 0xFF),
+		(unsigned char)(pasDroite & 0xFF), (unsigned char)((pasDroite >> 8) & 0xFF),
+		(unsigned char)(2000 & 0xFF), (unsigned char)(2000 >> 8), 0, 0
+	};
+	for (int i = 1; i < TAILLE_TRAME_BLOC - 1; i++) {
+		trame[TAILLE_TRAME_BLOC - 1] += trame[i];
+	}
+	for (int i = 0; i < TAILLE_TRAME_BLOC; i++) {
+		if (i != perdu) {
+			hoteSerieEnvoyer(trame[i]);
+		}
+	}
+}
+
+/**
+ * Ce que le robot simulé a répondu sur la liaison série.
+ */
+struct Reponses {
+	int credits;														/**< Le nombre total de trames accordées. */
+	int enAvanceMax;													/**< Le plus grand nombre de trames accordées et pas encore envoyées. */
+	int erreurs;														/**< Le nombre de REPONSE_ERREUR. */
+	int redemande;														/**< Le numéro du bloc redemandé par la dernière REPONSE_ERREUR, ou -1. */
+	bool attendCredits;													/**< Vrai si le prochain octet est un nombre de crédits. */
+	bool attendRejet;													/**< Vrai si le prochain octet est le numéro d'un bloc redemandé. */
+	bool fini;															/**< Vrai une fois la REPONSE_FINI reçue. */
+};
+
+/**
+ * Fait tourner la liaison du robot simulé pendant une durée donnée, ou jusqu'à la fin de la
+ * session, en lisant ses réponses.
+ *
+ * @param reponses    Les réponses lues jusqu'ici.
+ * @param nbEnvoyees  Le nombre de blocs différents déjà envoyés.
+ * @param duree       La durée maximale en interruptions du Timer2.
+ */
+void pomperLiaison(Reponses &reponses, int nbEnvoyees, long duree) {
+	for (long i = 0; i < duree && !reponses.fini; i++) {
+		liaisonActualiser();
+		materielPatienter();
+
+		int octet;
+		while ((octet = hoteSerieRecevoir()) >= 0) {
+			if (reponses.attendCredits) {
+				reponses.credits += octet;
+				reponses.attendCredits = false;
+			}
+			else if (reponses.attendRejet) {
+				reponses.redemande = octet;
+				reponses.attendRejet = false;
+			}
+			else if (octet == REPONSE_CREDITS) {
+				reponses.attendCredits = true;
+			}
+			else if (octet == REPONSE_ERREUR) {
+				reponses.erreurs++;
+				reponses.attendRejet = true;
+			}
+			else if (octet == REPONSE_FINI) {
+				reponses.fini = true;
+			}
+		}
+		if (reponses.credits - nbEnvoyees > reponses.enAvanceMax) {
+			reponses.enAvanceMax = reponses.credits - nbEnvoyees;
+		}
+	}
+}
+
+/**
+ * Vérifie que la liaison n'accorde jamais plus de trames que n'en contient le tampon de
+ * réception, et qu'après une trame privée d'un octet elle rejette celle-ci une seule fois,
+ * ignore les trames qui la suivent, et exécute tous les blocs dans l'ordre une fois qu'ils ont
+ * été renvoyés, en ne rendant qu'un crédit par bloc.
+ *
+ * @param  mesure Où écrire ce qui a été reçu.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si le bloc abîmé a été redemandé et que tous les pas ont été faits.
+ */
+bool verifierLiaison(char *mesure, size_t taille) {
+	const int nbTrames = 4;
+	Reponses reponses = {0, 0, 0, -1, false, false, false};
+
+	initialiser();
+	liaisonDemarrer();
+	hoteObserver(observer);
+	pasObserves = 0;
+
+	hoteSerieEnvoyer(TRAME_BONJOUR);
+	pomperLiaison(reponses, 0, FREQUENCE_MOTEURS / 10);
+	int creditsInitiaux = reponses.credits;
+	for (int i = 0; i < nbTrames; i++) {								// La première perd un octet,
+		envoyerTrame(i, 40, -40, i == 0 ? 3 : -1);						// et ce sont les suivantes qui la recalent.
+	}
+	pomperLiaison(reponses, nbTrames, FREQUENCE_MOTEURS);
+	int redemande = reponses.redemande;
+	for (int i = redemande < 0 ? nbTrames : redemande; i < nbTrames; i++) {	// Renvoi du bloc redemandé et des suivants.
+		envoyerTrame(i, 40, -40, -1);
+	}
+	pomperLiaison(reponses, nbTrames, FREQUENCE_MOTEURS);
+	hoteSerieEnvoyer(TRAME_FIN);
+	hoteSerieEnvoyer(nbTrames);
+	pomperLiaison(reponses, nbTrames, 10L * FREQUENCE_MOTEURS);
+	hoteObserver(NULL);
+
+	snprintf(mesure, taille, "%d puis %d crédits, %d au plus d'avance, %d erreur, bloc %d redemandé, %lu pas, %s",
+		creditsInitiaux, reponses.credits - creditsInitiaux, reponses.enAvanceMax, reponses.erreurs, redemande,
+		pasObserves, reponses.fini ? "session finie" : "session inachevée");
+
+	return reponses.fini && reponses.erreurs == 1 && redemande == 0 && pasObserves == 80 * nbTrames
+		&& reponses.enAvanceMax <= 64 / TAILLE_TRAME_BLOC && reponses.credits == creditsInitiaux + nbTrames;
+}
+
+/**
+ * Mesure ce que parcoursSansRepasses() retire d'un dessin, et vérifie que l'encre posée n'a pas
+ * changé.
+ *
+ * @param  traits Les traits du dessin, dans l'ordre où ils sont tracés.
+ * @param  retire Reçoit la longueur en centimètres retirée des traits.
+ * @return        Vrai si les traits restants tracent le même dessin.
+ */
+bool retirerRepasses(const std::vector<Trait> &traits, double &retire) {
+	std::vector<Trait> neufs = parcoursSansRepasses(traits);
+	retire = parcoursBilan(traits).distanceBaissee - parcoursBilan(neufs).distanceBaissee;
+
+	return renduEcart(neufs, traits, 0.01) <= 0.01;
+}
+
+/**
+ * Vérifie que parcoursSansRepasses() retire les retours d'une étoile tracée par allers et retours
+ * depuis son centre et le bas que maison() retrace après sa porte, mais rien d'un pentagramme,
+ * dont les côtés se croisent sans se recouvrir.
+ *
+ * @param  mesure Où écrire les longueurs retirées.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si exactement les repasses ont été retirées et que l'encre n'a pas changé.
+ */
+bool verifierRepasses(char *mesure, size_t taille) {
+	const int nbBranches = 8;
+	const double rayon = 10;
+
+	const Point centre = {0, 0};
+	std::vector<Trait> etoile(1, Trait(1, centre));
+	for (int i = 0; i < nbBranches; i++) {								// Chaque branche est un aller et retour.
+		Point pointe = {rayon * cos(2 * M_PI * i / nbBranches), rayon * sin(2 * M_PI * i / nbBranches)};
+		etoile[0].push_back(pointe);
+		etoile[0].push_back(centre);
+	}
+	std::vector<Trait> pentagramme(1);
+	for (int i = 0; i <= 5; i++) {										// Un sommet sur deux, jusqu'à revenir au premier.
+		Point sommet = {rayon * cos(4 * M_PI * i / 5), rayon * sin(4 * M_PI * i / 5)};
+		pentagramme[0].push_back(sommet);
+	}
+
+	initialiser();
+	parcoursCapturer(true);
+	const Figure *figure = figureTrouver("maison");
+	figure->tracer(figure->parametresDefaut);
+	terminer();
+	parcoursCapturer(false);
+
+	double retireEtoile, retirePentagramme, retireMaison;
+	bool memeEncre = retirerRepasses(etoile, retireEtoile) && retirerRepasses(pentagramme, retirePentagramme)
+		&& retirerRepasses(parcoursTraits(), retireMaison);
+	snprintf(mesure, taille, "%.2f cm retirés de l'étoile, %.2f du pentagramme, %.2f de la maison, %s",
+		retireEtoile, retirePentagramme, retireMaison, memeEncre ? "même encre" : "encre différente");
+
+	return memeEncre && fabs(retireEtoile - nbBranches * rayon) < 0.01 && retirePentagramme < 0.01 && fabs(retireMaison - 2) < 0.01;
+}
+
+/**
+ * Mesure l'écart entre la position du feutre reconstruite par Rendu.cpp et celle que donne
+ * l'odométrie, après une figure tracée depuis initialiser().
+ *
+ * @param  tracer     La fonction qui trace la figure.
+ * @param  parametres Ses paramètres.
+ * @return            L'écart en centimètres.
+ */
+double ecartRendu(void (*tracer)(const float *), const float *parametres) {
+	initialiser();
+	renduDemarrer(feutreEstLeve());
+	hoteObserver(renduEvenement);
+	tracer(parametres);
+	terminer();
+	hoteObserver(NULL);
+
+	Position odometrie = position();
+	Point rendu = renduPosition();
+	return hypot(rendu.x - odometrie.x, rendu.y - odometrie.y);
+}
+
+/**
+ * Trace cent fois un quart de tour à gauche suivi d'un quart de tour à droite.
+ *
+ * @param p Inutilisé.
+ */
+void pivoter(const float *p) {
+	for (int i = 0; i < 100; i++) {
+		tournerGauche(90);
+		tournerDroite(90);
+	}
+}
+
+/**
+ * Vérifie que Rendu.cpp applique ensemble les pas des deux roues faits à un même instant : des
+ * rotations sur place ne doivent pas déplacer le feutre, et un arbre doit finir là où l'odométrie
+ * place le robot.
+ *
+ * @param  mesure Où écrire les écarts mesurés.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si les deux écarts restent inférieurs à un pas.
+ */
+bool verifierRendu(char *mesure, size_t taille) {
+	const Figure *arbre = figureTrouver("arbre");
+	const float parametres[] = {10, 10};
+	double ecartPivots = ecartRendu(pivoter, NULL);
+	double ecartArbre = ecartRendu(arbre->tracer, parametres);
+	double pas = 1 / (odometriePasParCentimetre() / 65536.0);
+	snprintf(mesure, taille, "écart de %.4f cm après les rotations, de %.4f cm après l'arbre, pour un pas de %.4f cm",
+		ecartPivots, ecartArbre, pas);
+
+	return ecartPivots < pas && ecartArbre < pas;
+}
+
+/**
+ * Fait avancer le dessin piloté pendant une durée donnée, comme le ferait `loop()`.
+ *
+ * @param duree La durée en interruptions du Timer2.
+ */
+void piloter(uint64_t duree) {
+	uint64_t fin = hoteInstant() + duree;
+	while (hoteInstant() < fin) {
+		piloteActualiser();
+		materielPatienter();
+	}
+}
+
+/**
+ * Vérifie qu'après un abandon au milieu d'un hexagone tracé en mode continu, dont plusieurs
+ * segments attendent dans la file des moteurs, position() donne bien l'endroit où le robot s'est
+ * arrêté, dans les coordonnées de initialiser(), et que allerA(0, 0) l'y ramène.
+ *
+ * @param  mesure Où écrire les écarts mesurés.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si les deux écarts restent inférieurs à deux pas.
+ */
+bool verifierAbandon(char *mesure, size_t taille) {
+	initialiser();
+	renduDemarrer(feutreEstLeve());
+	hoteObserver(renduEvenement);
+	continu(0.2);
+	piloteDemarrer();
+	polygoneRegulier(6, 10);
+	piloter(FREQUENCE_MOTEURS / 2);
+
+	hoteBouton(true);													// Un appui long, relâché alors que le robot
+	piloter(FREQUENCE_MOTEURS * 6 / 5);									// arrondit le premier coin, avec la suite
+	hoteBouton(false);													// dans la file des moteurs.
+	piloter(FREQUENCE_MOTEURS / 10);
+	bool abandonne = piloteAbandonne();
+	piloteReprendre();
+
+	Position arret = position();
+	Point rendu = renduPosition();
+	double ecartArret = hypot(rendu.x - arret.x, rendu.y - arret.y);
+	allerA(0, 0);
+	piloteArreter();
+	terminer();
+	hoteObserver(NULL);
+	continu(0);
+
+	rendu = renduPosition();
+	double ecartRetour = hypot(rendu.x, rendu.y);
+	double pas = 1 / (odometriePasParCentimetre() / 65536.0);
+	snprintf(mesure, taille, "arrêt en (%.2f, %.2f) à %.4f cm de position(), retour à %.4f cm du départ",
+		arret.x, arret.y, ecartArret, ecartRetour);
+
+	return abandonne && hypot(arret.x, arret.y) > 1 && ecartArret < 2 * pas && ecartRetour < 2 * pas;
+}
+
+unsigned long	levesFeutre	=	0;					/**< Le nombre de fois que observerPilote() a vu le feutre se lever depuis sa remise à zéro. */
+
+
+/**
+ * L'observateur des événements de MaterielHote.cpp pendant un dessin piloté, qui compte les pas
+ * comme observer() et les levers du feutre.
+ *
+ * @param evenement L'événement qui vient de se produire.
+ */
+void observerPilote(const Evenement &evenement) {
+	observer(evenement);
+	if (evenement.type == EVENEMENT_FEUTRE && evenement.valeur != 0) {
+		levesFeutre++;
+	}
+}
+
+/**
+ * Appuie sur le bouton simulé pendant une durée donnée, le dessin continuant d'être piloté.
+ *
+ * @param ms La durée de l'appui en millisecondes.
+ */
+void appuyer(unsigned long ms) {
+	hoteBouton(true);
+	piloter(ms * FREQUENCE_MOTEURS / 1000);
+	hoteBouton(false);
+}
+
+/**
+ * Vérifie le bouton d'un dessin piloté : un appui plus court que le délai de rebond est ignoré,
+ * un appui court met en pause, pendant laquelle aucun pas n'est fait, un second fait reprendre, et
+ * un appui long abandonne le dessin. Après l'abandon, le feutre doit être levé une seule fois,
+ * les commandes en attente oubliées sans faire un pas, et piloteActualiser() doit annoncer la fin
+ * du dessin.
+ *
+ * @param  mesure Où écrire ce qui a été observé.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si le bouton a eu chaque fois l'effet attendu.
+ */
+bool verifierPilote(char *mesure, size_t taille) {
+	initialiser();
+	hoteObserver(observerPilote);
+	piloteDemarrer();
+	polygoneRegulier(6, 10);
+	piloter(FREQUENCE_MOTEURS / 2);
+
+	appuyer(10);														// Un rebond : le relâchement est ignoré.
+	piloter(FREQUENCE_MOTEURS / 10);
+	bool rebondIgnore = !piloteEnPause();
+
+	appuyer(100);
+	bool enPause = piloteEnPause();
+	pasObserves = 0;
+	piloter(FREQUENCE_MOTEURS);
+	unsigned long pasEnPause = pasObserves;
+
+	appuyer(100);
+	pasObserves = 0;
+	piloter(FREQUENCE_MOTEURS / 2);
+	bool repris = !piloteEnPause() && pasObserves > 0;
+	unsigned long pasRepris = pasObserves;
+
+	hoteBouton(true);
+	piloter(FREQUENCE_MOTEURS * 6 / 5);
+	bool restait = commandesProchaine() != NULL;						// Des commandes attendent encore au relâchement.
+	hoteBouton(false);
+	levesFeutre = 0;
+	pasObserves = 0;
+	piloter(FREQUENCE_MOTEURS / 2);
+	bool abandonne = piloteAbandonne();
+	bool fini = !piloteActualiser();
+	bool oubliees = restait && commandesProchaine() == NULL;
+	unsigned long levesAbandon = levesFeutre, pasAbandon = pasObserves;
+
+	piloteReprendre();
+	piloteArreter();
+	terminer();
+	hoteObserver(NULL);
+
+	snprintf(mesure, taille, "rebond %s, %lu pas en pause, %lu après la reprise, feutre levé %lu fois et %lu pas après l'abandon, %s",
+		rebondIgnore ? "ignoré" : "pris pour un appui", pasEnPause, pasRepris, levesAbandon, pasAbandon,
+		abandonne && fini && oubliees ? "dessin fini" : "dessin pas fini");
+
+	return rebondIgnore && enPause && pasEnPause == 0 && repris && abandonne && levesAbandon == 1 && pasAbandon == 0 && fini && oubliees;
+}
+
+/**
+ * Vérifie qu'une seule translation de dix mètres, dont le nombre de pas en Q16.16 déborde de 32
+ * bits, est faite en entier et dans le bon sens : c'est deux fois plus de pas qu'en compterait un
+ * robot en demi-pas pour la plus longue diagonale d'une grande feuille.
+ *
+ * @param  mesure Où écrire les positions mesurées.
+ * @param  taille La taille de mesure.
+ * @return        Vrai si le robot arrive à moins d'un pas de l'arrivée, et sa pose à la précision
+ * 				  de CORDIC près.
+ */
+bool verifierTranslation(char *mesure, size_t taille) {
+	const float distance = 1000;
+
+	initialiser();
+	renduDemarrer(feutreEstLeve());
+	hoteObserver(renduEvenement);
+	avancer(distance);
+	terminer();
+	hoteObserver(NULL);
+
+	Position arrivee = position();
+	Point rendu = renduPosition();
+	double pas = 1 / (odometriePasParCentimetre() / 65536.0);
+	snprintf(mesure, taille, "arrivée en (%.3f, %.3f) d'après les pas, en (%.3f, %.3f) d'après position()",
+		rendu.x, rendu.y, arrivee.x, arrivee.y);
+
+	return hypot(rendu.x - distance, rendu.y) < pas && hypot(arrivee.x - distance, arrivee.y) < distance / 16384;	// Le sinus n'est connu qu'à 2^-14 près.
+}
+
+const Verification	verifications[]	=	{			/**< Toutes les vérifications, dans l'ordre où elles sont faites. */
+	{"residus",			verifierResidus},
+	{"translation",		verifierTranslation},
+	{"liaison",			verifierLiaison},
+	{"jonction",		verifierJonction},
+	{"pause",			verifierPause},
+	{"repasses",		verifierRepasses},
+	{"rendu",			verifierRendu},
+	{"abandon",			verifierAbandon},
+	{"pilote",			verifierPilote}
+};
+const int			nbVerifications	=	sizeof(verifications) / sizeof(verifications[0]);	/**< Le nombre de vérifications. */
+
+
+/**
+ * Indique si une vérification fait partie de celles demandées sur la ligne de commande.
+ *
+ * @param  nom      Le nom de la vérification.
+ * @param  demandes Les noms demandés.
+ * @param  nb       Le nombre de noms demandés ; 0 les demande tous.
+ * @return          Vrai si la vérification doit être faite.
+ */
+bool estDemandee(const char *nom, char **demandes, int nb) {
+	for (int i = 0; i < nb; i++) {
+		if (strcmp(demandes[i], nom) == 0) {
+			return true;
+		}
+	}
+
+	return nb == 0;
+}
+
+int main(int argc, char **argv) {
+	hoteEnregistrer(false);												// Les vérifications suivent les pas elles-mêmes.
+	int nbEchecs = 0;
+
+	for (int i = 0; i < nbVerifications; i++) {
+		if (!estDemandee(verifications[i].nom, argv + 1, argc - 1)) {
+			continue;
+		}
+
+		char mesure[256] = "";
+		bool reussie = verifications[i].verifier(mesure, sizeof(mesure));
+		nbEchecs += reussie ? 0 : 1;
+		printf("%s : %s, %s\n", verifications[i].nom, reussie ? "réussie" : "ÉCHEC", mesure);
+	}
+
+	printf("%d échec%s\n", nbEchecs, nbEchecs > 1 ? "s" : "");
+	return nbEchecs == 0 ? 0 : 1;
+}
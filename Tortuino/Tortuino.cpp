@@ -1,9 +1,12 @@
 
-# include <SD.h>
-# include <SPI.h>
 # include <Tortuino.h>
-# include <Stepper.h>
-# include <Servo.h>
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoOdometrie.h"
+# include "TortuinoMesures.h"
+# include "TortuinoPilote.h"
 # include <math.h>
 
 
@@ -112,38 +115,60 @@
 
 
 
-const int stepsPerRevolution	=	64 * 64 / 2;	/**< Le nombre de pas par tour que réalise un moteur pas à pas ; c'est une donnée constructeur. */
-	  float	PERIMETER	=	M_PI * 9.2,				/**< Le périmètre des roues du robot tel que mesuré avec le pneu. */
-			BRAQUAGE	=	11.3 / 2;				/**< Le rayon de braquage du robot. C'est une valeur qui peut être amenée à être calibrée. */
-
-const int	FEUTRE_HAUT	=	50,						/**< L'angle de la position haute du servomoteur. Il a été ajusté empiriquement. */
-			FEUTRE_BAS	=	10;						/**< L'angle de la position basse du servomoteur. Il a été ajusté empiriquement. */
-
-const int	portBouton	=	7,						/**< Le numéro de la broche qui sert de port pour le bouton permettant le démarrage différé : 7. */
-			portServo	=	9;						/**< Le numéro de la broche pour le port du servomoteur : 9. */
+const int stepsPerRevolution	=	PAS_PAR_TOUR_28BYJ48;	/**< Le nombre de pas par tour que réalise un moteur pas à pas ; c'est une donnée constructeur, doublée en demi-pas. */
+const float	PERIMETER	=	ProfilStandard::perimetre();	/**< Le périmètre des roues du robot tel que mesuré avec le pneu. La géométrie de chaque robot est décrite dans TortuinoProfils.h. */
 
 const int	delaiEntreBouton	=	10;				/**< Le délai en ms entre chaque test du bouton. Sa petite valeur importe peu, mais le délai reste utile. */
 const int	delaiApresBouton	=	500;			/**< Le délai en ms effectué après que le bouton ait été pressé. Il permet d'éviter que l'utilisateur
 														se coince le doigt dans le câblage du robot au démarrage de l'exécution du programme de celui-ci. */
 
-const int 	delaiMonterDescendre	=	200;		/**< Le délai en ms d'attente après l'envoi d'une commande au feutre. Paramétré empiriquement. */
-
-Stepper stepperLeft = Stepper(stepsPerRevolution, 10, 12, 11, 13);	/**< L'objet qui sert à contrôler le moteur pas à pas de gauche et qui est relié aux ports 10 à 13. */
-Stepper stepperRight = Stepper(stepsPerRevolution, 2, 4, 3, 5);		/**< L'objet qui sert à contrôler le moteur pas à pas de droite et qui est relié aux ports 2 à 5. */
+const int	vitesseDemarrage		=	8;			/**< La vitesse en tours par minute à laquelle les moteurs démarrent et s'arrêtent sans décrocher. Paramétrée empiriquement. */
+const int	accelerationTrace		=	15,			/**< L'accélération en tours par minute par seconde des tracés : elle reste douce pour garder un trait propre. */
+			accelerationDeplacement	=	25;			/**< L'accélération en tours par minute par seconde des déplacements feutre levé, plus franche. */
+const float	longueurMaxArc			=	100;		/**< La longueur maximale en centimètres parcourue par une roue en un seul mouvement d'arc, pour que son nombre de pas tienne en Q16.16. */
 
-Servo servo;										/**< L'objet qui sert à contrôler le servomoteur soulevant et abaissant le feutre du robot. */
+float		toleranceContinu		=	0;			/**< La tolérance du mode continu choisie par continu(float tolerance), ou 0 s'il est désactivé. */
+float		vitesseJonction			=	0;			/**< La vitesse du feutre en centimètres par seconde à laquelle le mouvement précédent s'est terminé, ou 0 s'il s'est arrêté. */
+bool		sansAttente				=	false;		/**< Vrai pendant qu'une commande est démarrée par demarrerProchaine(), qui n'attend pas la fin des mouvements. */
 
 
 /**
  * Réalise la conversion d'une distance que le robot peut parcourir en un certain nombre de pas que
  * chacun des deux moteurs pas à pas doit effectuer pour que le robot puisse avancer de la distance
- * donnée. Cette conversion prend en compte les paramètres décrivant la géométrie du robot.
+ * donnée. Cette conversion prend en compte les paramètres décrivant la géométrie du robot, au
+ * travers du facteur en virgule fixe calculé par odometrieGeometrie(). Les mouvements eux-mêmes
+ * passent par TortuinoOdometrie.cpp qui reporte en plus les fractions de pas d'un mouvement à
+ * l'autre ; cette fonction ne sert plus qu'à donner un ordre de grandeur.
  * 
  * @param  distance La distance linéaire en centimètres correspondant à un déplacement.
  * @return          Le nombre de pas permettant de réaliser le déplacement de la distance donnée.
  */
 int distanceToStep(float distance) {
-	return (int)(distance / PERIMETER * stepsPerRevolution);
+	return multiplierQ16(versQ16(distance), odometriePasParCentimetre()) / 65536;
+}
+
+/**
+ * Convertit une vitesse de rotation en tours par minute, ou une accélération en tours par minute
+ * par seconde, en pas par seconde, ou respectivement en pas par seconde au carré.
+ *
+ * @param  tours La vitesse en tours par minute.
+ * @return       La vitesse correspondante en pas par seconde.
+ */
+float toursVersPas(float tours) {
+	return tours * stepsPerRevolution / 60;
+}
+
+/**
+ * Attend pendant une durée donnée, en continuant de faire les tâches de fond des attentes de la
+ * bibliothèque, comme la réception de TortuinoLiaison.cpp.
+ *
+ * @param ms La durée en millisecondes.
+ */
+void patienter(unsigned long ms) {
+	unsigned long debut = materielMillis();
+	while (materielMillis() - debut < ms) {
+		moteursPatienter();
+	}
 }
 
 /**
@@ -151,7 +176,8 @@ int distanceToStep(float distance) {
  * composants qui le constituent : le servomoteur, les moteurs pas à pas et le bouton de démarrage différé.
  * Au cours de cette configuration, elle met le robot dans un état standard qui sera ainsi toujours le
  * même au début de l'exécution de chaque essai : la vitesse de rotation des moteurs pas à pas est par
- * défaut de 10 et le feutre est en position basse. Cette fonction à sa fin fait appel à attendreBouton()
+ * défaut de 14 tours par minute pour tracer, de 18 pour se déplacer feutre levé, et le feutre est
+ * en position basse. Cette fonction à sa fin fait appel à attendreBouton()
  * qui bloquera tant que le bouton de démarrage différé n'est pas appuyé.<br/>
  * L'initialisation est une étape absolument nécessaire au bon fonctionnement du robot ; sans cela, la
  * carte Arduino que contrôle ces fonctions n'est pas en mesure de connaître les différents composants
@@ -162,11 +188,13 @@ int distanceToStep(float distance) {
  * contre-productif. Un seul appel est suffisant.
  */
 void initialiser() {
-	servo.attach(portServo);											// Affectation du port pour le servomoteur.
-	pinMode(portBouton, INPUT_PULLUP);									// Mode de la broche pour le bouton : entrée.
-	vitesse(10);														// Vitesse de rotation des moteurs pas à pas : 10.
+	CHRONO_EFFACER();													// Les chronomètres éventuels partent de là.
+	materielInitialiser();												// Configuration des ports du servomoteur, du bouton et des moteurs pas à pas.
+	vitesse(14);														// Vitesse de rotation des moteurs pas à pas pour tracer : 14,
+	vitesseDeplacement(18);												// et pour se déplacer feutre levé : 18.
 	descendreFeutre();													// Feutre en position basse.
 	attendreBouton();													// Attente du bouton de démarrage différé.
+	odometrieOrigine();													// Les coordonnées partent de là où le robot a été posé.
 }
 
 /**
@@ -175,8 +203,8 @@ void initialiser() {
  * Le choix qui a été fait ici est de donner à chaque robot une couleur (par exemple de la plaquette
  * d'expérimentation électrique) représentée par la première lettre de son écriture et qui l'identifie
  * de manière unique. Ensuite, grâce à une correspondance établie au préalable, la valeur du rayon
- * de braquage est affectée par cette fonction, retrouvant ainsi le calibrage effectué. Voir le code
- * source pour bien comprendre comment ces associations sont réalisées.<br/>
+ * de braquage est affectée par cette fonction, retrouvant ainsi le calibrage effectué. Les profils
+ * de chaque couleur sont décrits dans TortuinoProfils.h.<br/>
  * Le reste de l'initialisation est bien entendu aussi réalisé.
  * 
  * @param couleur La première lettre de la couleur identifiant le robot utilisé.
@@ -184,23 +212,25 @@ void initialiser() {
  * @see initialiser(float braquage)
  */
 void initialiser(char couleur) {
-	if (couleur == 'w') {												// On teste simplement quelle valeur a la couleur
-		BRAQUAGE = 11.3 / 2;
-	}
-	else if (couleur == 'j') {											// parmi un ensemble donné qui permet surtout de récupérer
-		BRAQUAGE = 11.3 / 2;											// son association à un rayon de braquage donné.
-	}
-	else if (couleur == 'b') {
-		BRAQUAGE = 11 / 2;
-	}
-	else if (couleur == 'v') {
-		BRAQUAGE = 10.5 / 2;
-	}
-	else if (couleur == 'r') {
-		BRAQUAGE = 11.3 / 2;
-	}
-	else if (couleur == 'n') {
-		BRAQUAGE = 11.3 / 2;
+	switch (couleur) {													// On teste simplement quelle valeur a la couleur
+		case 'w':														// parmi un ensemble donné qui permet surtout de récupérer
+			odometrieProfil(ProfilBlanc::geometrie());					// son profil, dont tous les facteurs de conversion
+			break;														// ont été calculés à la compilation.
+		case 'j':
+			odometrieProfil(ProfilJaune::geometrie());
+			break;
+		case 'b':
+			odometrieProfil(ProfilBleu::geometrie());
+			break;
+		case 'v':
+			odometrieProfil(ProfilVert::geometrie());
+			break;
+		case 'r':
+			odometrieProfil(ProfilRouge::geometrie());
+			break;
+		case 'n':
+			odometrieProfil(ProfilNoir::geometrie());
+			break;
 	}
 	initialiser();														// Quel que soit l'entrée, on fait toujours la partie principale de l'initialisation.
 }
@@ -227,7 +257,7 @@ void initialiser(char couleur) {
  * @see initialiser(char couleur)
  */
 void initialiser(float braquage) {
-	BRAQUAGE = braquage / 2;											// On transforme le diamètre fourni en le rayon à utiliser.
+	odometrieCalibrer(PERIMETER, braquage / 2, stepsPerRevolution);		// On transforme le diamètre fourni en le rayon à utiliser.
 	initialiser();														// On continue avec la partie principale de l'initialisation.
 }
 
@@ -241,18 +271,22 @@ void initialiser(float braquage) {
  * le départ du robot.
  */
 void attendreBouton() {
-	int oldState, newState = digitalRead(portBouton);					// On initialise newState à l'état actuel de la broche du bouton.
+	terminer();															// Ce qui a été demandé avant doit être fini avant d'attendre.
+
+	CHRONO_PHASE(CHRONO_BOUTON, phasePrecedente);
+	bool oldState, newState = materielBoutonAppuye();					// On initialise newState à l'état actuel du bouton.
 
 	while (true) {
 		oldState = newState;											// On sauvegarde l'état précedant dans oldState,
-		newState = digitalRead(portBouton);								// et on met à jour l'actuel dans newState.
+		newState = materielBoutonAppuye();								// et on met à jour l'actuel dans newState.
 
-		if (oldState == LOW && newState == HIGH) {						// Si les deux correspondent à un front descendant,
-			delay(delaiApresBouton);									// on attend un peu plus, pour ne pas surprendre
+		if (oldState && !newState) {									// Si le bouton vient d'être relâché,
+			patienter(delaiApresBouton);								// on attend un peu plus, pour ne pas surprendre
+			CHRONO_REPRENDRE(phasePrecedente);
 			return;														// et on met fin à l'attente;
 		}
 
-		delay(delaiEntreBouton);										// sinon, on attend un petit peu et on teste à nouveau;
+		patienter(delaiEntreBouton);									// sinon, on attend un petit peu et on teste à nouveau;
 	}
 }
 
@@ -264,44 +298,195 @@ void attendreBouton() {
  * Si par contre une simple pause est voulue, plusieurs options sont possibles, comme par exemple
  * utiliser <a href="https://www.arduino.cc/reference/en/language/functions/time/delay/">delay()</a>
  * pour attendre d'une durée donnée, puis continuer le flot d'exécution ; ou aussi attendreBouton()
- * qui attend indéfiniment l'appui du bouton du robot et après rend la main.
+ * qui attend indéfiniment l'appui du bouton du robot et après rend la main.<br/>
+ * Si la bibliothèque est chronométrée, le rapport de rapporter() est envoyé avant l'arrêt.
  */
 void stopper(){
+	terminer();															// On finit d'abord ce qui a été demandé.
+	rapporter();
+
 	while (true){														// Tout le temps
-		delay(delaiEntreBouton);										// on attend un petit peu.
+		patienter(delaiEntreBouton);									// on attend un petit peu.
 	}
 }
 
 /**
- * Règle la vitesse de rotation des moteurs pas à pas. Une valeur de 10 est largement suffisante.
- * Cette fonction n'est actuellement pas considérée comme intéressante à utilser en dehors du
- * fonctionnement interne de cette bibliothèque. Elle est pour l'instant seulement appelée par
- * initialiser() qui s'occupe de régler le robot pour avoir une vitesse par défaut qui fonctionne
- * tout à fait correctement pour le robot ainsi paramétré.
+ * Envoie sur la liaison série, au débit de 115200 bits par seconde, le rapport des chronomètres de
+ * TortuinoMesures.cpp : le temps passé par la bibliothèque à calculer, à attendre les pas des
+ * moteurs, le feutre ou le bouton, et celui de chaque type de commande. Elle peut être appelée
+ * à tout moment, par exemple entre deux dessins ; les commandes encore en attente ne sont pas
+ * exécutées avant. Elle ne fait rien tant que TORTUINO_CHRONOS n'est pas défini dans
+ * TortuinoMesures.h, ce qui est le cas par défaut.
+ *
+ * @see stopper()
+ */
+void rapporter() {
+	CHRONO_RAPPORT();
+}
+
+/**
+ * Règle la vitesse maximale de rotation des moteurs pas à pas lorsque le feutre est baissé, en
+ * tours par minute. Chaque mouvement démarre à vitesseDemarrage, accélère jusqu'à cette vitesse,
+ * puis décélère avant de s'arrêter : les moteurs ne décrochent donc pas, même à une vitesse que
+ * l'on ne pourrait pas atteindre d'un coup. Elle est appelée par initialiser() qui s'occupe de
+ * régler le robot pour avoir une vitesse par défaut qui fonctionne tout à fait correctement pour
+ * le robot ainsi paramétré.
  * 
  * @param v La valeur entière de la vitesse à affecter aux moteurs pas à pas.
+ * @see vitesseDeplacement(int v)
  */
 void vitesse(int v) {
-	stepperRight.setSpeed(v);											// Les moteurs pas à pas gauche
-	stepperLeft.setSpeed(v);											// et droite prennent la même valeur de vitesse donnée.
+	moteursProfil(PROFIL_TRACE, toursVersPas(vitesseDemarrage), toursVersPas(v), toursVersPas(accelerationTrace));
 }
 
 /**
- * Fait avancer le robot Tortuino d'une distance donnée.
- * @param distance La distance en centimètres à parcourir.
- * @see reculer(float distance)
+ * Règle la vitesse maximale de rotation des moteurs pas à pas lorsque le feutre est levé, en
+ * tours par minute. Ces déplacements ne laissent aucun trait, ils peuvent donc se faire à la
+ * vitesse la plus élevée que les moteurs supportent sans perdre de pas, comme par exemple les
+ * retours en arrière de arbreAsymetrique() ou les repositionnements de triangleSierpinski().
+ * 
+ * @param v La valeur entière de la vitesse à affecter aux moteurs pas à pas.
+ * @see vitesse(int v)
  */
-void avancer(float distance) {
-	int steps = distanceToStep(fabs(distance));							// On convertit la distance en nombre de pas à faire;
-	int sens = 1;														// et on met le sens par défaut vers l'avant.
-	if (distance < 0) {													// Si la distance est négative,
-		sens = -1;														// on met le sens vers l'arrière.
+void vitesseDeplacement(int v) {
+	moteursProfil(PROFIL_DEPLACEMENT, toursVersPas(vitesseDemarrage), toursVersPas(v), toursVersPas(accelerationDeplacement));
+}
+
+/**
+ * Indique le profil de vitesse que doit suivre le prochain mouvement selon la position du feutre.
+ *
+ * @return PROFIL_DEPLACEMENT si le feutre est levé, PROFIL_TRACE sinon.
+ */
+unsigned char profilCourant() {
+	return feutreEstLeve() ? PROFIL_DEPLACEMENT : PROFIL_TRACE;
+}
+
+/**
+ * Calcule, pour un mouvement en attente, le nombre de pas que fait chaque roue par centimètre
+ * parcouru par le feutre. Ces rapports fixent la vitesse de chaque roue pour une vitesse du feutre
+ * donnée, ce qui permet de comparer deux mouvements à leur jonction.
+ *
+ * @param commande  Le déplacement ou l'arc.
+ * @param rapports  Reçoit le rapport de la roue gauche puis celui de la roue droite, signés.
+ * @return          La longueur en centimètres du premier mouvement des moteurs de la commande.
+ */
+float rapportsRoues(const Commande &commande, float *rapports) {
+	float pasParCentimetre = odometriePasParCentimetre() / 65536.0;
+	float sens = commande.type == COMMANDE_ARC ? (commande.rayon < 0 ? -1 : 1) : (commande.valeur < 0 ? -1 : 1);
+	float rotation = 0, longueur = fabs(commande.valeur);
+	if (commande.type == COMMANDE_ARC) {								// Une roue va plus vite que le feutre, l'autre moins.
+		float radians = fabs(commande.valeur) * M_PI / 180;
+		rotation = odometrieGeometrie().braquage / fabs(commande.rayon) * (commande.valeur < 0 ? -1 : 1);
+		longueur = fabs(commande.rayon) * radians / ceil((fabs(commande.rayon) + odometrieGeometrie().braquage) * radians / longueurMaxArc);
+	}
+
+	rapports[0] = pasParCentimetre * (rotation - sens);					// Les moteurs se font face : la roue gauche
+	rapports[1] = pasParCentimetre * (rotation + sens);					// tourne à l'envers pour avancer.
+	return longueur;
+}
+
+/**
+ * Choisit la vitesse du feutre à laquelle le mouvement qui démarre peut s'enchaîner avec la
+ * prochaine commande de la file, sans que le robot s'arrête entre les deux. C'est la plus grande
+ * vitesse telle que :
+ * - aucune roue ne dépasse sa vitesse maximale, ni dans l'un, ni dans l'autre mouvement ;
+ * - aucune roue ne change de vitesse de plus que la vitesse de démarrage à la jonction, ce que les
+ *   moteurs encaissent sans décrocher, comme au démarrage ;
+ * - le mouvement qui démarre a la place d'y accélérer, et le suivant celle de s'arrêter ensuite.
+ *
+ * @param  pasGauche Le nombre de pas signé de la roue gauche pour le mouvement qui démarre.
+ * @param  pasDroite Le nombre de pas signé de la roue droite pour le mouvement qui démarre.
+ * @param  longueur  La longueur en centimètres que parcourt le feutre pendant ce mouvement.
+ * @return           La vitesse du feutre en centimètres par seconde à la jonction, ou 0 si le
+ * 					 robot doit s'y arrêter.
+ */
+float vitesseEnchainement(long pasGauche, long pasDroite, float longueur) {
+	const Commande *prochaine = commandesProchaine();
+	if (toleranceContinu <= 0 || feutreEstLeve() || longueur <= 0 || prochaine == NULL
+			|| (prochaine->type != COMMANDE_AVANCER && prochaine->type != COMMANDE_ARC) || prochaine->feutreLeve) {
+		return 0;														// Seuls les tracés s'enchaînent entre eux.
 	}
 
-	for (int i = 0; i < steps; i++) {									// On fait tous les pas à réaliser un par un :
-		stepperRight.step(sens);										// la roue gauche d'abord,
-		stepperLeft.step(-sens);										// la droite ensuite.
+	float limites[3], suivants[2];
+	moteursLimites(PROFIL_TRACE, limites);
+	float longueurSuivante = rapportsRoues(*prochaine, suivants);
+	if (prochaine->type == COMMANDE_AVANCER) {							// Un coin arrondi peut encore raccourcir
+		longueurSuivante /= 2;											// le prochain déplacement de moitié.
 	}
+
+	float rapportGauche = pasGauche / longueur, rapportDroite = pasDroite / longueur;
+	float maxCourant = fmax(fabs(rapportGauche), fabs(rapportDroite));
+	float maxSuivant = fmax(fabs(suivants[0]), fabs(suivants[1]));
+	float entree = vitesseJonction > 0 ? vitesseJonction * maxCourant : limites[0];
+
+	float vitesse = limites[1] / fmax(maxCourant, maxSuivant);
+	vitesse = fmin(vitesse, limites[0] / fmax(fabs(rapportGauche - suivants[0]), fabs(rapportDroite - suivants[1])));
+	vitesse = fmin(vitesse, sqrt(limites[0] * limites[0] + 2 * limites[2] * maxSuivant * longueurSuivante) / maxSuivant);
+	vitesse = fmin(vitesse, sqrt(entree * entree + 2 * limites[2] * maxCourant * longueur) / maxCourant);
+
+	if (vitesse * maxCourant <= limites[0] || vitesse * maxSuivant <= limites[0]) {
+		return 0;														// Enchaîner si lentement ne ferait rien gagner.
+	}
+	return vitesse;
+}
+
+/**
+ * Confie un mouvement aux moteurs. Si le mode continu le permet, il démarre à la vitesse à
+ * laquelle le précédent s'est terminé et s'enchaîne au suivant sans s'arrêter ; sinon, il démarre
+ * et s'arrête lentement, et l'on attend sa fin si c'est le dernier d'une commande.
+ *
+ * @param pasGauche Le nombre de pas signé de la roue gauche.
+ * @param pasDroite Le nombre de pas signé de la roue droite.
+ * @param longueur  La longueur en centimètres que parcourt le feutre pendant ce mouvement.
+ * @param dernier   Vrai si c'est le dernier mouvement de la commande en cours.
+ */
+void mouvoir(long pasGauche, long pasDroite, float longueur, bool dernier) {
+	if (!moteursOccupes()) {											// Le mouvement précédent est sans doute fini : autant
+		vitesseJonction = 0;											// planifier une vraie rampe. S'il finit juste après ce
+	}																	// test, l'interruption le verra en sortant le segment.
+	float sortie = dernier ? vitesseEnchainement(pasGauche, pasDroite, longueur) : 0;
+
+	if (vitesseJonction == 0 && sortie == 0) {
+		moteursAjouter(pasGauche, pasDroite, profilCourant());
+	}
+	else {
+		float maxRoues = (labs(pasGauche) > labs(pasDroite) ? labs(pasGauche) : labs(pasDroite)) / longueur;
+		moteursAjouterEnchaine(pasGauche, pasDroite, PROFIL_TRACE, vitesseJonction * maxRoues, sortie * maxRoues);
+	}
+
+	vitesseJonction = sortie;
+	if (dernier && sortie == 0 && !sansAttente) {						// Le robot ne s'arrête qu'à la fin d'une commande
+		moteursAttendre();												// qui ne s'enchaîne pas à la suivante.
+	}
+}
+
+/**
+ * Réalise effectivement un déplacement en ligne droite, qu'il soit vers l'avant ou l'arrière.
+ * C'est ce qu'exécute une commande d'avancer() une fois sortie de la file d'attente.
+ *
+ * @param distance La distance en centimètres à parcourir, négative pour reculer.
+ */
+void deplacer(float distance) {
+	long pasGauche, pasDroite;
+	odometrieTranslation(versQ16(distance), pasGauche, pasDroite);		// On convertit la distance en nombre de pas à faire pour chaque roue.
+
+	MESURE_DEPLACEMENT(distance, feutreEstLeve());
+	feutreAttendrePose();												// Un tracé ne démarre pas avant que le feutre soit posé.
+	mouvoir(pasGauche, pasDroite, fabs(distance), true);				// Les deux roues tournent en même temps, en sens opposés car les moteurs se font face,
+}																		// et on attend la fin du mouvement s'il ne s'enchaîne pas au suivant.
+
+/**
+ * Fait avancer le robot Tortuino d'une distance donnée. La commande passe par la file d'attente
+ * de TortuinoCommandes.cpp, qui l'exécute immédiatement sauf si une fenêtre d'anticipation est
+ * ouverte.
+ *
+ * @param distance La distance en centimètres à parcourir.
+ * @see reculer(float distance)
+ * @see anticipation(int nbCommandes)
+ */
+void avancer(float distance) {
+	MESURE_PRIMITIVE();
+	commandesAjouter(COMMANDE_AVANCER, distance);
 }
 
 /**
@@ -313,6 +498,22 @@ void reculer(float distance) {
 	avancer(-distance);													// On réutilise la généralisation faite dans avancer().
 }
 
+/**
+ * Réalise effectivement une rotation sur place, qu'elle soit vers la gauche ou la droite.
+ * C'est ce qu'exécute une commande de tournerGauche() une fois sortie de la file d'attente.
+ *
+ * @param angle L'angle en degrés de rotation vers la gauche à effectuer, négatif vers la droite.
+ */
+void pivoter(float angle) {
+	long pasGauche, pasDroite;
+	odometrieRotation(versQ16(angle), pasGauche, pasDroite);			// On récupère le nombre de pas correspondant à la longueur de l'arc décrit par l'angle donné.
+
+	moteursAjouter(pasGauche, pasDroite, profilCourant());				// Les deux roues tournent en même temps et dans le même sens de rotation,
+	if (!sansAttente) {
+		moteursAttendre();												// et on attend la fin du mouvement.
+	}
+}
+
 /**
  * Fait tourner sur place le robot Tortuino d'un angle fourni vers sa gauche. La rotation
  * s'effectue autour de l'axe que décrit le feutre positionné dans l'emplacement prévu à cet
@@ -326,16 +527,8 @@ void reculer(float distance) {
  * @see tournerDroite(float angle)
  */
 void tournerGauche(float angle) {
-	int steps = distanceToStep(M_PI / 180 * fabs(angle) * BRAQUAGE);	// On récupère le nombre de pas correspondant à la longueur de l'arc décrit par l'angle donné
-	int sens = 1;														// et on met le sens par défaut vers la gauche.
-	if (angle < 0) {													// Si l'angle est négatif,
-		sens = -1;														// on met le sens vers la droite.
-	}
-
-	for (int i = 0; i < steps; i++) {									// On fait tous les pas à réaliser un par un :
-		stepperRight.step(sens);										// la roue droite d'abord,
-		stepperLeft.step(sens);											// la gauche ensuite.
-	}
+	MESURE_PRIMITIVE();
+	commandesAjouter(COMMANDE_TOURNER, angle);							// Comme pour avancer(), la rotation passe par la file d'attente.
 }
 
 /**
@@ -354,28 +547,290 @@ void tournerDroite(float angle) {
 	tournerGauche(-angle);												// On réutilise la généralisation faite dans tournerGauche().
 }
 
+/**
+ * Réalise effectivement un arc de cercle. C'est ce qu'exécute une commande de arcGauche() une
+ * fois sortie de la file d'attente. Les deux roues tournent en même temps à des cadences
+ * différentes, entrelacées par l'interruption des moteurs : l'arc est tracé d'un seul mouvement,
+ * sans s'arrêter. Seul un très grand arc est découpé en quelques mouvements.
+ *
+ * @param rayon Le rayon en centimètres de l'arc décrit par le feutre, négatif pour reculer.
+ * @param angle L'angle en degrés dont le robot tourne vers la gauche, négatif vers la droite.
+ */
+void decrireArc(float rayon, float angle) {
+	float radians = fabs(angle) * M_PI / 180;
+	float roueExterieure = (fabs(rayon) + odometrieGeometrie().braquage) * radians;
+	int nbMorceaux = (int)ceil(roueExterieure / longueurMaxArc);
+	if (nbMorceaux < 1) {
+		nbMorceaux = 1;
+	}
+
+	MESURE_DEPLACEMENT(rayon * radians, feutreEstLeve());
+	feutreAttendrePose();												// Un tracé ne démarre pas avant que le feutre soit posé.
+	for (int i = 0; i < nbMorceaux && !piloteAbandonne(); i++) {		// Après un abandon, les morceaux restants ne sont pas comptés dans la pose.
+		long pasGauche, pasDroite;
+		odometrieArc(versQ16(rayon * radians / nbMorceaux), versQ16(angle / nbMorceaux), pasGauche, pasDroite);
+		mouvoir(pasGauche, pasDroite, fabs(rayon) * radians / nbMorceaux, i == nbMorceaux - 1);	// La roue qui fait le plus de pas suit le profil de vitesse,
+	}																	// l'autre est entrelacée avec elle.
+}
+
+/**
+ * Fait décrire au robot un arc de cercle vers sa gauche : le feutre suit un cercle de rayon
+ * donné, dont le centre est à gauche du robot, jusqu'à ce que le robot ait tourné de l'angle
+ * donné. Contrairement à une suite de avancer() et tournerGauche(), l'arc est tracé d'un seul
+ * mouvement continu. Un rayon nul revient à tournerGauche(), et un angle de 360° trace un cercle
+ * complet.
+ *
+ * @param rayon Le rayon en centimètres de l'arc, négatif pour le parcourir en reculant.
+ * @param angle L'angle en degrés de l'arc, c'est-à-dire de la rotation du robot vers la gauche.
+ * @see arcDroite(float rayon, float angle)
+ */
+void arcGauche(float rayon, float angle) {
+	MESURE_PRIMITIVE();
+	commandesAjouter(COMMANDE_ARC, angle, rayon);
+}
+
+/**
+ * Fait décrire au robot un arc de cercle vers sa droite, dont le centre est à droite du robot.
+ *
+ * @param rayon Le rayon en centimètres de l'arc, négatif pour le parcourir en reculant.
+ * @param angle L'angle en degrés de l'arc, c'est-à-dire de la rotation du robot vers la droite.
+ * @see arcGauche(float rayon, float angle)
+ */
+void arcDroite(float rayon, float angle) {
+	arcGauche(rayon, -angle);											// On réutilise la généralisation faite dans arcGauche().
+}
+
 /**
  * Place le feutre en position haute de telle manière qu'il ne touche pas la feuille en-dessous
  * du robot, en supposant que le collier le tenant et permettant ce déplacement soit correctement
  * ajusté. Cela permet de choisir quand est-ce que l'on souhaite dessiner ou non, car à certains
  * moments, par exemple si l'on veut se replacer pour continuer une autre partie d'un dessin, cela
- * se révèle assez utile.
+ * se révèle assez utile. Le déplacement qui suit démarre sans attendre que le feutre ait fini de
+ * monter, et rien n'est fait si le feutre est déjà en position haute.
  *
  * @see descendreFeutre()
  */
 void monterFeutre() {
-	servo.write(FEUTRE_HAUT);											// Mise à la position haute du feutre.
-	delay(delaiMonterDescendre);										// Petit délai pour attendre que le mouvement du servomoteur se termine à coup sûr.
+	MESURE_PRIMITIVE();
+	commandesAjouter(COMMANDE_MONTER_FEUTRE, 0);
 }
 
 /**
  * Place le feutre en position basse de telle manière qu'il touche la feuille en-dessous du
  * robot, en supposant que le collier le tenant et permettant ce déplacement soit correctement
- * ajusté.
+ * ajusté. Seul un tracé qui suivrait attend que le feutre soit bien posé sur la feuille, et rien
+ * n'est fait si le feutre est déjà en position basse.
  *
  * @see monterFeutre()
  */
 void descendreFeutre() {
-	servo.write(FEUTRE_BAS);											// Mise à la position basse du feutre.
-	delay(delaiMonterDescendre);										// Petit délai pour attendre que le mouvement du servomoteur se termine à coup sûr.
+	MESURE_PRIMITIVE();
+	commandesAjouter(COMMANDE_DESCENDRE_FEUTRE, 0);
+}
+
+/**
+ * Emmène le robot à un point donné par ses coordonnées, par le plus court chemin : il tourne sur
+ * place vers le point, puis avance en ligne droite jusqu'à lui. S'il lui faut tourner de plus de
+ * 90°, il tourne plutôt dans l'autre sens et recule, ce qui trace le même trait. Les coordonnées
+ * sont en centimètres depuis l'endroit où initialiser() a laissé le robot : l'axe des abscisses
+ * suit son cap de départ, celui des ordonnées part vers sa gauche. Le trajet est calculé d'après
+ * les pas que les roues ont réellement faits, suivis par TortuinoOdometrie.cpp : un dessin peut
+ * donc revenir exactement à son point de départ sans recalculer ses longueurs, par exemple :
+ *
+ * {@code
+ * 	polygoneRegulier(7, 5);				// Un côté de 5cm ne se referme pas sur un nombre rond,
+ * 	monterFeutre();
+ * 	allerA(0, 0);						// mais on revient pourtant pile au départ,
+ * 	orienter(0);						// dans la même direction.
+ * }
+ *
+ * Les commandes encore en attente sont d'abord exécutées, comme avec terminer(), pour que la
+ * position du robot soit connue.
+ *
+ * @param x L'abscisse en centimètres du point à atteindre.
+ * @param y Son ordonnée en centimètres.
+ * @see orienter(float cap)
+ * @see position()
+ */
+void allerA(float x, float y) {
+	commandesVider();													// Le point de départ est celui où mènent les commandes en attente.
+	const Pose &pose = odometriePose();
+
+	int32_t direction;
+	int32_t distance = polaireQ16(versQ16(x) - pose.x, versQ16(y) - pose.y, direction);
+	if (distance < versQ16(0.01)) {										// Le robot y est déjà, à un dixième de millimètre près.
+		return;
+	}
+
+	int32_t virage = normaliserAngleQ16(direction - pose.cap);
+	if (virage > versQ16(90)) {											// Il est plus court de tourner dans l'autre sens
+		virage -= versQ16(180);											// et de reculer.
+		distance = -distance;
+	}
+	else if (virage < versQ16(-90)) {
+		virage += versQ16(180);
+		distance = -distance;
+	}
+
+	tournerGauche(virage / 65536.0);									// La file supprime le virage s'il est nul.
+	avancer(distance / 65536.0);
+}
+
+/**
+ * Tourne le robot sur place vers un cap donné, du plus petit angle possible. Comme pour
+ * allerA(float x, float y), les commandes encore en attente sont d'abord exécutées.
+ *
+ * @param cap Le cap en degrés à prendre, compté vers la gauche depuis le cap qu'avait le robot
+ * 			  après initialiser().
+ * @see allerA(float x, float y)
+ */
+void orienter(float cap) {
+	commandesVider();
+	tournerGauche(normaliserAngleQ16(versQ16(cap) - odometriePose().cap) / 65536.0);
+}
+
+/**
+ * Donne la position et le cap du robot depuis initialiser(), d'après les pas que ses roues
+ * auront faits une fois finis les mouvements déjà confiés aux moteurs. Comme pour
+ * allerA(float x, float y), les commandes encore en attente sont d'abord exécutées : avec les
+ * fonctions bloquantes, c'est donc là où le robot se trouve ; après piloteDemarrer(), c'est là où
+ * il va, le dernier mouvement pouvant être encore en cours. Les pas qu'un abandon empêche de
+ * faire en sont retirés par piloteReprendre().
+ *
+ * @return Les coordonnées en centimètres du robot, et son cap en degrés vers la gauche entre -180°
+ * 		   exclu et 180° inclus.
+ * @see allerA(float x, float y)
+ */
+Position position() {
+	commandesVider();
+	const Pose &pose = odometriePose();
+
+	Position actuelle;
+	actuelle.x = pose.x / 65536.0;
+	actuelle.y = pose.y / 65536.0;
+	actuelle.cap = pose.cap / 65536.0;
+	return actuelle;
+}
+
+/**
+ * Exécute une commande sortie de la file d'attente de TortuinoCommandes.cpp en appelant la
+ * fonction qui la réalise effectivement.
+ *
+ * @param commande La commande à exécuter.
+ */
+void executerCommande(const Commande &commande) {
+	if (piloteAbandonne()) {											// Après un abandon, plus rien ne bouge
+		piloteLeverFeutre();											// et le feutre quitte la feuille.
+		return;
+	}
+	if (vitesseJonction == 0) {											// Le mouvement précédent a pu être démarré par
+		moteursAttendre();												// demarrerProchaine() : il doit d'abord finir.
+	}
+
+	MESURE_COMMANDE(commande);
+	CHRONO_PHASE(CHRONO_CALCUL, phasePrecedente);
+	CHRONO_DEBUT(debut);
+	switch (commande.type) {
+		case COMMANDE_AVANCER:
+			deplacer(commande.valeur);
+			break;
+		case COMMANDE_TOURNER:
+			pivoter(commande.valeur);
+			break;
+		case COMMANDE_ARC:
+			decrireArc(commande.rayon, commande.valeur);
+			break;
+		case COMMANDE_MONTER_FEUTRE:
+			feutrePositionner(true);
+			break;
+		case COMMANDE_DESCENDRE_FEUTRE:
+			feutrePositionner(false);
+			break;
+	}
+	CHRONO_PRIMITIVE(commande.type, debut);
+	CHRONO_REPRENDRE(phasePrecedente);
+}
+
+/**
+ * Indique si une commande peut démarrer sans attendre : les moteurs doivent être arrêtés, à moins
+ * qu'elle ne s'enchaîne au mouvement en cours et qu'il y ait de la place dans leur file, et un
+ * tracé ne démarre qu'une fois le feutre posé.
+ *
+ * @param  commande La commande.
+ * @return          Vrai si elle peut démarrer immédiatement.
+ */
+bool commandePrete(const Commande &commande) {
+	if (piloteAbandonne()) {											// Elle ne sera pas exécutée.
+		return true;
+	}
+	if (moteursOccupes() && (vitesseJonction == 0 || !moteursPlaceLibre())) {
+		return false;
+	}
+
+	return commande.type == COMMANDE_MONTER_FEUTRE || commande.type == COMMANDE_DESCENDRE_FEUTRE || feutreEstPose();
+}
+
+/**
+ * Démarre la prochaine commande de la file de TortuinoCommandes.cpp si elle est prête, sans
+ * attendre la fin de ses mouvements. C'est ainsi que TortuinoPilote.cpp fait avancer les
+ * commandes sans jamais bloquer : seul un très grand arc, découpé en plusieurs mouvements, peut
+ * attendre une place dans la file des moteurs.
+ *
+ * @return Vrai si une commande a été démarrée.
+ */
+bool demarrerProchaine() {
+	const Commande *prochaine = commandesProchaine();
+	if (prochaine == NULL || !commandePrete(*prochaine)) {
+		return false;
+	}
+
+	sansAttente = true;
+	commandesExecuterProchaine();
+	sansAttente = false;
+	return true;
+}
+
+/**
+ * Règle le nombre de commandes que la bibliothèque garde en attente avant de les exécuter. Tant
+ * qu'elles attendent, les commandes qui arrivent ensuite peuvent s'y combiner : deux rotations
+ * consécutives n'en font plus qu'une, deux déplacements dans le même sens aussi, et les
+ * mouvements nuls disparaissent. Le robot s'arrête ainsi moins souvent. Par défaut, aucune
+ * commande n'est gardée en attente, sauf pendant les dessins de TortuinoDessins.cpp.<br/>
+ * Attention : les dernières commandes d'un programme ne sont exécutées qu'à l'appel de terminer(),
+ * de stopper() ou de attendreBouton(). Il faut donc bien penser à en appeler un à la fin.
+ *
+ * @param nbCommandes Le nombre de commandes gardées en attente, de 0 à 16.
+ * @see terminer()
+ */
+void anticipation(int nbCommandes) {
+	commandesFenetre(nbCommandes);
+}
+
+/**
+ * Active le mode continu : les coins des tracés sont arrondis d'au plus la tolérance donnée, et
+ * le robot enchaîne les déplacements et arcs feutre baissé sans s'arrêter entre eux, en gardant à
+ * chaque jonction la plus grande vitesse que les moteurs supportent. Le dessin est un peu moins
+ * anguleux, mais bien plus rapide à tracer lorsqu'il a beaucoup de sommets, comme spiraleCarree().
+ * Seules les commandes gardées en attente peuvent être arrondies et enchaînées : le mode continu
+ * n'a donc d'effet que dans les dessins de TortuinoDessins.cpp, ou après anticipation(int
+ * nbCommandes). Le programme doit aussi fournir ses commandes à temps, car un mouvement enchaîné
+ * ne s'arrête pas en douceur si le suivant n'arrive pas.
+ *
+ * @param tolerance L'écart maximal en centimètres entre un coin arrondi et le sommet du dessin, ou
+ * 					0 pour désactiver le mode continu, ce qui est le cas par défaut.
+ * @see anticipation(int nbCommandes)
+ */
+void continu(float tolerance) {
+	toleranceContinu = tolerance > 0 ? tolerance : 0;
+	commandesArrondir(toleranceContinu);
+}
+
+/**
+ * Exécute toutes les commandes encore en attente et ne rend la main qu'une fois le robot arrêté.
+ * Elle n'est utile qu'après avoir appelé anticipation(int nbCommandes).
+ *
+ * @see anticipation(int nbCommandes)
+ */
+void terminer() {
+	commandesVider();
 }
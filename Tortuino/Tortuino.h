@@ -6,24 +6,41 @@
  * @author Paul Mabileau <paulmabileau@hotmail.fr>
  *
  * Ce fichier constitue l'en-tête de Tortuino.cpp. Il permet de préciser ce
- * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions.
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et le
+ * type de la position du robot.
  */
 
 
 # ifndef TORTUINO_h
 #	define TORTUINO_h
 	
+	struct Position {
+		float x;
+		float y;
+		float cap;
+	};
+
 	void initialiser();
 	void initialiser(float braquage);
 	void initialiser(char couleur);
 	void attendreBouton();
 	void stopper();
+	void rapporter();
 	void vitesse(int v);
+	void vitesseDeplacement(int v);
 	void avancer(float distance);
 	void reculer(float distance);
 	void tournerGauche(float angle);
 	void tournerDroite(float angle);
+	void arcGauche(float rayon, float angle);
+	void arcDroite(float rayon, float angle);
 	void monterFeutre();
 	void descendreFeutre();
+	void allerA(float x, float y);
+	void orienter(float cap);
+	Position position();
+	void anticipation(int nbCommandes);
+	void continu(float tolerance);
+	void terminer();
 	
 # endif
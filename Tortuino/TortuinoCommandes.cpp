@@ -0,0 +1,330 @@
+# include <math.h>
+# include <stddef.h>
+# include "TortuinoCommandes.h"
+# include "TortuinoMesures.h"
+# include "TortuinoEstimation.h"
+
+
+/**
+ * @file TortuinoCommandes.cpp
+ * @brief Ce fichier implémente la file d'attente qui simplifie les commandes avant de les exécuter.
+ * @version 1.0
+ *
+ * Le fichier TortuinoCommandes.cpp place les commandes de base (avancer, tourner, monter et
+ * descendre le feutre) dans une file d'attente avant de les exécuter. Tant qu'une commande
+ * attend son tour, celles qui arrivent après elle peuvent s'y combiner :
+ * - deux rotations consécutives n'en font plus qu'une, même si des commandes du feutre les
+ *   séparent, car tourner sur place ne trace rien ;
+ * - deux déplacements consécutifs faits avec le feutre levé n'en font plus qu'un, tout comme
+ *   deux déplacements dans le même sens faits avec le feutre baissé ;
+ * - de même, deux arcs consécutifs de même rayon n'en font plus qu'un, s'ils tournent dans le
+ *   même sens ou que le feutre est levé ;
+ * - les déplacements et rotations nuls sont supprimés avant d'atteindre les moteurs.
+ *
+ * Si une tolérance a été donnée à commandesArrondir(), la file arrondit en plus les coins des
+ * tracés : un déplacement feutre baissé, suivi d'une rotation d'au plus angleMaxArrondi puis d'un
+ * autre déplacement vers l'avant, devient un déplacement raccourci, un arc tangent aux deux côtés
+ * et un second déplacement raccourci. Le rayon de l'arc est le plus grand qui ne s'écarte pas du
+ * sommet de plus de la tolérance, sans prendre plus de la moitié de chaque côté. Le robot n'a
+ * alors plus à s'arrêter pour pivoter et peut garder sa vitesse dans le coin.
+ *
+ * Chacune de ces combinaisons évite un arrêt complet des moteurs suivi d'un redémarrage. Les
+ * dessins de TortuinoDessins.cpp en produisent beaucoup : par exemple arbreAsymetrique() enchaîne
+ * deux rotations à gauche entre deux niveaux, et sapin() en produit des nulles.<br/>
+ *
+ * La file n'exécute sa plus ancienne commande que lorsqu'elle dépasse la taille de sa fenêtre
+ * d'anticipation, ou lorsqu'elle est vidée par commandesVider(). Par défaut la fenêtre est vide :
+ * chaque commande est exécutée immédiatement, comme si la file n'existait pas, ce qui garantit
+ * qu'un croquis se terminant par une boucle `loop()` vide trace bien tout son dessin. Les dessins
+ * de TortuinoDessins.cpp ouvrent eux-mêmes une fenêtre le temps de leur tracé grâce à
+ * commandesOuvrir() et commandesFermer() ; l'utilisateur peut aussi le faire pour tout son
+ * programme avec anticipation(int nbCommandes), à condition d'appeler terminer() à la fin.<br/>
+ *
+ * En mode différé, choisi par commandesDifferer() pour TortuinoPilote.cpp, la file n'exécute plus
+ * rien d'elle-même, sauf pour faire de la place lorsqu'elle est pleine : c'est demarrerProchaine()
+ * qui en sort les commandes une à une, lorsque le robot est prêt à les démarrer sans attendre.
+ *
+ * @see commandesAjouter(unsigned char type, float valeur, float rayon)
+ */
+
+
+
+const int	tailleMaxCommandes	=	16;				/**< Le nombre maximal de commandes que la file peut garder en attente. */
+const int	fenetreDessins		=	8;				/**< La taille de la fenêtre qu'ouvrent les dessins lorsqu'aucune n'a été choisie. */
+const float	valeurNegligeable	=	0.0001;			/**< En dessous de cette valeur absolue, une commande de déplacement ou de rotation est nulle. */
+const float	angleMaxArrondi		=	135;			/**< L'angle en degrés au-delà duquel un coin est trop aigu pour être arrondi : l'arc prendrait tout le côté. */
+
+Commande	commandes[tailleMaxCommandes];			/**< Les commandes en attente, la plus ancienne en premier. */
+int			nbCommandes			=	0;				/**< Le nombre de commandes en attente. */
+int			fenetre				=	0;				/**< La taille actuelle de la fenêtre d'anticipation. */
+int			fenetreSauvegardee	=	0;				/**< La fenêtre à rétablir à la fermeture du dernier dessin ouvert. */
+int			nbDessinsOuverts	=	0;				/**< Le nombre d'appels imbriqués à commandesOuvrir() non encore refermés. */
+bool		feutreLeveFile		=	false;			/**< La position qu'aura le feutre une fois toutes les commandes en attente exécutées. */
+float		toleranceCoins		=	0;				/**< L'écart maximal en centimètres entre un coin arrondi et son sommet, ou 0 pour garder les coins. */
+bool		differee			=	false;			/**< Vrai en mode différé : la fenêtre est ignorée et les commandes attendent demarrerProchaine(). */
+
+
+/**
+ * Retire une commande de la file en décalant celles qui la suivent.
+ *
+ * @param indice L'indice de la commande à retirer.
+ */
+void retirerCommande(int indice) {
+	for (int i = indice; i < nbCommandes - 1; i++) {
+		commandes[i] = commandes[i + 1];
+	}
+	nbCommandes--;
+}
+
+/**
+ * Exécute puis retire la plus ancienne commande de la file.
+ */
+void executerPlusAncienne() {
+	Commande commande = commandes[0];									// On la copie d'abord, car son exécution
+	retirerCommande(0);													// pourrait en ajouter d'autres.
+	executerCommande(commande);
+}
+
+/**
+ * Tente de combiner une nouvelle commande avec celles déjà en attente.
+ *
+ * @param  type   Le type de la nouvelle commande.
+ * @param  valeur La valeur de la nouvelle commande.
+ * @param  rayon  Le rayon de la nouvelle commande, pour un arc.
+ * @return        Vrai si la commande a été absorbée par la file et n'a pas à y être ajoutée.
+ */
+bool combinerCommande(unsigned char type, float valeur, float rayon) {
+	if (type == COMMANDE_TOURNER) {
+		int i = nbCommandes - 1;
+		while (i >= 0 && (commandes[i].type == COMMANDE_MONTER_FEUTRE || commandes[i].type == COMMANDE_DESCENDRE_FEUTRE)) {
+			i--;														// Tourner sur place ne trace rien : on passe les commandes du feutre.
+		}
+
+		if (i >= 0 && commandes[i].type == COMMANDE_TOURNER) {			// Si une rotation est trouvée,
+			commandes[i].valeur += valeur;								// on y ajoute la nouvelle;
+			if (fabs(commandes[i].valeur) < valeurNegligeable) {		// et si elles s'annulent,
+				retirerCommande(i);										// il n'en reste rien.
+			}
+			return true;
+		}
+	}
+	else if (type == COMMANDE_AVANCER && nbCommandes > 0) {
+		Commande &derniere = commandes[nbCommandes - 1];
+
+		if (derniere.type == COMMANDE_AVANCER && derniere.feutreLeve == feutreLeveFile
+				&& (feutreLeveFile || (derniere.valeur > 0) == (valeur > 0))) {	// Un aller-retour feutre baissé trace quelque chose : on le garde.
+			derniere.valeur += valeur;
+			if (fabs(derniere.valeur) < valeurNegligeable) {
+				retirerCommande(nbCommandes - 1);
+			}
+			return true;
+		}
+	}
+	else if (type == COMMANDE_ARC && nbCommandes > 0) {
+		Commande &derniere = commandes[nbCommandes - 1];
+
+		if (derniere.type == COMMANDE_ARC && derniere.rayon == rayon && derniere.feutreLeve == feutreLeveFile
+				&& (feutreLeveFile || (derniere.valeur > 0) == (valeur > 0))) {	// Comme pour les déplacements.
+			derniere.valeur += valeur;
+			if (fabs(derniere.valeur) < valeurNegligeable) {
+				retirerCommande(nbCommandes - 1);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Tente d'arrondir le coin formé par les deux dernières commandes en attente et un nouveau
+ * déplacement : la rotation devient un arc et les deux déplacements sont raccourcis d'autant.
+ *
+ * @param  distance La distance du nouveau déplacement.
+ * @return          La distance qu'il reste à parcourir après l'arc, ou le déplacement inchangé si le
+ * 					coin ne peut être arrondi.
+ */
+float arrondirCoin(float distance) {
+	if (toleranceCoins <= 0 || feutreLeveFile || distance <= 0 || nbCommandes < 2) {
+		return distance;
+	}
+
+	Commande &cote = commandes[nbCommandes - 2];
+	Commande &rotation = commandes[nbCommandes - 1];
+	if (cote.type != COMMANDE_AVANCER || cote.feutreLeve || cote.valeur <= 0
+			|| rotation.type != COMMANDE_TOURNER || rotation.feutreLeve || fabs(rotation.valeur) > angleMaxArrondi) {
+		return distance;
+	}
+
+	float demiAngle = fabs(rotation.valeur) * M_PI / 360;
+	float rayon = toleranceCoins / (1 / cos(demiAngle) - 1);			// L'écart entre l'arc et le sommet vaut r (1 / cos(a / 2) - 1),
+	float retrait = rayon * tan(demiAngle);								// et l'arc commence à r tan(a / 2) du sommet.
+	float retraitMax = (cote.valeur < distance ? cote.valeur : distance) / 2;
+	if (retrait > retraitMax) {											// Sur des côtés courts, l'arc est plus serré.
+		retrait = retraitMax;
+		rayon = retrait / tan(demiAngle);
+	}
+
+	cote.valeur -= retrait;
+	rotation.type = COMMANDE_ARC;
+	rotation.rayon = rayon;
+	return distance - retrait;
+}
+
+/**
+ * Ajoute une commande à la file. Elle est d'abord combinée si possible avec celles déjà en
+ * attente ; puis, si la file dépasse sa fenêtre d'anticipation, les plus anciennes commandes
+ * sont exécutées.
+ *
+ * @param type   Le type de la commande : COMMANDE_AVANCER, COMMANDE_TOURNER, ...
+ * @param valeur La distance en centimètres ou l'angle en degrés vers la gauche, selon le type.
+ * @param rayon  Le rayon en centimètres d'une COMMANDE_ARC, dont la valeur est l'angle ; négatif
+ * 				 pour parcourir l'arc en reculant.
+ */
+void commandesAjouter(unsigned char type, float valeur, float rayon) {
+	if ((type == COMMANDE_AVANCER || type == COMMANDE_TOURNER || type == COMMANDE_ARC) && fabs(valeur) < valeurNegligeable) {
+		return;															// Un mouvement nul n'a rien à faire.
+	}
+
+	if (estimationEnCours()) {											// Pendant une estimation, la commande n'est que comptée,
+		estimationAjouter(type, valeur, rayon, fenetre > 0);			// et elle ne se combine que si elle l'aurait fait ici.
+		return;
+	}
+
+	if (type == COMMANDE_MONTER_FEUTRE) {								// On suit la position future du feutre
+		feutreLeveFile = true;											// pour savoir quels déplacements combiner.
+	}
+	else if (type == COMMANDE_DESCENDRE_FEUTRE) {
+		feutreLeveFile = false;
+	}
+
+	if (type == COMMANDE_AVANCER) {
+		valeur = arrondirCoin(valeur);
+	}
+
+	if (!combinerCommande(type, valeur, rayon)) {
+		if (nbCommandes == tailleMaxCommandes) {						// Il faut bien faire de la place.
+			executerPlusAncienne();
+		}
+
+		commandes[nbCommandes].type = type;
+		commandes[nbCommandes].valeur = valeur;
+		commandes[nbCommandes].rayon = rayon;
+		commandes[nbCommandes].feutreLeve = feutreLeveFile;
+		nbCommandes++;
+	}
+
+	while (!differee && nbCommandes > fenetre) {						// On n'exécute que ce qui sort de la fenêtre.
+		executerPlusAncienne();
+	}
+}
+
+/**
+ * Exécute toutes les commandes en attente, dans l'ordre.
+ */
+void commandesVider() {
+	while (nbCommandes > 0) {
+		executerPlusAncienne();
+	}
+}
+
+/**
+ * Donne la prochaine commande à exécuter, pour que celle en cours puisse s'y enchaîner. Elle peut
+ * encore se combiner avec celles qui arriveront : un déplacement peut notamment être raccourci
+ * d'au plus la moitié par l'arrondi d'un coin.
+ *
+ * @return La plus ancienne commande en attente, ou NULL si la file est vide.
+ */
+const Commande *commandesProchaine() {
+	return nbCommandes > 0 ? &commandes[0] : NULL;
+}
+
+/**
+ * Règle la tolérance avec laquelle les coins des tracés sont arrondis.
+ *
+ * @param tolerance L'écart maximal en centimètres entre un coin arrondi et son sommet, ou 0 pour
+ * 					garder les coins.
+ */
+void commandesArrondir(float tolerance) {
+	toleranceCoins = tolerance > 0 ? tolerance : 0;
+}
+
+/**
+ * Règle la taille de la fenêtre d'anticipation, c'est-à-dire le nombre de commandes gardées en
+ * attente pour pouvoir les combiner avec les suivantes. 0 les exécute immédiatement.
+ *
+ * @param taille Le nombre de commandes de la fenêtre, au plus tailleMaxCommandes.
+ */
+void commandesFenetre(int taille) {
+	if (taille < 0) {
+		taille = 0;
+	}
+	else if (taille > tailleMaxCommandes) {
+		taille = tailleMaxCommandes;
+	}
+
+	fenetre = taille;
+	while (!differee && nbCommandes > fenetre) {
+		executerPlusAncienne();
+	}
+}
+
+/**
+ * Signale le début d'un dessin qui profite de la fenêtre d'anticipation. Si aucune fenêtre n'a
+ * été choisie, une fenêtre de fenetreDessins commandes est ouverte jusqu'à l'appel correspondant
+ * à commandesFermer(). Les appels peuvent être imbriqués, ce qui est le cas des dessins récursifs.
+ */
+void commandesOuvrir() {
+	if (nbDessinsOuverts++ == 0) {
+		fenetreSauvegardee = fenetre;
+		if (fenetre == 0) {
+			fenetre = fenetreDessins;
+		}
+	}
+
+	MESURE_PROFONDEUR(nbDessinsOuverts);								// C'est aussi la profondeur de récursion des dessins.
+}
+
+/**
+ * Signale la fin d'un dessin ouvert par commandesOuvrir(). À la fermeture du dernier dessin
+ * ouvert, toutes les commandes en attente sont exécutées et la fenêtre précédente est rétablie.
+ */
+void commandesFermer() {
+	if (nbDessinsOuverts > 0 && --nbDessinsOuverts == 0) {
+		if (!differee) {												// En mode différé, le dessin reste dans la file.
+			commandesVider();
+		}
+		fenetre = fenetreSauvegardee;
+	}
+}
+
+/**
+ * Active ou désactive le mode différé. En le désactivant, les commandes qui dépassent la fenêtre
+ * sont exécutées.
+ *
+ * @param differer Vrai pour que la file n'exécute plus ses commandes d'elle-même.
+ * @see demarrerProchaine()
+ */
+void commandesDifferer(bool differer) {
+	differee = differer;
+	commandesFenetre(fenetre);
+}
+
+/**
+ * Exécute puis retire la plus ancienne commande de la file, s'il y en a une.
+ */
+void commandesExecuterProchaine() {
+	if (nbCommandes > 0) {
+		executerPlusAncienne();
+	}
+}
+
+/**
+ * Indique si la file est pleine : la prochaine commande ajoutée devra alors en exécuter une,
+ * sauf si elle se combine avec celles en attente.
+ *
+ * @return Vrai si la file est pleine.
+ */
+bool commandesPleine() {
+	return nbCommandes == tailleMaxCommandes;
+}
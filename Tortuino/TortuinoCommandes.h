@@ -0,0 +1,42 @@
+/**
+ * @file TortuinoCommandes.h
+ * @brief Définition des fonctions implémentées dans TortuinoCommandes.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoCommandes.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et le
+ * type des commandes mises en attente.
+ */
+
+
+# ifndef TORTUINO_COMMANDES_h
+#	define TORTUINO_COMMANDES_h
+
+	const unsigned char	COMMANDE_AVANCER			=	0;
+	const unsigned char	COMMANDE_TOURNER			=	1;
+	const unsigned char	COMMANDE_MONTER_FEUTRE		=	2;
+	const unsigned char	COMMANDE_DESCENDRE_FEUTRE	=	3;
+	const unsigned char	COMMANDE_ARC				=	4;
+
+	struct Commande {
+		unsigned char type;
+		float valeur;
+		float rayon;
+		bool feutreLeve;
+	};
+
+	void commandesAjouter(unsigned char type, float valeur, float rayon = 0);
+	void commandesVider();
+	const Commande *commandesProchaine();
+	void commandesArrondir(float tolerance);
+	void commandesFenetre(int taille);
+	void commandesOuvrir();
+	void commandesFermer();
+	void commandesDifferer(bool differer);
+	void commandesExecuterProchaine();
+	bool commandesPleine();
+
+	void executerCommande(const Commande &commande);
+	bool demarrerProchaine();
+
+# endif
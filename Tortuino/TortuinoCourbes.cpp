@@ -0,0 +1,281 @@
+# include "Tortuino.h"
+# include "TortuinoCourbes.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoOdometrie.h"
+# include <math.h>
+
+
+/**
+ * @file TortuinoCourbes.cpp
+ * @brief Ce fichier trace des courbes de Bézier et des splines de Catmull-Rom.
+ * @version 1.0
+ *
+ * Le fichier TortuinoCourbes.cpp trace des courbes lisses en les découpant en cordes, chacune
+ * tracée par tournerGauche() puis avancer(). Les points des courbes sont donnés en centimètres
+ * dans le repère du robot au moment de l'appel : l'axe des x est la direction dans laquelle il
+ * regarde, l'axe des y part vers sa gauche. Comme le `setpos` du langage Logo, une courbe laisse
+ * le robot sur son dernier point avec l'orientation qu'il avait au départ : plusieurs courbes à
+ * la suite partagent ainsi les mêmes axes, et la dernière rotation se combine avec la première
+ * de la courbe suivante dans la file d'attente de TortuinoCommandes.cpp.<br/>
+ *
+ * Le découpage est adaptatif : une corde est acceptée dès que la courbe ne s'en écarte pas de
+ * plus d'un demi-pas de roue, la résolution donnée par la géométrie de TortuinoOdometrie.cpp. Il
+ * n'y a donc pas plus de cordes que ce que le robot peut effectivement tracer, et les cordes plus
+ * courtes qu'un pas sont fusionnées plutôt que de faire tourner le robot pour rien. Le découpage
+ * n'est pas récursif : il avance le long de la courbe avec un pas en paramètre ajusté à chaque
+ * corde, sachant que l'écart entre une corde et la courbe varie comme le carré de ce pas. Une
+ * courbe n'occupe ainsi que quelques variables locales, quelle que soit sa longueur.
+ *
+ * @see bezier(float x1, float y1, float x2, float y2, float x3, float y3)
+ * @see catmullRom(const float points[][2], int nbPoints)
+ */
+
+
+
+const float		pasParametreMin		=	1.0 / 1024;	/**< Le plus petit pas en paramètre du découpage, qui borne le nombre de cordes d'une courbe dégénérée. */
+
+/**
+ * Un point ou un vecteur du plan, en centimètres.
+ */
+struct Vecteur {
+	float x;															/**< L'abscisse, vers l'avant du robot au départ de la courbe. */
+	float y;															/**< L'ordonnée, vers la gauche du robot au départ de la courbe. */
+};
+
+/**
+ * Le tracé en cours d'une courbe.
+ */
+struct TraceCourbe {
+	Vecteur position;													/**< La position atteinte par le robot. */
+	float cap;															/**< L'orientation du robot en degrés vers la gauche depuis l'axe des x. */
+	float resolution;													/**< La longueur en centimètres d'un pas de roue. */
+};
+
+
+/**
+ * Calcule la combinaison linéaire de deux vecteurs.
+ *
+ * @param  a Le premier vecteur.
+ * @param  b Le second vecteur.
+ * @param  k Le coefficient du second vecteur.
+ * @return   Le vecteur a + k * b.
+ */
+Vecteur combiner(const Vecteur &a, const Vecteur &b, float k) {
+	Vecteur resultat = {a.x + k * b.x, a.y + k * b.y};
+	return resultat;
+}
+
+/**
+ * Calcule la distance d'un point au segment qui joint deux autres.
+ *
+ * @param  p Le point.
+ * @param  a Le début du segment.
+ * @param  b La fin du segment.
+ * @return   La distance en centimètres.
+ */
+float ecartSegment(const Vecteur &p, const Vecteur &a, const Vecteur &b) {
+	float dx = b.x - a.x, dy = b.y - a.y;
+	float carre = dx * dx + dy * dy;
+	float t = carre > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / carre : 0;
+	t = t < 0 ? 0 : t > 1 ? 1 : t;
+	return hypot(p.x - a.x - t * dx, p.y - a.y - t * dy);
+}
+
+/**
+ * Calcule un point d'une courbe de Bézier cubique.
+ *
+ * @param  p Les quatre points de contrôle.
+ * @param  t Le paramètre, de 0 au premier point à 1 au dernier.
+ * @return   Le point de la courbe.
+ */
+Vecteur pointBezier(const Vecteur *p, float t) {
+	float u = 1 - t;
+	float a = u * u * u, b = 3 * u * u * t, c = 3 * u * t * t, d = t * t * t;
+	Vecteur resultat = {a * p[0].x + b * p[1].x + c * p[2].x + d * p[3].x, a * p[0].y + b * p[1].y + c * p[2].y + d * p[3].y};
+	return resultat;
+}
+
+/**
+ * Calcule la dérivée d'une courbe de Bézier cubique par rapport à son paramètre.
+ *
+ * @param  p Les quatre points de contrôle.
+ * @param  t Le paramètre.
+ * @return   La tangente à la courbe, en centimètres par unité de paramètre.
+ */
+Vecteur deriveeBezier(const Vecteur *p, float t) {
+	float u = 1 - t;
+	float a = 3 * u * u, b = 6 * u * t, c = 3 * t * t;
+	Vecteur resultat = {a * (p[1].x - p[0].x) + b * (p[2].x - p[1].x) + c * (p[3].x - p[2].x),
+						a * (p[1].y - p[0].y) + b * (p[2].y - p[1].y) + c * (p[3].y - p[2].y)};
+	return resultat;
+}
+
+/**
+ * Tourne le robot vers une direction.
+ *
+ * @param trace  Le tracé en cours.
+ * @param dx     L'abscisse de la direction.
+ * @param dy     L'ordonnée de la direction.
+ */
+void tournerVers(TraceCourbe &trace, float dx, float dy) {
+	float cap = atan2(dy, dx) * 180 / M_PI;
+	float rotation = fmod(cap - trace.cap + 540, 360) - 180;			// La rotation la plus courte, entre -180° et 180°.
+	tournerGauche(rotation);
+	trace.cap = cap;
+}
+
+/**
+ * Trace une corde, en tournant puis en avançant jusqu'à son extrémité.
+ *
+ * @param trace Le tracé en cours.
+ * @param cible L'extrémité de la corde.
+ */
+void tracerCorde(TraceCourbe &trace, const Vecteur &cible) {
+	float dx = cible.x - trace.position.x, dy = cible.y - trace.position.y;
+	float longueur = hypot(dx, dy);
+	if (longueur > 0) {
+		tournerVers(trace, dx, dy);
+		avancer(longueur);
+		trace.position = cible;
+	}
+}
+
+/**
+ * Trace une courbe de Bézier cubique en la découpant en cordes, au fil de l'eau. La portion de
+ * la courbe entre deux paramètres est elle-même une courbe de Bézier, dont les points de contrôle
+ * intérieurs se déduisent des tangentes à ses extrémités : si ces deux points sont assez proches
+ * de la corde, toute la portion l'est aussi.
+ *
+ * @param trace Le tracé en cours, dont la position est le premier point de contrôle.
+ * @param p     Les quatre points de contrôle.
+ */
+void decouperBezier(TraceCourbe &trace, const Vecteur *p) {
+	const float tolerance = trace.resolution / 2;
+	float t = 0, pas = 0.25;
+	Vecteur debut = p[0];
+	Vecteur tangenteDebut = deriveeBezier(p, 0);
+
+	while (t < 1) {
+		if (t + pas > 1) {
+			pas = 1 - t;
+		}
+
+		Vecteur fin = pointBezier(p, t + pas);
+		Vecteur tangenteFin = deriveeBezier(p, t + pas);
+		Vecteur controle1 = combiner(debut, tangenteDebut, pas / 3);
+		Vecteur controle2 = combiner(fin, tangenteFin, -pas / 3);
+		float ecart = fmax(ecartSegment(controle1, debut, fin), ecartSegment(controle2, debut, fin));
+		float facteur = ecart > 0 ? fmin(2, 0.9 * sqrt(tolerance / ecart)) : 2;	// L'écart varie comme le carré du pas.
+		if (ecart > tolerance && pas > pasParametreMin) {
+			pas *= fmax(facteur, 0.25);									// La corde s'écarte trop de la courbe : on la raccourcit.
+			continue;
+		}
+
+		t += pas;
+		if (t >= 1 || hypot(fin.x - trace.position.x, fin.y - trace.position.y) >= trace.resolution) {
+			tracerCorde(trace, fin);									// Les cordes de moins d'un pas sont fusionnées avec les suivantes.
+		}
+		debut = fin;
+		tangenteDebut = tangenteFin;
+		pas *= facteur;													// La suivante peut sans doute être plus longue.
+	}
+}
+
+/**
+ * Prépare le tracé d'une courbe depuis la position et l'orientation actuelles du robot.
+ *
+ * @param trace Le tracé à préparer.
+ */
+void demarrerCourbe(TraceCourbe &trace) {
+	trace.position.x = 0;
+	trace.position.y = 0;
+	trace.cap = 0;
+	trace.resolution = 65536.0 / odometriePasParCentimetre();
+	commandesOuvrir();
+}
+
+/**
+ * Termine le tracé d'une courbe en rendant au robot son orientation de départ.
+ *
+ * @param trace Le tracé à terminer.
+ */
+void terminerCourbe(TraceCourbe &trace) {
+	tournerVers(trace, 1, 0);
+	commandesFermer();
+}
+
+/**
+ * Trace une courbe de Bézier cubique, qui part de la position du robot et arrive au point
+ * (x3, y3) en étant attirée par les points de contrôle (x1, y1) puis (x2, y2). La courbe part
+ * dans la direction du premier point de contrôle et arrive depuis la direction du second. Le
+ * robot finit sur le point d'arrivée, tourné comme au départ.
+ *
+ * @param x1 L'abscisse du premier point de contrôle, en centimètres vers l'avant du robot.
+ * @param y1 L'ordonnée du premier point de contrôle, en centimètres vers la gauche du robot.
+ * @param x2 L'abscisse du second point de contrôle.
+ * @param y2 L'ordonnée du second point de contrôle.
+ * @param x3 L'abscisse du point d'arrivée.
+ * @param y3 L'ordonnée du point d'arrivée.
+ * @see catmullRom(const float points[][2], int nbPoints)
+ */
+void bezier(float x1, float y1, float x2, float y2, float x3, float y3) {
+	TraceCourbe trace;
+	Vecteur p[4] = {{0, 0}, {x1, y1}, {x2, y2}, {x3, y3}};
+
+	demarrerCourbe(trace);
+	decouperBezier(trace, p);
+	terminerCourbe(trace);
+}
+
+/**
+ * Donne un des points d'une spline, la position de départ du robot étant le point d'indice -1.
+ * Les indices au-delà des extrémités sont ramenés à celles-ci.
+ *
+ * @param  points   Les points donnés à catmullRom().
+ * @param  nbPoints Le nombre de ces points.
+ * @param  i        L'indice du point voulu.
+ * @return          Le point.
+ */
+Vecteur pointSpline(const float points[][2], int nbPoints, int i) {
+	Vecteur resultat = {0, 0};
+	if (i >= nbPoints) {
+		i = nbPoints - 1;
+	}
+	if (i >= 0) {
+		resultat.x = points[i][0];
+		resultat.y = points[i][1];
+	}
+	return resultat;
+}
+
+/**
+ * Trace une spline de Catmull-Rom, c'est-à-dire une courbe lisse qui part de la position du
+ * robot et passe par tous les points donnés, dans l'ordre. Entre deux points, c'est une courbe de
+ * Bézier dont la tangente à chaque point est parallèle à la droite qui joint ses deux voisins ;
+ * le premier et le dernier point sont leurs propres voisins manquants. Le robot finit sur le
+ * dernier point, tourné comme au départ.
+ *
+ * {@code
+ * 	float points[][2] = {{10, 5}, {20, -5}, {30, 0}};
+ * 	catmullRom(points, 3);				// Une vague de 30 cm vers l'avant.
+ * }
+ *
+ * @param points   Les points par lesquels passer, en centimètres dans le repère du robot : vers
+ * 				   l'avant puis vers la gauche.
+ * @param nbPoints Le nombre de points, sans compter la position de départ.
+ * @see bezier(float x1, float y1, float x2, float y2, float x3, float y3)
+ */
+void catmullRom(const float points[][2], int nbPoints) {
+	TraceCourbe trace;
+
+	demarrerCourbe(trace);
+	for (int i = 0; i < nbPoints; i++) {								// Le segment qui va du point i - 1 au point i.
+		Vecteur avant = pointSpline(points, nbPoints, i - 2);
+		Vecteur debut = pointSpline(points, nbPoints, i - 1);
+		Vecteur fin = pointSpline(points, nbPoints, i);
+		Vecteur apres = pointSpline(points, nbPoints, i + 1);
+		Vecteur p[4] = {debut, combiner(debut, combiner(fin, avant, -1), 1.0 / 6), combiner(fin, combiner(apres, debut, -1), -1.0 / 6), fin};
+		decouperBezier(trace, p);
+	}
+	terminerCourbe(trace);
+}
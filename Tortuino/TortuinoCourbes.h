@@ -0,0 +1,17 @@
+/**
+ * @file TortuinoCourbes.h
+ * @brief Définition des fonctions implémentées dans TortuinoCourbes.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoCourbes.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions.
+ */
+
+
+# ifndef TORTUINO_COURBES_h
+#	define TORTUINO_COURBES_h
+
+	void bezier(float x1, float y1, float x2, float y2, float x3, float y3);
+	void catmullRom(const float points[][2], int nbPoints);
+
+# endif
@@ -1,6 +1,8 @@
 
 # include "Tortuino.h"
 # include "TortuinoDessins.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoLSysteme.h"
 # include <math.h>
 
 
@@ -22,6 +24,14 @@
 
 
 
+const RegleLSysteme	reglesArbre[]		=	{{'Y', "+FYB>vFYB{", "^"}};					/**< Un embranchement porte deux arbres plus petits, puis redresse le robot ; au dernier niveau, le feutre se lève pour revenir. */
+const RegleLSysteme	reglesKoch[]		=	{{'F', "F+F>F+F", 0}};						/**< Chaque segment est remplacé par quatre segments trois fois plus petits. */
+const RegleLSysteme	reglesSierpinski[]	=	{{'S', "S^FvS^+F-vS^-F+v", "F+F+F+"}};		/**< Chaque triangle en contient trois deux fois plus petits ; au dernier niveau, c'est un simple triangle. */
+
+const LSysteme		courbeKoch			=	{"F", reglesKoch, 1, 1, 3, {60, 120, 0}};	/**< Le L-système de la courbe de Von Koch. */
+const LSysteme		sierpinski			=	{"S", reglesSierpinski, 1, 1, 2, {120, 0, 0}};	/**< Le L-système du triangle de Sierpiński. */
+
+
 /**
  * Fait tracer au robot un polygone régulier en fonction du nombre de côtés souhaités et de la
  * taille de chacun de ces côtés. Voir l'<a href="https://fr.wikipedia.org/wiki/Polygone_r%C3%A9gulier">
@@ -45,10 +55,12 @@
  * @param tailleCote La taille de chacun des côtés.
  */
 void polygoneRegulier(int nbCotes, float tailleCote) {
+	commandesOuvrir();													// Les commandes du dessin peuvent se combiner entre elles,
 	for (int i = 0; i < nbCotes; i++) {									// Pour chacun des côtés,
 		avancer(tailleCote);											// on avance de la taille donnée
-		tournerGauche(360 / nbCotes);									// et on tourne de l'angle 360° / nbCôtés.
+		tournerGauche(360.0 / nbCotes);									// et on tourne de l'angle 360° / nbCôtés, sans division entière.
 	}
+	commandesFermer();													// et sont toutes exécutées à la fin.
 }
 
 /**
@@ -80,18 +92,16 @@ void carre(float tailleCote) {
 }
 
 /**
- * Cette fonction est une tentative de réalisation d'un cercle automatiquement avec juste
- * le rayon souhaité en entrée.
- * Seulement, cela ne fonctionne pas trop car il est difficile de décorréler les paramètres
- * du robot pour pouvoir calculer les valeurs nécessaires à une approximation relativement
- * correcte d'un cercle par un polygone régulier au grand nombre de côtés. Cette fonction
- * est en cours développement, une meilleure version peut venir à être rendue disponble.
+ * Trace un cercle d'un rayon donné, qui part de la position du robot dans la direction où il
+ * regarde et tourne vers la gauche. Le cercle n'est plus approché par un polygone aux nombreux
+ * côtés, qui demandait autant d'arrêts des moteurs : c'est un seul arc de 360°, tracé d'un
+ * mouvement continu par arcGauche().
  * 
  * @param rayon Le rayon du cercle.
+ * @see arcGauche(float rayon, float angle)
  */
-void cercle(float rayon) {												// W.I.P.
-	float nbCotes = 20.0 * rayon;										// On décide d'essayer avec 20 côtés "seulement" et on peut en déduire
-	polygoneRegulier(floor(nbCotes), 2.0 * M_PI * rayon / nbCotes);		// la taille du polygone régulier approchant suffisamment le cercle souhaité
+void cercle(float rayon) {
+	arcGauche(rayon, 360);
 }
 
 /**
@@ -172,21 +182,11 @@ void arbreSymetrique(int nbNiveaux, float tailleTronc, float angleSeparation) {
  * @see arbreSymetrique(int nbNiveaux, float tailleTronc, float angleSeparation)
  */
 void arbreAsymetrique(int nbNiveaux, float tailleTronc, float angleSeparation, float angleInclinaison) {
-	if (nbNiveaux == 1) {												// Si le nombre de niveaux est de 1,
-		avancer(tailleTronc);											// on trace juste un trait
-		monterFeutre();													// et sans laisser de trace derrière soi,
-		reculer(tailleTronc);											// on revient en arrière.
-	}
-	else {																// Sinon,
-		avancer(tailleTronc);											// on trace le tronc de l'arbre
-		tournerGauche(angleInclinaison + angleSeparation / 2);			// on tourne à gauche de l'angle paramétré
-		arbreAsymetrique(nbNiveaux - 1, 2 * tailleTronc / 3, angleSeparation, angleInclinaison);	// et on refait un arbre, plus petit cette fois-ci;
-		tournerDroite(angleSeparation);									// Après cet arbre, on tourne pour aller vers l'autre branche,
-		descendreFeutre();												// on se met en position de dessin,
-		arbreAsymetrique(nbNiveaux - 1, 2 * tailleTronc / 3, angleSeparation, angleInclinaison);	// et on refait un arbre plus petit;
-		tournerGauche(angleSeparation / 2 - angleInclinaison);			// enfin, on se remet dans l'axe du tronc
-		reculer(tailleTronc);											// et on revient à la position de départ.
-	}
+	LSysteme systeme = {												// Chaque Y est l'embranchement au bout d'un tronc F, qui est ensuite retracé par B.
+		"FYB", reglesArbre, 1, 2, 3,									// Les branches sont d'un tiers plus petites que leur tronc.
+		{angleInclinaison + angleSeparation / 2, angleSeparation, angleSeparation / 2 - angleInclinaison}
+	};
+	lsystemeTracer(systeme, nbNiveaux, tailleTronc);
 }
 
 /**
@@ -212,8 +212,10 @@ void arbreAsymetrique(int nbNiveaux, float tailleTronc, float angleSeparation, f
  * @see arbre(int nbNiveaux, float tailleTronc)
  */
 void sapin(int nbNiveaux, float tailleTronc) {
+	commandesOuvrir();
 	arbreAsymetrique(nbNiveaux, tailleTronc, 90, 45);					// On fait un arbre asymétrique complètement penché vers la gauche
 	arbreAsymetrique(nbNiveaux, tailleTronc, 90, -45);					// et un autre vers la droite.
+	commandesFermer();
 }
 
 /**
@@ -237,18 +239,7 @@ void sapin(int nbNiveaux, float tailleTronc) {
  * 					segment de départ sert d'étalon pour en déduire à l'avance la taille des côtés engendrés.
  */
 void courbeVonKoch(int nbNiveaux, float taille) {
-	if (nbNiveaux == 1) {												// Si le nombre de niveaux est de 1,
-		avancer(taille);												// on ne fait qu'un trait sans revenir en arrière.
-	}
-	else {																// Sinon,
-		courbeVonKoch(nbNiveaux - 1, taille / 3);						// on commence par faire une courbe de Von Koch plus petite pour le premier tiers du segment;
-		tournerGauche(60);												// puis on se place pour faire la première moitié du deuxième tiers,
-		courbeVonKoch(nbNiveaux - 1, taille / 3);						// et on la trace;
-		tournerDroite(120);												// ensuite on se place pour faire la seconde moitié du deuxième tiers,
-		courbeVonKoch(nbNiveaux - 1, taille / 3);						// et on la trace;
-		tournerGauche(60);												// enfin on se place pour faire le troisième et dernier tiers,
-		courbeVonKoch(nbNiveaux - 1, taille / 3);						// et on la trace.
-	}
+	lsystemeTracer(courbeKoch, nbNiveaux, taille);
 }
 
 /**
@@ -273,10 +264,12 @@ void courbeVonKoch(int nbNiveaux, float taille) {
  * 					segment de départ sert d'étalon pour en déduire à l'avance la taille des côtés engendrés.
  */
 void floconVonKoch(int nbNiveaux, float taille) {
+	commandesOuvrir();
 	for (int i = 0; i < 6; i++) {										// Un flocon de Von Koch est la répétition de trois
 		courbeVonKoch(nbNiveaux, taille);								// de ses courbes
 		tournerGauche(60);												// séparées par un angle externe de 60°, soit un angle interne de 120°.
 	}
+	commandesFermer();
 }
 
 /**
@@ -298,27 +291,7 @@ void floconVonKoch(int nbNiveaux, float taille) {
  * 					de l'algorithme de Sierpiński ; idem à ce que fait floconVonKoch(int nbNiveaux, float taille)
  */
 void triangleSierpinski(int nbNiveaux, float taille) {
-	if (nbNiveaux == 1) {												// Si le nombre de niveaux est de 1,
-		triangle(taille);												// on fait juste un triangle de la taille donnée.
-	}
-	else {																// Sinon,
-		triangleSierpinski(nbNiveaux - 1, taille / 2);					// on commence par faire le triangle d'en bas à gauche,
-		monterFeutre();
-		avancer(taille / 2);											// puis on se place pour faire celui d'en bas à droite,
-		descendreFeutre();
-		triangleSierpinski(nbNiveaux - 1, taille / 2);					// et on le trace;
-		monterFeutre();
-		tournerGauche(120);												// ensuite on se déplace pour faire le troisième et dernier,
-		avancer(taille / 2);
-		tournerDroite(120);
-		descendreFeutre();
-		triangleSierpinski(nbNiveaux - 1, taille / 2);					// et on le trace;
-		monterFeutre();
-		tournerDroite(120);
-		avancer(taille / 2);
-		tournerGauche(120);												// enfin, on revient à la position de départ.
-		descendreFeutre();
-	}
+	lsystemeTracer(sierpinski, nbNiveaux, taille);
 }
 
 
@@ -335,6 +308,7 @@ void triangleSierpinski(int nbNiveaux, float taille) {
  * @image latex	maison.png	"Le défi maison"	height=200pt
  */
 void maison() {
+	commandesOuvrir();
 	avancer(10);														// Le toit.
 	tournerDroite(120);
 	avancer(10);
@@ -358,6 +332,7 @@ void maison() {
 	tournerDroite(90);
 	avancer(10);														// et du corps.
 	tournerDroite(90);
+	commandesFermer();
 }
 
 /**
@@ -378,6 +353,7 @@ void maison() {
  * 							et son suivant, mais plutôt son quadruple.
  */
 void spiraleCarree(int nbCotes, float longueurDepart, float ecart) {
+	commandesOuvrir();
 	float longueurCote = longueurDepart;								// On enregistre la longueur du segment en cours
 	const float diffLongueur = ecart / 4;								// et la longueur qu'il lui faut ajouter pour le suivant.
 	
@@ -386,6 +362,7 @@ void spiraleCarree(int nbCotes, float longueurDepart, float ecart) {
 		tournerGauche(90);												// on se place pour le suivant,
 		longueurCote += diffLongueur;									// et on augmente la taille du côté pour avoir l'écart souhaité.
 	}
+	commandesFermer();
 }
 
 /**
@@ -398,6 +375,7 @@ void spiraleCarree(int nbCotes, float longueurDepart, float ecart) {
  * @image latex	tangram.png	"Le défi tangram"	height=200pt
  */
 void tangram() {
+	commandesOuvrir();
 	for (int i = 0; i < 4; i++) {										// Le contour.
 		avancer(10);
 		tournerGauche(90);
@@ -431,6 +409,7 @@ void tangram() {
 	tournerDroite(135);
 	descendreFeutre();
 	avancer(3.535);
+	commandesFermer();
 }
 
 /**
@@ -441,6 +420,7 @@ void tangram() {
  * @image latex	flocon.png	"Le défi flocon"	height=200pt
  */
 void flocon() {
+	commandesOuvrir();
 	for (int i = 0; i < 8; i++) {										// Pour chacune des huit branches,
 		avancer(6.59);													// on fait le "tronc" principal,
 		tournerGauche(45);
@@ -466,4 +446,5 @@ void flocon() {
 		tournerDroite(45);												// en tournant pour se préparer
 		descendreFeutre();												// pour la suivante.
 	}
+	commandesFermer();
 }
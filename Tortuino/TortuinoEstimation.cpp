@@ -0,0 +1,503 @@
+# include "Tortuino.h"
+# include "TortuinoEstimation.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoOdometrie.h"
+# include <math.h>
+
+
+/**
+ * @file TortuinoEstimation.cpp
+ * @brief Ce fichier estime ce que coûtera un dessin, sans faire bouger le robot.
+ * @version 1.0
+ *
+ * Le fichier TortuinoEstimation.cpp prédit le nombre de pas de chaque roue, le nombre de
+ * mouvements du feutre et la durée d'un dessin avant de le tracer. Entre estimationDemarrer() et
+ * estimationTerminer(), les commandes de base ne sont plus exécutées : TortuinoCommandes.cpp les
+ * confie à estimationAjouter(), qui les combine entre elles exactement comme le ferait la file
+ * d'attente, puis compte le coût de chacune. La durée d'un mouvement se calcule directement à
+ * partir de son nombre de pas et du profil de vitesse trapézoïdal de TortuinoMoteurs.cpp, sans
+ * simuler un seul pas ; une descente du feutre coûte le délai du servomoteur.<br/>
+ *
+ * Les dessins récursifs ne sont pas développés : un L-système de TortuinoLSysteme.cpp est estimé
+ * niveau par niveau, du plus profond au premier. Le coût d'un symbole à un niveau est la somme des
+ * coûts des symboles de sa réécriture au niveau suivant, ce qui revient aux formules fermées de
+ * ces dessins, comme les 4^(n-1) segments d'une courbe de Von Koch, en tenant compte en plus des
+ * combinaisons de commandes entre deux développements voisins. Chaque symbole est pour cela
+ * résumé par son coût et par les quelques commandes de ses deux bords, les seules qui puissent se
+ * combiner avec ses voisins. Un triangle de Sierpinski de niveau 15, qui demanderait seize
+ * milliards de pas, est ainsi estimé en une centaine de résumés.<br/>
+ *
+ * Ces résumés occupent près d'un kilo-octet, la moitié de la mémoire d'un Arduino Uno : ils ne
+ * sont compilés que si TORTUINO_ESTIMATION_NIVEAUX est défini, ce qui est le cas sur l'ordinateur
+ * avec TORTUINO_MESURES. Sans eux, les L-systèmes sont développés commande par commande, ce qui
+ * donne la même estimation aux arrondis près, mais en un temps proportionnel à la longueur du
+ * dessin.<br/>
+ *
+ * L'estimation suppose que chaque mouvement s'arrête avant le suivant : le mode continu de
+ * continu(float tolerance) n'y est pas pris en compte, et ne peut que raccourcir le tracé.
+ *
+ * @see estimer(void (*dessin)())
+ */
+
+
+
+const int	tailleBordResume	=	4;				/**< Le nombre de commandes gardées de chaque côté d'un résumé, pour les combiner avec ses voisins. */
+const int	nbMaxReglesEstimees	=	2;				/**< Le nombre maximal de règles d'un L-système estimé niveau par niveau ; au-delà, il est développé. */
+const float	valeurNegligeable	=	0.0001;			/**< Comme dans TortuinoCommandes.cpp, la valeur absolue en dessous de laquelle un mouvement est nul. */
+
+/**
+ * Le coût accumulé de commandes exécutées. Les nombres de pas ne sont pas arrondis, car un trait
+ * plus court qu'un pas n'en coûte qu'une fraction une fois reportés les restes de
+ * TortuinoOdometrie.cpp.
+ */
+struct Cout {
+	float pasGauche;													/**< Le nombre de pas de la roue gauche. */
+	float pasDroite;													/**< Le nombre de pas de la roue droite. */
+	float basculesFeutre;												/**< Le nombre de mouvements du feutre. */
+	float duree;														/**< La durée en secondes. */
+};
+
+/**
+ * Le résumé d'une suite de commandes : son coût, sauf celui des commandes de ses bords qui
+ * peuvent encore se combiner avec celles qui la précèdent ou la suivent. Tant qu'elle en a peu,
+ * toutes ses commandes sont gardées ; au-delà, seules les tailleBordResume premières et les
+ * tailleBordResume dernières le sont, et le coût de celles du milieu est accumulé.
+ */
+struct Resume {
+	Commande commandes[2 * tailleBordResume];							/**< Les commandes des bords, la plus ancienne en premier. Pour celles du feutre, la valeur vaut 1 si elles le font bouger. */
+	unsigned char nbCommandes;											/**< Le nombre de commandes gardées. */
+	unsigned char nbTete;												/**< Le nombre de commandes gardées avant le milieu, ou nbCommandes s'il n'y en a pas. */
+	bool milieu;														/**< Vrai si des commandes ont été comptées entre les deux bords. */
+	bool feutreLeve;													/**< La position du feutre à la fin de la suite. */
+	Cout cout;															/**< Le coût des commandes du milieu. */
+};
+
+/**
+ * Les facteurs de conversion et les profils de vitesse avec lesquels les commandes sont comptées.
+ */
+struct ModeleCout {
+	float pasParCentimetre;												/**< Le nombre de pas d'une roue par centimètre parcouru. */
+	float pasParDegre;													/**< Le nombre de pas de chaque roue par degré de rotation sur place. */
+	float braquage;														/**< Le rayon de braquage du robot, en centimètres. */
+	float limites[2][3];												/**< Les réglages de chaque profil de vitesse, donnés par moteursLimites(). */
+};
+
+bool		estimationActive	=	false;			/**< Vrai entre estimationDemarrer() et estimationTerminer(). */
+Resume		estimationCourante;						/**< Le résumé de tout ce qui a été estimé depuis estimationDemarrer(). */
+ModeleCout	modeleCout;								/**< Le modèle de coût de l'estimation en cours, relevé à son démarrage. */
+
+
+/**
+ * Calcule la durée d'un mouvement qui suit un profil de vitesse trapézoïdal : il accélère depuis
+ * la vitesse de démarrage, garde la vitesse maximale s'il en a la place, puis décélère d'autant.
+ *
+ * @param  pas    Le nombre de pas de la roue qui en fait le plus.
+ * @param  profil Le profil de vitesse : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @return        La durée en secondes.
+ */
+float dureeMouvement(float pas, unsigned char profil) {
+	const float *limites = modeleCout.limites[profil];
+	float depart = limites[0], maximum = limites[1], acceleration = limites[2];
+	if (pas <= 0) {
+		return 0;
+	}
+
+	float rampe = (maximum * maximum - depart * depart) / (2 * acceleration);
+	if (pas >= 2 * rampe) {												// Le maximum est atteint et tenu,
+		return 2 * (maximum - depart) / acceleration + (pas - 2 * rampe) / maximum;
+	}
+	return 2 * (sqrt(depart * depart + acceleration * pas) - depart) / acceleration;	// ou bien le mouvement décélère dès la mi-parcours.
+}
+
+/**
+ * Ajoute le coût d'une commande exécutée à un coût accumulé.
+ *
+ * @param cout     Le coût accumulé.
+ * @param commande La commande, telle que gardée dans un résumé.
+ */
+void compterCommande(Cout &cout, const Commande &commande) {
+	float gauche = 0, droite = 0;
+
+	switch (commande.type) {
+		case COMMANDE_AVANCER:
+			gauche = droite = fabs(commande.valeur) * modeleCout.pasParCentimetre;
+			break;
+		case COMMANDE_TOURNER:
+			gauche = droite = fabs(commande.valeur) * modeleCout.pasParDegre;
+			break;
+		case COMMANDE_ARC: {											// Comme odometrieArc() : une roue fait la somme, l'autre la différence.
+			float radians = commande.valeur * M_PI / 180;
+			float avance = commande.rayon * fabs(radians) * modeleCout.pasParCentimetre;
+			float rotation = modeleCout.braquage * radians * modeleCout.pasParCentimetre;
+			gauche = fabs(rotation - avance);
+			droite = fabs(rotation + avance);
+			break;
+		}
+		case COMMANDE_MONTER_FEUTRE:
+		case COMMANDE_DESCENDRE_FEUTRE:
+			cout.basculesFeutre += commande.valeur;
+			if (commande.valeur != 0 && !commande.feutreLeve) {			// Le tracé suivant attendra que le feutre soit posé.
+				cout.duree += DELAI_FEUTRE / 1000.0;
+			}
+			return;
+	}
+
+	cout.pasGauche += gauche;
+	cout.pasDroite += droite;
+	cout.duree += dureeMouvement(gauche > droite ? gauche : droite, commande.feutreLeve ? PROFIL_DEPLACEMENT : PROFIL_TRACE);
+}
+
+/**
+ * Vide un résumé, pour une suite qui démarre avec le feutre dans une position donnée.
+ *
+ * @param resume     Le résumé à vider.
+ * @param feutreLeve La position du feutre au début de la suite.
+ */
+void resumeVider(Resume &resume, bool feutreLeve) {
+	resume.nbCommandes = 0;
+	resume.nbTete = 0;
+	resume.milieu = false;
+	resume.feutreLeve = feutreLeve;
+	resume.cout.pasGauche = 0;
+	resume.cout.pasDroite = 0;
+	resume.cout.basculesFeutre = 0;
+	resume.cout.duree = 0;
+}
+
+/**
+ * Retire une commande d'un résumé en décalant celles qui la suivent.
+ *
+ * @param resume Le résumé.
+ * @param indice L'indice de la commande à retirer.
+ */
+void resumeRetirer(Resume &resume, int indice) {
+	for (int i = indice; i < resume.nbCommandes - 1; i++) {
+		resume.commandes[i] = resume.commandes[i + 1];
+	}
+	resume.nbCommandes--;
+	if (!resume.milieu) {
+		resume.nbTete = resume.nbCommandes;
+	}
+}
+
+/**
+ * Tente de combiner une commande avec la fin d'un résumé, selon les mêmes règles que
+ * combinerCommande() dans TortuinoCommandes.cpp. Seules les commandes qui suivent le milieu
+ * peuvent s'y combiner.
+ *
+ * @param  resume   Le résumé.
+ * @param  commande La commande, dont la position du feutre est déjà renseignée.
+ * @return          Vrai si la commande a été absorbée par le résumé.
+ */
+bool resumeCombiner(Resume &resume, const Commande &commande) {
+	int debut = resume.milieu ? resume.nbTete : 0;
+	int i = resume.nbCommandes - 1;
+
+	if (commande.type == COMMANDE_TOURNER) {
+		while (i >= debut && (resume.commandes[i].type == COMMANDE_MONTER_FEUTRE || resume.commandes[i].type == COMMANDE_DESCENDRE_FEUTRE)) {
+			i--;
+		}
+		if (i < debut || resume.commandes[i].type != COMMANDE_TOURNER) {
+			return false;
+		}
+	}
+	else if (commande.type == COMMANDE_AVANCER || commande.type == COMMANDE_ARC) {
+		if (i < debut) {
+			return false;
+		}
+		const Commande &derniere = resume.commandes[i];
+		if (derniere.type != commande.type || derniere.feutreLeve != commande.feutreLeve
+				|| (commande.type == COMMANDE_ARC && derniere.rayon != commande.rayon)
+				|| (!commande.feutreLeve && (derniere.valeur > 0) != (commande.valeur > 0))) {
+			return false;
+		}
+	}
+	else {
+		return false;
+	}
+
+	resume.commandes[i].valeur += commande.valeur;
+	if (fabs(resume.commandes[i].valeur) < valeurNegligeable) {					// Comme dans la file, les commandes qui s'annulent disparaissent.
+		resumeRetirer(resume, i);
+	}
+	return true;
+}
+
+/**
+ * Ajoute une commande à la fin d'un résumé. Si le résumé est plein, la plus ancienne commande qui
+ * suit le milieu y est comptée.
+ *
+ * @param resume     Le résumé.
+ * @param commande   La commande, dont seuls le type, la valeur et le rayon sont utilisés.
+ * @param combinable Vrai si la commande peut se combiner avec les précédentes, c'est-à-dire si
+ * 					 une fenêtre d'anticipation est ouverte.
+ */
+void resumeAjouter(Resume &resume, const Commande &commande, bool combinable) {
+	Commande ajoutee = commande;
+	if ((commande.type == COMMANDE_AVANCER || commande.type == COMMANDE_TOURNER || commande.type == COMMANDE_ARC) && fabs(commande.valeur) < valeurNegligeable) {
+		return;															// La file ne les garde pas non plus.
+	}
+	else if (commande.type == COMMANDE_MONTER_FEUTRE || commande.type == COMMANDE_DESCENDRE_FEUTRE) {
+		ajoutee.feutreLeve = commande.type == COMMANDE_MONTER_FEUTRE;
+		ajoutee.valeur = ajoutee.feutreLeve != resume.feutreLeve ? 1 : 0;	// Le feutre ne bouge que s'il change de position.
+		resume.feutreLeve = ajoutee.feutreLeve;
+	}
+	else {
+		ajoutee.feutreLeve = resume.feutreLeve;
+	}
+
+	if (combinable && resumeCombiner(resume, ajoutee)) {
+		return;
+	}
+
+	if (resume.nbCommandes == 2 * tailleBordResume) {					// Il faut faire de la place après la tête.
+		if (!resume.milieu) {
+			resume.milieu = true;
+			resume.nbTete = tailleBordResume;
+		}
+		compterCommande(resume.cout, resume.commandes[resume.nbTete]);
+		resumeRetirer(resume, resume.nbTete);
+	}
+
+	resume.commandes[resume.nbCommandes++] = ajoutee;
+	if (!resume.milieu) {
+		resume.nbTete = resume.nbCommandes;
+	}
+}
+
+/**
+ * Ajoute à la fin d'un résumé la suite de commandes qu'en résume un autre. Les commandes de tête
+ * du second se combinent avec la fin du premier ; s'il a un milieu, la fin du premier est alors
+ * comptée et remplacée par la fin du second.
+ *
+ * @param resume Le résumé à compléter.
+ * @param suite  Le résumé de la suite, qui doit démarrer avec le feutre où le premier le laisse.
+ */
+void resumeConcatener(Resume &resume, const Resume &suite) {
+	for (int i = 0; i < suite.nbTete; i++) {
+		resumeAjouter(resume, suite.commandes[i], true);
+	}
+	if (!suite.milieu) {
+		return;
+	}
+
+	if (!resume.milieu) {
+		resume.milieu = true;
+		resume.nbTete = resume.nbCommandes < tailleBordResume ? resume.nbCommandes : tailleBordResume;
+	}
+	for (int i = resume.nbTete; i < resume.nbCommandes; i++) {
+		compterCommande(resume.cout, resume.commandes[i]);
+	}
+
+	resume.cout.pasGauche += suite.cout.pasGauche;
+	resume.cout.pasDroite += suite.cout.pasDroite;
+	resume.cout.basculesFeutre += suite.cout.basculesFeutre;
+	resume.cout.duree += suite.cout.duree;
+
+	resume.nbCommandes = resume.nbTete;
+	for (int i = suite.nbTete; i < suite.nbCommandes; i++) {
+		resume.commandes[resume.nbCommandes++] = suite.commandes[i];
+	}
+	resume.feutreLeve = suite.feutreLeve;
+}
+
+# ifdef TORTUINO_ESTIMATION_NIVEAUX
+/**
+ * Résume une chaîne de symboles d'un L-système, dont les symboles qui ont une règle sont déjà
+ * résumés au niveau de la chaîne.
+ *
+ * @param resume     Le résumé à remplir.
+ * @param systeme    Le L-système.
+ * @param chaine     La chaîne de symboles.
+ * @param longueur   La longueur des traits au niveau de la chaîne.
+ * @param finale     Vrai pour une chaîne finale, dont les symboles ne sont plus réécrits.
+ * @param symboles   Les résumés de chaque règle au niveau de la chaîne, pour le feutre baissé
+ * 					 puis levé.
+ * @param feutreLeve La position du feutre au début de la chaîne.
+ */
+void resumerChaine(Resume &resume, const LSysteme &systeme, const char *chaine, float longueur, bool finale, Resume (*symboles)[2], bool feutreLeve) {
+	resumeVider(resume, feutreLeve);
+
+	for (; *chaine != '\0'; chaine++) {
+		const RegleLSysteme *regle = finale ? 0 : trouverRegle(systeme, *chaine);
+		Commande commande;
+		if (regle != 0) {
+			resumeConcatener(resume, symboles[regle - systeme.regles][resume.feutreLeve]);
+		}
+		else if (interpreterSymbole(systeme, *chaine, longueur, commande)) {
+			resumeAjouter(resume, commande, true);
+		}
+	}
+}
+
+/**
+ * Compte un L-système dans l'estimation en cours, niveau par niveau, sans le développer.
+ *
+ * @param systeme   Le L-système, qui n'a pas plus de nbMaxReglesEstimees règles.
+ * @param nbNiveaux Le nombre de niveaux, 1 n'interprétant que l'axiome.
+ * @param taille    La longueur en centimètres des traits de l'axiome.
+ */
+void estimerNiveaux(const LSysteme &systeme, int nbNiveaux, float taille) {
+	if (nbNiveaux > NB_MAX_NIVEAUX_LSYSTEME) {							// Comme lsystemeDemarrer().
+		nbNiveaux = NB_MAX_NIVEAUX_LSYSTEME;
+	}
+	if (nbNiveaux < 1) {
+		return;
+	}
+
+	static Resume resumes[2][nbMaxReglesEstimees][2];					// Les résumés de chaque règle au niveau en cours et au suivant,
+	int courant = 0;
+	float rapport = systeme.facteur / systeme.diviseur;
+
+	for (int niveau = nbNiveaux - 1; niveau >= 0; niveau--) {			// Du niveau le plus profond au premier.
+		float longueur = taille * pow(rapport, niveau);
+		for (int r = 0; r < systeme.nbRegles; r++) {
+			const RegleLSysteme &regle = systeme.regles[r];
+			for (int feutre = 0; feutre < 2; feutre++) {
+				Resume &resume = resumes[courant][r][feutre];
+				if (niveau + 1 < nbNiveaux) {							// Le symbole est réécrit au niveau suivant,
+					resumerChaine(resume, systeme, regle.reecriture, longueur * rapport, false, resumes[1 - courant], feutre);
+				}
+				else if (regle.finale != 0) {							// remplacé par sa chaîne finale au dernier,
+					resumerChaine(resume, systeme, regle.finale, longueur, true, 0, feutre);
+				}
+				else {													// ou interprété tel quel.
+					char symbole[2] = {regle.symbole, '\0'};
+					resumerChaine(resume, systeme, symbole, longueur, true, 0, feutre);
+				}
+			}
+		}
+		courant = 1 - courant;
+	}
+
+	static Resume axiome;												// hors de la pile, trop petite sur l'Arduino.
+	resumerChaine(axiome, systeme, systeme.axiome, taille, false, resumes[1 - courant], estimationCourante.feutreLeve);
+	resumeConcatener(estimationCourante, axiome);
+}
+# endif
+
+/**
+ * Prépare une estimation : les commandes qui attendaient encore sont d'abord exécutées pour de
+ * bon, puis celles qui suivent ne sont plus que comptées, jusqu'à estimationTerminer(). Le coût
+ * est calculé avec la géométrie et les vitesses réglées au moment de l'appel.
+ *
+ * @see estimationTerminer()
+ */
+void estimationDemarrer() {
+	estimationActive = false;
+	commandesVider();
+
+	modeleCout.pasParCentimetre = odometriePasParCentimetre() / 65536.0;
+	modeleCout.pasParDegre = odometrieGeometrie().pasParDegre / 65536.0;
+	modeleCout.braquage = odometrieGeometrie().braquage;
+	moteursLimites(PROFIL_TRACE, modeleCout.limites[PROFIL_TRACE]);
+	moteursLimites(PROFIL_DEPLACEMENT, modeleCout.limites[PROFIL_DEPLACEMENT]);
+
+	resumeVider(estimationCourante, feutreEstLeve());
+	estimationActive = true;
+}
+
+/**
+ * Termine l'estimation commencée par estimationDemarrer() : les commandes suivantes seront de
+ * nouveau exécutées. Le robot n'a pas bougé, et son feutre non plus.
+ *
+ * @return Le coût prévu de toutes les commandes données depuis estimationDemarrer().
+ */
+Estimation estimationTerminer() {
+	Cout cout = estimationCourante.cout;
+	for (int i = 0; i < estimationCourante.nbCommandes; i++) {
+		compterCommande(cout, estimationCourante.commandes[i]);
+	}
+	estimationActive = false;
+
+	Estimation estimation;
+	estimation.pasGauche = (unsigned long long)(cout.pasGauche + 0.5);
+	estimation.pasDroite = (unsigned long long)(cout.pasDroite + 0.5);
+	estimation.basculesFeutre = (unsigned long)(cout.basculesFeutre + 0.5);
+	estimation.duree = cout.duree;
+	return estimation;
+}
+
+/**
+ * Estime ce que coûtera un dessin, sans faire bouger le robot. Le dessin est exécuté, mais ses
+ * commandes ne sont que comptées ; si TORTUINO_ESTIMATION_NIVEAUX est défini, ceux de
+ * TortuinoDessins.cpp qui sont récursifs sont estimés par niveau sans être développés, en quelques
+ * microsecondes même au niveau 15. Par exemple :
+ *
+ * {@code
+ * 	void grandArbre() {
+ * 		arbre(15, 10);
+ * 	}
+ *
+ * 	Estimation estimation = estimer(grandArbre);	// estimation.duree est en secondes.
+ * }
+ *
+ * Le dessin ne doit pas attendre le bouton ni s'arrêter, et n'a pas besoin d'appeler terminer().
+ *
+ * @param  dessin La fonction qui trace le dessin.
+ * @return        Le nombre de pas prévu de chaque roue, le nombre de mouvements du feutre et la
+ * 				  durée prévue du tracé en secondes.
+ * @see estimationDemarrer()
+ */
+Estimation estimer(void (*dessin)()) {
+	estimationDemarrer();
+	dessin();
+	return estimationTerminer();
+}
+
+/**
+ * Indique si une estimation est en cours, auquel cas les commandes ne doivent pas être exécutées.
+ *
+ * @return Vrai entre estimationDemarrer() et estimationTerminer().
+ */
+bool estimationEnCours() {
+	return estimationActive;
+}
+
+/**
+ * Compte une commande de base dans l'estimation en cours. C'est ce que fait commandesAjouter()
+ * à la place d'ajouter la commande à sa file pendant une estimation.
+ *
+ * @param type       Le type de la commande : COMMANDE_AVANCER, COMMANDE_TOURNER, ...
+ * @param valeur     La distance en centimètres ou l'angle en degrés vers la gauche, selon le type.
+ * @param rayon      Le rayon en centimètres d'une COMMANDE_ARC.
+ * @param combinable Vrai si une fenêtre d'anticipation est ouverte, et que la commande peut donc
+ * 					 se combiner avec les précédentes.
+ */
+void estimationAjouter(unsigned char type, float valeur, float rayon, bool combinable) {
+	Commande commande;
+	commande.type = type;
+	commande.valeur = valeur;
+	commande.rayon = rayon;
+	resumeAjouter(estimationCourante, commande, combinable);
+}
+
+/**
+ * Compte un L-système entier dans l'estimation en cours. Si TORTUINO_ESTIMATION_NIVEAUX est
+ * défini, il n'est pas développé : chaque règle est résumée à chaque niveau, pour le feutre baissé
+ * et levé, à partir de ses résumés au niveau suivant, et le calcul ne dépend que du nombre de
+ * niveaux et de la longueur des règles. Sinon, ou pour un L-système de plus de nbMaxReglesEstimees
+ * règles, il est développé commande par commande.
+ *
+ * @param systeme   Le L-système.
+ * @param nbNiveaux Le nombre de niveaux, 1 n'interprétant que l'axiome.
+ * @param taille    La longueur en centimètres des traits de l'axiome.
+ * @see lsystemeTracer(const LSysteme &systeme, int nbNiveaux, float taille)
+ */
+void estimationLSysteme(const LSysteme &systeme, int nbNiveaux, float taille) {
+# ifdef TORTUINO_ESTIMATION_NIVEAUX
+	if (systeme.nbRegles <= nbMaxReglesEstimees) {
+		estimerNiveaux(systeme, nbNiveaux, taille);
+		return;
+	}
+# endif
+
+	DeveloppementLSysteme developpement;
+	Commande commande;
+	lsystemeDemarrer(developpement, systeme, nbNiveaux, taille);
+	while (lsystemeSuivant(developpement, commande)) {
+		resumeAjouter(estimationCourante, commande, true);
+	}
+}
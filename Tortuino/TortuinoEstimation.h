@@ -0,0 +1,37 @@
+/**
+ * @file TortuinoEstimation.h
+ * @brief Définition des fonctions implémentées dans TortuinoEstimation.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoEstimation.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et le
+ * type des estimations qu'elles renvoient.
+ */
+
+
+# ifndef TORTUINO_ESTIMATION_h
+#	define TORTUINO_ESTIMATION_h
+
+#	include "TortuinoLSysteme.h"
+
+//#	define TORTUINO_ESTIMATION_NIVEAUX
+
+#	ifdef TORTUINO_MESURES
+#		define TORTUINO_ESTIMATION_NIVEAUX
+#	endif
+
+	struct Estimation {
+		unsigned long long pasGauche;
+		unsigned long long pasDroite;
+		unsigned long basculesFeutre;
+		float duree;
+	};
+
+	void estimationDemarrer();
+	Estimation estimationTerminer();
+	Estimation estimer(void (*dessin)());
+	bool estimationEnCours();
+	void estimationAjouter(unsigned char type, float valeur, float rayon, bool combinable);
+	void estimationLSysteme(const LSysteme &systeme, int nbNiveaux, float taille);
+
+# endif
@@ -0,0 +1,87 @@
+# include "TortuinoFeutre.h"
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoMesures.h"
+
+
+/**
+ * @file TortuinoFeutre.cpp
+ * @brief Ce fichier gère le servomoteur qui monte et descend le feutre du robot.
+ * @version 1.0
+ *
+ * Le fichier TortuinoFeutre.cpp retient la position du feutre pour ne jamais renvoyer au
+ * servomoteur une commande qu'il a déjà reçue : descendre un feutre déjà baissé ne coûte ainsi
+ * plus rien, ce qui arrive par exemple à chaque nœud de arbreAsymetrique().<br/>
+ *
+ * Le temps que met le servomoteur à atteindre sa position n'est plus attendu systématiquement
+ * après chaque commande. Il est retenu sous la forme d'une échéance, et seul un tracé qui
+ * démarrerait avant que le feutre ne soit posé attend qu'elle soit passée : les rotations et
+ * les déplacements feutre levé démarrent immédiatement, pendant que le feutre finit de bouger.
+ *
+ * @see feutrePositionner(bool leve)
+ * @see feutreAttendrePose()
+ */
+
+
+
+const signed char	FEUTRE_INCONNU	=	-1;			/**< La position du feutre tant qu'aucune commande ne lui a été envoyée. */
+
+signed char			etatFeutre	=	FEUTRE_INCONNU;	/**< La dernière position demandée au feutre : 1 pour levé, 0 pour baissé, ou FEUTRE_INCONNU. */
+unsigned long		echeanceFeutre	=	0;			/**< L'instant, en ms selon materielMillis(), où le servomoteur aura atteint sa position. */
+
+
+/**
+ * Envoie le feutre en position haute ou basse, sauf s'il y est déjà. Elle n'attend pas que le
+ * servomoteur ait fini de bouger : elle retient seulement quand ce sera le cas.
+ *
+ * @param leve Vrai pour mettre le feutre en position haute, faux pour la position basse.
+ * @see feutreAttendrePose()
+ */
+void feutrePositionner(bool leve) {
+	if (etatFeutre == (leve ? 1 : 0)) {									// Le feutre y est déjà : rien à faire.
+		return;
+	}
+
+	materielFeutre(leve);												// Mise à la position demandée du feutre,
+	etatFeutre = leve ? 1 : 0;
+	echeanceFeutre = materielMillis() + DELAI_FEUTRE;					// qu'il aura atteint après ce délai.
+}
+
+/**
+ * Attend, si le feutre est baissé, qu'il ait fini de descendre. Elle est appelée avant chaque
+ * tracé pour que celui-ci ne commence pas en l'air ; un feutre levé n'est jamais attendu.
+ */
+void feutreAttendrePose() {
+	if (etatFeutre == 1) {
+		return;
+	}
+
+	if (feutreEstPose()) {
+		return;
+	}
+
+	CHRONO_PHASE(CHRONO_FEUTRE, phasePrecedente);
+	while ((long)(materielMillis() - echeanceFeutre) < 0) {
+		moteursPatienter();
+	}
+	CHRONO_REPRENDRE(phasePrecedente);
+}
+
+/**
+ * Indique si un tracé peut démarrer sans attendre le feutre, c'est-à-dire s'il est levé ou a fini
+ * de descendre. C'est ce qu'attend feutreAttendrePose().
+ *
+ * @return Vrai si le feutre est levé ou posé.
+ */
+bool feutreEstPose() {
+	return etatFeutre == 1 || (long)(materielMillis() - echeanceFeutre) >= 0;	// Comparaison par différence, correcte même quand le temps repasse à 0.
+}
+
+/**
+ * Indique si le feutre est en position haute.
+ *
+ * @return Vrai si la dernière position demandée au feutre est la position haute.
+ */
+bool feutreEstLeve() {
+	return etatFeutre == 1;
+}
@@ -0,0 +1,22 @@
+/**
+ * @file TortuinoFeutre.h
+ * @brief Définition des fonctions implémentées dans TortuinoFeutre.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoFeutre.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et le
+ * délai du servomoteur, dont TortuinoEstimation.cpp tient compte.
+ */
+
+
+# ifndef TORTUINO_FEUTRE_h
+#	define TORTUINO_FEUTRE_h
+
+	const int	DELAI_FEUTRE	=	200;				/**< Le délai en ms que met le servomoteur pour atteindre une position. Paramétré empiriquement. */
+
+	void feutrePositionner(bool leve);
+	void feutreAttendrePose();
+	bool feutreEstLeve();
+	bool feutreEstPose();
+
+# endif
@@ -0,0 +1,376 @@
+# include "Tortuino.h"
+# include "TortuinoHachures.h"
+# include "TortuinoCommandes.h"
+# include <math.h>
+
+
+/**
+ * @file TortuinoHachures.cpp
+ * @brief Ce fichier remplit des polygones de hachures parallèles.
+ * @version 1.0
+ *
+ * Le fichier TortuinoHachures.cpp remplit l'intérieur d'un polygone, éventuellement troué, de
+ * hachures parallèles régulièrement espacées. Comme pour TortuinoCourbes.cpp, les sommets sont
+ * donnés en centimètres dans le repère du robot au moment de l'appel : l'axe des x est la
+ * direction dans laquelle il regarde, l'axe des y part vers sa gauche. Un polygone peut avoir
+ * plusieurs contours, donnés à la suite : le premier est le bord extérieur, les suivants sont les
+ * trous, ou d'autres morceaux du même dessin. Un point est à l'intérieur s'il est entouré par un
+ * nombre impair de contours, si bien que leur sens de parcours n'a pas d'importance.
+ *
+ * {@code
+ * 	float cadre[][2] = {{0, 0}, {10, 0}, {10, 10}, {0, 10},	// Un carré de 10 cm,
+ * 						{3, 3}, {7, 3}, {7, 7}, {3, 7}};	// troué en son milieu,
+ * 	int nbSommets[] = {4, 4};
+ * 	hachurer(cadre, nbSommets, 2, 0.5, 45);				// hachuré en biais tous les 5 mm.
+ * }
+ *
+ * @image html	hachurer.png	"Le carré troué de l'exemple"	height=300px
+ * @image latex	hachurer.png	"Le carré troué de l'exemple"	height=200pt
+ *
+ * Les hachures sont tracées en boustrophédon, c'est-à-dire une ligne sur deux dans chaque sens :
+ * le robot n'a jamais à faire demi-tour, puisqu'il recule le long d'une hachure sur deux. Le
+ * passage d'une hachure à la suivante se fait feutre baissé le long du contour lorsque ce chemin
+ * est court, ce qui évite deux mouvements du feutre, et feutre levé sinon. Une hachure qui
+ * traverse un trou est coupée, le robot le franchissant feutre levé.<br/>
+ *
+ * Les hachures ne sont jamais toutes calculées à l'avance : chaque morceau de hachure est calculé
+ * au moment de le tracer, en cherchant parmi toutes les arêtes la prochaine que la hachure croise.
+ * Seules quelques variables locales sont donc nécessaires, quels que soient le nombre de sommets
+ * et le nombre de hachures. Comme dans TortuinoCourbes.cpp, chaque trajet est donné par
+ * tournerGauche() puis avancer() depuis le point visé par le précédent, et non depuis la position
+ * du robot : les commandes restent dans la file de TortuinoCommandes.cpp, où elles se combinent
+ * entre elles, et un remplissage ne bloque pas le croquis sous piloteDemarrer(). Les fractions de
+ * pas étant reportées d'un mouvement au suivant par TortuinoOdometrie.cpp, les centaines de
+ * rotations d'un grand remplissage n'accumulent pas d'erreur pour autant.
+ *
+ * @see hachurer(const float points[][2], const int nbSommets[], int nbContours, float ecart, float angle)
+ */
+
+
+
+const float		facteurLiaison		=	3;			/**< La longueur maximale, en nombre d'écarts entre hachures, d'un passage feutre baissé le long du contour d'une hachure à la suivante. */
+const float		longueurNegligeable	=	0.01;		/**< En dessous de cette longueur en centimètres, un morceau de hachure n'est pas tracé : c'est moins d'un pas. */
+
+/**
+ * Un remplissage en cours, dont les sommets sont vus dans le repère des hachures : l'axe des u
+ * suit les hachures, l'axe des v leur est perpendiculaire.
+ */
+struct Remplissage {
+	const float (*points)[2];											/**< Les sommets de tous les contours, à la suite, dans le repère du robot. */
+	const int *nbSommets;												/**< Le nombre de sommets de chaque contour. */
+	int nbContours;														/**< Le nombre de contours. */
+	int nbPoints;														/**< Le nombre total de sommets. */
+	float cosinus;														/**< Le cosinus de l'angle des hachures. */
+	float sinus;														/**< Le sinus de l'angle des hachures. */
+	float u;															/**< La position visée par le dernier trajet, le long des hachures. */
+	float v;															/**< La position visée par le dernier trajet, en travers des hachures. */
+	float cap;															/**< L'orientation du robot en degrés vers la gauche depuis l'axe des u. */
+};
+
+/**
+ * Le croisement d'une hachure et d'une arête du contour.
+ */
+struct Croisement {
+	float u;															/**< La position du croisement le long de la hachure. */
+	int arete;															/**< Le numéro de l'arête, qui est celui de son premier sommet, ou -1 s'il n'y a pas de croisement. */
+};
+
+
+/**
+ * Calcule la position d'un sommet le long des hachures.
+ *
+ * @param  remplissage Le remplissage en cours.
+ * @param  i           Le numéro du sommet.
+ * @return             Sa coordonnée u en centimètres.
+ */
+float abscisseSommet(const Remplissage &remplissage, int i) {
+	return remplissage.points[i][0] * remplissage.cosinus + remplissage.points[i][1] * remplissage.sinus;
+}
+
+/**
+ * Calcule la position d'un sommet en travers des hachures.
+ *
+ * @param  remplissage Le remplissage en cours.
+ * @param  i           Le numéro du sommet.
+ * @return             Sa coordonnée v en centimètres.
+ */
+float ordonneeSommet(const Remplissage &remplissage, int i) {
+	return remplissage.points[i][1] * remplissage.cosinus - remplissage.points[i][0] * remplissage.sinus;
+}
+
+/**
+ * Donne le voisin d'un sommet sur son contour.
+ *
+ * @param  remplissage Le remplissage en cours.
+ * @param  i           Le numéro du sommet.
+ * @param  sens        1 pour le sommet suivant, -1 pour le précédent.
+ * @return             Le numéro du voisin, le contour se refermant sur lui-même.
+ */
+int sommetVoisin(const Remplissage &remplissage, int i, int sens) {
+	int debut = 0;
+	for (int c = 0; c < remplissage.nbContours; c++) {
+		int fin = debut + remplissage.nbSommets[c];
+		if (i < fin) {
+			return sens > 0 ? (i + 1 < fin ? i + 1 : debut) : (i > debut ? i - 1 : fin - 1);
+		}
+		debut = fin;
+	}
+	return i;
+}
+
+/**
+ * Indique si un croisement en précède un autre le long d'une hachure parcourue dans un sens
+ * donné. Deux croisements au même endroit, sur un sommet, sont départagés par le numéro de leur
+ * arête, pour que chacun soit bien rencontré une fois.
+ *
+ * @param  a    Le premier croisement.
+ * @param  b    Le second croisement.
+ * @param  sens 1 si la hachure est parcourue dans le sens des u croissants, -1 sinon.
+ * @return      Vrai si a vient avant b.
+ */
+bool precede(const Croisement &a, const Croisement &b, int sens) {
+	return sens * a.u < sens * b.u || (a.u == b.u && a.arete < b.arete);
+}
+
+/**
+ * Cherche le prochain croisement d'une hachure avec le contour, en essayant toutes les arêtes.
+ * Une arête croise la hachure si l'un de ses sommets est au-dessus et l'autre non, ce qui compte
+ * une seule fois un sommet posé sur la hachure.
+ *
+ * @param  remplissage Le remplissage en cours.
+ * @param  v           La position de la hachure.
+ * @param  apres       Le dernier croisement rencontré.
+ * @param  sens        1 si la hachure est parcourue dans le sens des u croissants, -1 sinon.
+ * @return             Le croisement suivant, dont l'arête vaut -1 s'il n'y en a plus.
+ */
+Croisement croisementSuivant(const Remplissage &remplissage, float v, const Croisement &apres, int sens) {
+	Croisement meilleur = {0, -1};
+
+	for (int i = 0; i < remplissage.nbPoints; i++) {
+		int j = sommetVoisin(remplissage, i, 1);
+		float vi = ordonneeSommet(remplissage, i), vj = ordonneeSommet(remplissage, j);
+		if ((vi <= v) == (vj <= v)) {
+			continue;
+		}
+
+		float ui = abscisseSommet(remplissage, i), uj = abscisseSommet(remplissage, j);
+		Croisement croisement = {ui + (v - vi) * (uj - ui) / (vj - vi), i};
+		if (precede(apres, croisement, sens) && (meilleur.arete < 0 || precede(croisement, meilleur, sens))) {
+			meilleur = croisement;
+		}
+	}
+
+	return meilleur;
+}
+
+/**
+ * Donne le croisement fictif qui précède tous les autres le long d'une hachure.
+ *
+ * @param  sens Le sens de parcours de la hachure.
+ * @return      Un croisement à l'infini, derrière le robot.
+ */
+Croisement croisementDebut(int sens) {
+	Croisement debut = {(float)(-sens * HUGE_VAL), -1};
+	return debut;
+}
+
+/**
+ * Emmène le robot en ligne droite vers un point donné dans le repère des hachures, depuis le
+ * point visé par le trajet précédent. Comme allerA(float x, float y), il recule plutôt que de
+ * tourner de plus de 90°, ce qui trace le même trait.
+ *
+ * @param remplissage Le remplissage en cours.
+ * @param u           La position du point le long des hachures.
+ * @param v           Sa position en travers des hachures.
+ */
+void rejoindre(Remplissage &remplissage, float u, float v) {
+	float distance = hypot(u - remplissage.u, v - remplissage.v);
+	if (distance < longueurNegligeable) {								// Le reste s'ajoutera au trajet suivant.
+		return;
+	}
+
+	float virage = fmod(atan2(v - remplissage.v, u - remplissage.u) * 180 / M_PI - remplissage.cap + 540, 360) - 180;
+	if (virage > 90) {													// Il est plus court de tourner dans l'autre sens
+		virage -= 180;													// et de reculer.
+		distance = -distance;
+	}
+	else if (virage < -90) {
+		virage += 180;
+		distance = -distance;
+	}
+
+	tournerGauche(virage);												// La file supprime le virage s'il est nul.
+	avancer(distance);
+	remplissage.u = u;
+	remplissage.v = v;
+	remplissage.cap += virage;
+}
+
+/**
+ * Mesure, et trace si demandé, le chemin qui suit le contour depuis le croisement d'une hachure
+ * jusqu'à celui d'une autre, en passant par les sommets qui les séparent.
+ *
+ * @param  remplissage Le remplissage en cours.
+ * @param  depart      Le croisement de départ.
+ * @param  vDepart     La position de sa hachure.
+ * @param  arrivee     Le croisement d'arrivée.
+ * @param  vArrivee    La position de sa hachure.
+ * @param  sens        1 pour suivre le contour dans l'ordre de ses sommets, -1 dans l'autre.
+ * @param  longueurMax La longueur au-delà de laquelle le chemin est abandonné.
+ * @param  tracer      Vrai pour emmener le robot le long du chemin.
+ * @return             La longueur du chemin en centimètres, ou HUGE_VAL s'il dépasse longueurMax
+ * 					   ou n'atteint pas l'arête d'arrivée.
+ */
+float suivreContour(Remplissage &remplissage, const Croisement &depart, float vDepart, const Croisement &arrivee, float vArrivee, int sens, float longueurMax, bool tracer) {
+	float u = depart.u, v = vDepart, longueur = 0;
+	int arete = depart.arete;
+
+	for (int n = 0; n <= remplissage.nbPoints; n++) {
+		float uCible = arrivee.u, vCible = vArrivee;
+		if (arete != arrivee.arete) {									// Le prochain sommet dans le sens du chemin.
+			int sommet = sens > 0 ? sommetVoisin(remplissage, arete, 1) : arete;
+			uCible = abscisseSommet(remplissage, sommet);
+			vCible = ordonneeSommet(remplissage, sommet);
+		}
+
+		longueur += hypot(uCible - u, vCible - v);
+		if (longueur > longueurMax) {
+			return HUGE_VAL;
+		}
+		if (tracer) {
+			rejoindre(remplissage, uCible, vCible);
+		}
+		if (arete == arrivee.arete) {
+			return longueur;
+		}
+
+		u = uCible;
+		v = vCible;
+		arete = sommetVoisin(remplissage, arete, sens);
+	}
+
+	return HUGE_VAL;
+}
+
+/**
+ * Remplit de hachures parallèles un polygone fait d'un seul contour.
+ *
+ * {@code
+ * 	float toit[][2] = {{0, 0}, {10, 0}, {5, 5}};
+ * 	hachurer(toit, 3, 0.3, 90);			// Des hachures verticales tous les 3 mm.
+ * }
+ *
+ * @param points   Les sommets du polygone, en centimètres dans le repère du robot : vers l'avant
+ * 				   puis vers la gauche.
+ * @param nbPoints Le nombre de sommets.
+ * @param ecart    L'écart en centimètres entre deux hachures.
+ * @param angle    L'angle en degrés des hachures, vers la gauche depuis la direction du robot.
+ * @see hachurer(const float points[][2], const int nbSommets[], int nbContours, float ecart, float angle)
+ */
+void hachurer(const float points[][2], int nbPoints, float ecart, float angle) {
+	hachurer(points, &nbPoints, 1, ecart, angle);
+}
+
+/**
+ * Remplit de hachures parallèles un polygone fait de plusieurs contours, comme un polygone troué.
+ * Les hachures sont centrées sur le polygone et tracées en boustrophédon, en commençant par le
+ * bout le plus proche du robot. Le robot finit au bout de la dernière hachure, tourné comme au
+ * départ et feutre levé.
+ *
+ * @param points     Les sommets de tous les contours, à la suite, en centimètres dans le repère
+ * 					 du robot : vers l'avant puis vers la gauche.
+ * @param nbSommets  Le nombre de sommets de chaque contour.
+ * @param nbContours Le nombre de contours.
+ * @param ecart      L'écart en centimètres entre deux hachures.
+ * @param angle      L'angle en degrés des hachures, vers la gauche depuis la direction du robot.
+ * @see hachurer(const float points[][2], int nbPoints, float ecart, float angle)
+ */
+void hachurer(const float points[][2], const int nbSommets[], int nbContours, float ecart, float angle) {
+	Remplissage remplissage;
+	remplissage.points = points;
+	remplissage.nbSommets = nbSommets;
+	remplissage.nbContours = nbContours;
+	remplissage.nbPoints = 0;
+	remplissage.cosinus = cos(angle * M_PI / 180);
+	remplissage.sinus = sin(angle * M_PI / 180);
+	for (int c = 0; c < nbContours; c++) {
+		remplissage.nbPoints += nbSommets[c];
+	}
+	if (remplissage.nbPoints < 3 || ecart <= 0) {
+		return;
+	}
+
+	float vMin = ordonneeSommet(remplissage, 0), vMax = vMin;
+	for (int i = 1; i < remplissage.nbPoints; i++) {
+		vMin = fmin(vMin, ordonneeSommet(remplissage, i));
+		vMax = fmax(vMax, ordonneeSommet(remplissage, i));
+	}
+	int nbHachures = (int)ceil((vMax - vMin) / ecart);
+	if (nbHachures < 1) {
+		nbHachures = 1;
+	}
+	float v = vMin + (vMax - vMin - (nbHachures - 1) * ecart) / 2;		// Les hachures sont centrées sur le polygone,
+	float pas = ecart;
+	if (fabs(v + (nbHachures - 1) * ecart) < fabs(v)) {					// et commencent du côté du robot.
+		v += (nbHachures - 1) * ecart;
+		pas = -ecart;
+	}
+	int sens = fabs(croisementSuivant(remplissage, v, croisementDebut(1), 1).u) <= fabs(croisementSuivant(remplissage, v, croisementDebut(-1), -1).u) ? 1 : -1;
+
+	remplissage.u = 0;													// Le robot part de l'origine de son repère,
+	remplissage.v = 0;
+	remplissage.cap = -angle;											// tourné vers ses x.
+	commandesOuvrir();
+	monterFeutre();
+	bool leve = true;
+	Croisement fin = {0, -1};											// La fin du dernier morceau tracé.
+	float vFin = 0;
+
+	for (int k = 0; k < nbHachures; k++, v += pas, sens = -sens) {
+		Croisement entree = croisementSuivant(remplissage, v, croisementDebut(sens), sens);
+		bool premier = true;
+
+		while (entree.arete >= 0) {
+			Croisement sortie = croisementSuivant(remplissage, v, entree, sens);
+			if (sortie.arete < 0) {
+				break;
+			}
+			if (fabs(sortie.u - entree.u) < longueurNegligeable) {		// Une hachure qui ne fait que frôler un sommet.
+				entree = croisementSuivant(remplissage, v, sortie, sens);
+				continue;
+			}
+
+			bool longe = false;
+			if (premier && fin.arete >= 0) {							// D'une hachure à la suivante, on longe le contour
+				float longueurMax = facteurLiaison * ecart;				// dans le sens le plus court s'il est assez court.
+				float avant = suivreContour(remplissage, fin, vFin, entree, v, 1, longueurMax, false);
+				float arriere = suivreContour(remplissage, fin, vFin, entree, v, -1, longueurMax, false);
+				if (fmin(avant, arriere) < HUGE_VAL) {
+					suivreContour(remplissage, fin, vFin, entree, v, avant <= arriere ? 1 : -1, longueurMax, true);
+					longe = true;
+				}
+			}
+			if (!longe) {
+				if (!leve) {
+					monterFeutre();
+					leve = true;
+				}
+				rejoindre(remplissage, entree.u, v);
+			}
+			if (leve) {
+				descendreFeutre();
+				leve = false;
+			}
+			rejoindre(remplissage, sortie.u, v);
+
+			fin = sortie;
+			vFin = v;
+			premier = false;
+			entree = croisementSuivant(remplissage, v, sortie, sens);
+		}
+	}
+
+	monterFeutre();
+	tournerGauche(fmod(-angle - remplissage.cap + 540, 360) - 180);		// Le robot reprend son cap de départ.
+	commandesFermer();
+}
@@ -0,0 +1,17 @@
+/**
+ * @file TortuinoHachures.h
+ * @brief Définition des fonctions implémentées dans TortuinoHachures.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoHachures.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions.
+ */
+
+
+# ifndef TORTUINO_HACHURES_h
+#	define TORTUINO_HACHURES_h
+
+	void hachurer(const float points[][2], int nbPoints, float ecart, float angle);
+	void hachurer(const float points[][2], const int nbSommets[], int nbContours, float ecart, float angle);
+
+# endif
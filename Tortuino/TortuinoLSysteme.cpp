@@ -0,0 +1,210 @@
+# include "Tortuino.h"
+# include "TortuinoLSysteme.h"
+# include "TortuinoMesures.h"
+# include "TortuinoEstimation.h"
+
+
+/**
+ * @file TortuinoLSysteme.cpp
+ * @brief Ce fichier développe des L-systèmes en commandes de base, sans récursion.
+ * @version 1.0
+ *
+ * Le fichier TortuinoLSysteme.cpp trace les dessins décrits par un
+ * <a href="https://fr.wikipedia.org/wiki/L-Syst%C3%A8me">L-système</a> : un axiome, c'est-à-dire
+ * une chaîne de symboles de départ, et des règles qui remplacent certains symboles par d'autres
+ * chaînes à chaque niveau. Les symboles suivants sont compris comme des commandes de base :
+ * - `F` avance et `B` recule de la longueur du niveau en cours ;
+ * - `+` et `-` tournent à gauche et à droite du premier angle du L-système, `<` et `>` du
+ *   deuxième, `{` et `}` du troisième ;
+ * - `^` monte le feutre et `v` le descend.
+ *
+ * Tous les autres symboles sont ignorés s'ils n'ont pas de règle. Un symbole qui a une règle est
+ * remplacé par sa réécriture tant que le nombre de niveaux demandé n'est pas atteint ; les
+ * symboles de la réécriture appartiennent au niveau suivant, dont la longueur est celle du niveau
+ * en cours multipliée par le facteur puis divisée par le diviseur du L-système. Au dernier niveau,
+ * il est remplacé par sa chaîne finale, dont les symboles restent au même niveau et ne sont plus
+ * réécrits, ou interprété tel quel s'il n'en a pas.<br/>
+ *
+ * Le développement ne se fait pas par des appels récursifs, qui sur un Arduino Uno et ses 2 Ko
+ * de mémoire vive finissent par déborder sans prévenir, mais avec une pile explicite de taille
+ * fixe : elle garde seulement, pour chaque niveau en cours, la position atteinte dans sa chaîne.
+ * La mémoire utilisée ne dépend donc que du nombre de niveaux, et pas de la longueur du dessin,
+ * et les commandes sont produites une à une au fur et à mesure du tracé.
+ *
+ * @see lsystemeTracer(const LSysteme &systeme, int nbNiveaux, float taille)
+ */
+
+
+
+/**
+ * Cherche la règle d'un symbole dans un L-système.
+ *
+ * @param  systeme Le L-système.
+ * @param  symbole Le symbole.
+ * @return         La règle du symbole, ou NULL s'il n'en a pas.
+ */
+const RegleLSysteme *trouverRegle(const LSysteme &systeme, char symbole) {
+	for (int i = 0; i < systeme.nbRegles; i++) {
+		if (systeme.regles[i].symbole == symbole) {
+			return &systeme.regles[i];
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Traduit un symbole en commande de base.
+ *
+ * @param  systeme  Le L-système auquel appartient le symbole, pour ses angles.
+ * @param  symbole  Le symbole à traduire.
+ * @param  longueur La longueur du niveau du symbole, en centimètres.
+ * @param  commande La commande à remplir.
+ * @return          Vrai si le symbole est une commande, faux s'il doit être ignoré.
+ */
+bool interpreterSymbole(const LSysteme &systeme, char symbole, float longueur, Commande &commande) {
+	commande.valeur = 0;
+
+	switch (symbole) {
+		case 'F':	commande.type = COMMANDE_AVANCER;	commande.valeur = longueur;				break;
+		case 'B':	commande.type = COMMANDE_AVANCER;	commande.valeur = -longueur;			break;
+		case '+':	commande.type = COMMANDE_TOURNER;	commande.valeur = systeme.angles[0];	break;
+		case '-':	commande.type = COMMANDE_TOURNER;	commande.valeur = -systeme.angles[0];	break;
+		case '<':	commande.type = COMMANDE_TOURNER;	commande.valeur = systeme.angles[1];	break;
+		case '>':	commande.type = COMMANDE_TOURNER;	commande.valeur = -systeme.angles[1];	break;
+		case '{':	commande.type = COMMANDE_TOURNER;	commande.valeur = systeme.angles[2];	break;
+		case '}':	commande.type = COMMANDE_TOURNER;	commande.valeur = -systeme.angles[2];	break;
+		case '^':	commande.type = COMMANDE_MONTER_FEUTRE;										break;
+		case 'v':	commande.type = COMMANDE_DESCENDRE_FEUTRE;									break;
+		default:	return false;
+	}
+
+	return true;
+}
+
+/**
+ * Prépare le développement d'un L-système. Ses commandes sont ensuite obtenues une à une par
+ * lsystemeSuivant(DeveloppementLSysteme &developpement, Commande &commande).
+ *
+ * @param developpement Le développement à préparer ; il ne fait que quelques centaines d'octets
+ * 						et peut donc être une variable locale.
+ * @param systeme       Le L-système à développer. Il doit exister jusqu'à la fin du développement.
+ * @param nbNiveaux     Le nombre de niveaux, 1 n'interprétant que l'axiome. Il est ramené à
+ * 						NB_MAX_NIVEAUX_LSYSTEME s'il le dépasse : à ce niveau, les dessins de
+ * 						TortuinoDessins.cpp ont depuis longtemps des traits plus courts qu'un pas.
+ * @param taille        La longueur en centimètres des traits de l'axiome.
+ */
+void lsystemeDemarrer(DeveloppementLSysteme &developpement, const LSysteme &systeme, int nbNiveaux, float taille) {
+	if (nbNiveaux > NB_MAX_NIVEAUX_LSYSTEME) {
+		nbNiveaux = NB_MAX_NIVEAUX_LSYSTEME;
+	}
+
+	developpement.systeme = &systeme;
+	developpement.nbNiveaux = nbNiveaux;
+	developpement.hauteur = 0;
+
+	if (nbNiveaux >= 1) {												// Sans niveau, il n'y a rien à tracer.
+		CadreLSysteme &axiome = developpement.pile[developpement.hauteur++];
+		axiome.suivant = systeme.axiome;
+		axiome.longueur = taille;
+		axiome.niveau = 0;
+		axiome.finale = false;
+	}
+}
+
+/**
+ * Avance le développement d'un L-système jusqu'à sa prochaine commande de base.
+ *
+ * @param  developpement Le développement préparé par lsystemeDemarrer().
+ * @param  commande      La commande à remplir.
+ * @return               Vrai si une commande a été produite, faux si le dessin est terminé.
+ */
+bool lsystemeSuivant(DeveloppementLSysteme &developpement, Commande &commande) {
+	const LSysteme &systeme = *developpement.systeme;
+
+	while (developpement.hauteur > 0) {
+		CadreLSysteme &cadre = developpement.pile[developpement.hauteur - 1];
+		const char symbole = *cadre.suivant++;
+		const float longueur = cadre.longueur;
+		const unsigned char niveau = cadre.niveau;
+		const bool finale = cadre.finale;
+
+		if (symbole == '\0') {											// La chaîne du sommet est terminée :
+			developpement.hauteur--;									// on reprend celle du niveau inférieur.
+			continue;
+		}
+
+		if (*cadre.suivant == '\0') {									// Un cadre dont la chaîne est épuisée n'a plus à être gardé,
+			developpement.hauteur--;									// ce qui laisse sa place au cadre qui suit.
+		}
+
+		const RegleLSysteme *regle = finale ? 0 : trouverRegle(systeme, symbole);
+		const char *chaine = 0;
+		CadreLSysteme suivant;
+
+		if (regle != 0 && niveau + 1 < developpement.nbNiveaux) {		// Le symbole est réécrit au niveau suivant,
+			chaine = regle->reecriture;
+			suivant.longueur = longueur * systeme.facteur / systeme.diviseur;
+			suivant.niveau = niveau + 1;
+			suivant.finale = false;
+		}
+		else if (regle != 0 && regle->finale != 0) {					// ou remplacé par sa chaîne finale au dernier.
+			chaine = regle->finale;
+			suivant.longueur = longueur;
+			suivant.niveau = niveau;
+			suivant.finale = true;
+		}
+
+		if (chaine != 0) {
+			suivant.suivant = chaine;
+			developpement.pile[developpement.hauteur++] = suivant;
+			MESURE_PROFONDEUR(developpement.hauteur);					// C'est toute la mémoire qu'utilise le dessin.
+		}
+		else if (interpreterSymbole(systeme, symbole, longueur, commande)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Trace un L-système en passant chacune de ses commandes aux fonctions de base de Tortuino.cpp.
+ * Elles profitent de la fenêtre d'anticipation des dessins, comme celles de TortuinoDessins.cpp.
+ * Pendant une estimation, le L-système n'est pas développé : TortuinoEstimation.cpp en calcule
+ * directement le coût, niveau par niveau.
+ *
+ * @param systeme   Le L-système à tracer.
+ * @param nbNiveaux Le nombre de niveaux, 1 n'interprétant que l'axiome.
+ * @param taille    La longueur en centimètres des traits de l'axiome.
+ * @see lsystemeDemarrer(DeveloppementLSysteme &developpement, const LSysteme &systeme, int nbNiveaux, float taille)
+ */
+void lsystemeTracer(const LSysteme &systeme, int nbNiveaux, float taille) {
+	if (estimationEnCours()) {
+		estimationLSysteme(systeme, nbNiveaux, taille);
+		return;
+	}
+
+	DeveloppementLSysteme developpement;
+	Commande commande;
+
+	commandesOuvrir();
+	lsystemeDemarrer(developpement, systeme, nbNiveaux, taille);
+	while (lsystemeSuivant(developpement, commande)) {
+		switch (commande.type) {
+			case COMMANDE_AVANCER:
+				avancer(commande.valeur);
+				break;
+			case COMMANDE_TOURNER:
+				tournerGauche(commande.valeur);
+				break;
+			case COMMANDE_MONTER_FEUTRE:
+				monterFeutre();
+				break;
+			case COMMANDE_DESCENDRE_FEUTRE:
+				descendreFeutre();
+				break;
+		}
+	}
+	commandesFermer();
+}
@@ -0,0 +1,54 @@
+/**
+ * @file TortuinoLSysteme.h
+ * @brief Définition des fonctions implémentées dans TortuinoLSysteme.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoLSysteme.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et les
+ * types décrivant un L-système et son développement en cours.
+ */
+
+
+# ifndef TORTUINO_LSYSTEME_h
+#	define TORTUINO_LSYSTEME_h
+
+#	include "TortuinoCommandes.h"
+
+	const int	NB_MAX_NIVEAUX_LSYSTEME	=	16;
+
+	struct RegleLSysteme {
+		char symbole;
+		const char *reecriture;
+		const char *finale;
+	};
+
+	struct LSysteme {
+		const char *axiome;
+		const RegleLSysteme *regles;
+		int nbRegles;
+		float facteur;
+		float diviseur;
+		float angles[3];
+	};
+
+	struct CadreLSysteme {
+		const char *suivant;
+		float longueur;
+		unsigned char niveau;
+		bool finale;
+	};
+
+	struct DeveloppementLSysteme {
+		const LSysteme *systeme;
+		int nbNiveaux;
+		int hauteur;
+		CadreLSysteme pile[NB_MAX_NIVEAUX_LSYSTEME + 1];
+	};
+
+	const RegleLSysteme *trouverRegle(const LSysteme &systeme, char symbole);
+	bool interpreterSymbole(const LSysteme &systeme, char symbole, float longueur, Commande &commande);
+	void lsystemeDemarrer(DeveloppementLSysteme &developpement, const LSysteme &systeme, int nbNiveaux, float taille);
+	bool lsystemeSuivant(DeveloppementLSysteme &developpement, Commande &commande);
+	void lsystemeTracer(const LSysteme &systeme, int nbNiveaux, float taille);
+
+# endif
@@ -0,0 +1,295 @@
+# include "Tortuino.h"
+# include "TortuinoLecteur.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoMesures.h"
+
+
+/**
+ * @file TortuinoLecteur.cpp
+ * @brief Ce fichier trace les dessins enregistrés dans un fichier binaire, par exemple sur une carte SD.
+ * @version 1.0
+ *
+ * Le fichier TortuinoLecteur.cpp permet de tracer des dessins qui ne sont pas compilés dans le
+ * croquis : ils sont lus au fur et à mesure depuis un fichier, et peuvent donc être bien plus
+ * grands que la mémoire flash de l'Arduino, ou changer sans recharger le croquis. Sur le robot,
+ * le fichier se trouve sur une carte SD, ce qui demande le câblage CablageLecteurSD, choisi en
+ * décommentant TORTUINO_LECTEUR_SD au début de TortuinoProfils.h ; sur un ordinateur, c'est un
+ * fichier ordinaire.<br/>
+ *
+ * Un fichier de dessin commence par les quatre octets de ENTETE_FICHIER, puis enchaîne des codes
+ * d'un octet, suivis pour certains d'un nombre :
+ * - CODE_AVANCER et CODE_TOURNER sont suivis d'une distance en millièmes de centimètre ou d'un
+ *   angle vers la gauche en centièmes de degré ;
+ * - CODE_ARC est suivi d'un rayon en millièmes de centimètre puis d'un angle vers la gauche en
+ *   centièmes de degré ;
+ * - CODE_MONTER_FEUTRE et CODE_DESCENDRE_FEUTRE n'ont pas de nombre ;
+ * - CODE_REPETER est suivi d'un nombre de répétitions, au moins 1, des codes qui le suivent
+ *   jusqu'au CODE_FIN_REPETER correspondant ; les répétitions peuvent être imbriquées sur
+ *   nbMaxRepetitions niveaux ;
+ * - CODE_FIN termine le dessin.
+ *
+ * Les nombres sont écrits sur un nombre variable d'octets : sept bits par octet en commençant par
+ * les plus faibles, le bit de poids fort indiquant qu'un octet suit. Les nombres signés sont
+ * d'abord repliés sur les positifs, 0, -1, 1, -2, ... devenant 0, 1, 2, 3, ... : un déplacement
+ * de quelques centimètres ne prend ainsi que trois octets avec son code.<br/>
+ *
+ * Le fichier est lu par blocs de tailleTampon octets dans deux tampons : pendant que les commandes
+ * d'un bloc s'exécutent, le bloc suivant est lu dans l'autre tampon par une tâche de fond appelée
+ * pendant les attentes des moteurs. Le tracé n'attend donc la carte qu'au tout premier bloc, ou
+ * lorsqu'une répétition revient à un bloc qui n'est plus en mémoire. Le tampon du début d'une
+ * répétition en cours est conservé tant qu'il faudra y revenir, si bien qu'une répétition plus
+ * courte qu'un bloc ne relit jamais la carte.
+ *
+ * @see dessinerFichier(const char *nom)
+ */
+
+
+
+const int		tailleTampon		=	TAILLE_BLOC_FICHIER;	/**< La taille en octets d'un bloc du fichier, et donc de chacun des deux tampons. */
+const int		nbMaxRepetitions	=	4;			/**< Le nombre maximal de répétitions imbriquées. */
+
+/**
+ * Un tampon contenant un bloc du fichier.
+ */
+struct Tampon {
+	unsigned long bloc;													/**< Le numéro du bloc, c'est-à-dire sa position dans le fichier divisée par tailleTampon. */
+	int taille;															/**< Le nombre d'octets lus, plus petit que tailleTampon pour le dernier bloc, ou -1 si le tampon est vide. */
+	unsigned char octets[tailleTampon];									/**< Les octets du bloc. */
+};
+
+/**
+ * Une répétition en cours.
+ */
+struct Repetition {
+	unsigned long debut;												/**< La position dans le fichier du premier code à répéter. */
+	unsigned long restantes;											/**< Le nombre de passages restant à faire, celui en cours compris. */
+};
+
+Tampon			tampons[2];						/**< Les deux tampons : l'un est en cours de lecture, l'autre se remplit en tâche de fond. */
+int				tamponCourant	=	0;			/**< L'indice du tampon contenant la position de lecture. */
+unsigned long	positionLecture	=	0;			/**< La position dans le fichier du prochain octet à lire. */
+Repetition		repetitions[nbMaxRepetitions];	/**< Les répétitions en cours, la plus intérieure en dernier. */
+int				nbRepetitions	=	0;			/**< Le nombre de répétitions en cours. */
+TacheAttente	tacheEnPlace	=	0;			/**< La tâche de fond en place avant le tracé, comme la réception de TortuinoLiaison.cpp, que prechargerBloc() continue d'appeler. */
+
+
+/**
+ * Indique si un tampon contient un bloc donné.
+ *
+ * @param  tampon Le tampon.
+ * @param  bloc   Le numéro du bloc.
+ * @return        Vrai si le tampon a été rempli avec ce bloc.
+ */
+bool tamponContient(const Tampon &tampon, unsigned long bloc) {
+	return tampon.taille >= 0 && tampon.bloc == bloc;
+}
+
+/**
+ * Remplit un tampon avec un bloc du fichier.
+ *
+ * @param tampon Le tampon à remplir.
+ * @param bloc   Le numéro du bloc à lire.
+ */
+void chargerBloc(Tampon &tampon, unsigned long bloc) {
+	tampon.bloc = bloc;
+	tampon.taille = materielFichierLire(bloc * tailleTampon, tampon.octets, tailleTampon);
+}
+
+/**
+ * La tâche de fond de la lecture : pendant que les moteurs travaillent, elle remplit le tampon
+ * qui n'est pas en cours de lecture avec le bloc suivant, sauf s'il contient le début d'une
+ * répétition qui n'est pas à son dernier passage. La tâche de fond qui était en place avant le
+ * tracé est appelée d'abord.
+ */
+void prechargerBloc() {
+	if (tacheEnPlace != 0) {
+		tacheEnPlace();
+	}
+
+	const Tampon &courant = tampons[tamponCourant];
+	Tampon &autre = tampons[1 - tamponCourant];
+
+	if (courant.taille < tailleTampon || tamponContient(autre, courant.bloc + 1)) {
+		return;															// Fin du fichier atteinte, ou bloc suivant déjà là.
+	}
+	if (nbRepetitions > 0 && repetitions[nbRepetitions - 1].restantes > 1
+			&& tamponContient(autre, repetitions[nbRepetitions - 1].debut / tailleTampon)) {
+		return;															// Il faudra bientôt y revenir.
+	}
+
+	chargerBloc(autre, courant.bloc + 1);
+}
+
+/**
+ * Lit l'octet suivant du fichier. Si son bloc n'a pas encore été lu en tâche de fond, il est lu
+ * immédiatement, ce qui fait attendre le tracé.
+ *
+ * @return L'octet lu, ou -1 à la fin du fichier ou en cas d'erreur.
+ */
+int lireOctet() {
+	const unsigned long bloc = positionLecture / tailleTampon;
+
+	if (!tamponContient(tampons[tamponCourant], bloc)) {				// On passe à l'autre tampon,
+		tamponCourant = 1 - tamponCourant;
+		if (!tamponContient(tampons[tamponCourant], bloc)) {			// qu'il faut remplir s'il n'a pas déjà le bon bloc.
+			MESURE_LECTURE_BLOQUANTE();
+			chargerBloc(tampons[tamponCourant], bloc);
+		}
+	}
+
+	const Tampon &tampon = tampons[tamponCourant];
+	const int decalage = positionLecture % tailleTampon;
+	if (decalage >= tampon.taille) {
+		return -1;
+	}
+
+	positionLecture++;
+	return tampon.octets[decalage];
+}
+
+/**
+ * Lit un nombre positif écrit sur un nombre variable d'octets.
+ *
+ * @param  valeur Le nombre lu.
+ * @return        Vrai si le nombre a pu être lu en entier.
+ */
+bool lireNombre(unsigned long &valeur) {
+	valeur = 0;
+	for (int decalage = 0; decalage < 32; decalage += 7) {
+		int octet = lireOctet();
+		if (octet < 0) {
+			return false;
+		}
+
+		valeur |= (unsigned long)(octet & 0x7F) << decalage;
+		if ((octet & 0x80) == 0) {										// Le bit de poids fort annonce un octet de plus.
+			return true;
+		}
+	}
+
+	return false;														// Plus de 32 bits : le fichier est abîmé.
+}
+
+/**
+ * Lit un nombre signé écrit sur un nombre variable d'octets, puis replié sur les positifs.
+ *
+ * @param  valeur Le nombre lu.
+ * @return        Vrai si le nombre a pu être lu en entier.
+ */
+bool lireNombreSigne(long &valeur) {
+	unsigned long replie;
+	if (!lireNombre(replie)) {
+		return false;
+	}
+
+	valeur = (replie & 1) ? -(long)(replie >> 1) - 1 : (long)(replie >> 1);
+	return true;
+}
+
+/**
+ * Exécute le code suivant du fichier.
+ *
+ * @param  fini Mis à vrai si le code était CODE_FIN.
+ * @return      Faux si le fichier est abîmé ou incomplet.
+ */
+bool executerCode(bool &fini) {
+	unsigned long nombre;
+	long valeur, angle;
+
+	switch (lireOctet()) {
+		case CODE_FIN:
+			fini = true;
+			return nbRepetitions == 0;
+
+		case CODE_AVANCER:
+			if (!lireNombreSigne(valeur)) {
+				return false;
+			}
+			avancer((float)valeur / UNITES_PAR_CENTIMETRE);
+			return true;
+
+		case CODE_TOURNER:
+			if (!lireNombreSigne(valeur)) {
+				return false;
+			}
+			tournerGauche((float)valeur / UNITES_PAR_DEGRE);
+			return true;
+
+		case CODE_ARC:
+			if (!lireNombreSigne(valeur) || !lireNombreSigne(angle)) {
+				return false;
+			}
+			arcGauche((float)valeur / UNITES_PAR_CENTIMETRE, (float)angle / UNITES_PAR_DEGRE);
+			return true;
+
+		case CODE_MONTER_FEUTRE:
+			monterFeutre();
+			return true;
+
+		case CODE_DESCENDRE_FEUTRE:
+			descendreFeutre();
+			return true;
+
+		case CODE_REPETER:
+			if (!lireNombre(nombre) || nombre == 0 || nbRepetitions == nbMaxRepetitions) {
+				return false;
+			}
+			repetitions[nbRepetitions].debut = positionLecture;
+			repetitions[nbRepetitions].restantes = nombre;
+			nbRepetitions++;
+			return true;
+
+		case CODE_FIN_REPETER:
+			if (nbRepetitions == 0) {
+				return false;
+			}
+			if (--repetitions[nbRepetitions - 1].restantes > 0) {		// Encore un passage : on revient au début,
+				positionLecture = repetitions[nbRepetitions - 1].debut;
+			}
+			else {														// sinon la répétition est terminée.
+				nbRepetitions--;
+			}
+			return true;
+
+		default:														// Code inconnu ou fin du fichier avant CODE_FIN.
+			return false;
+	}
+}
+
+/**
+ * Trace le dessin enregistré dans un fichier, au format décrit au début de ce fichier. Les
+ * commandes profitent de la fenêtre d'anticipation des dessins, comme celles de
+ * TortuinoDessins.cpp. Si le fichier est abîmé, le tracé s'arrête au premier code invalide.
+ *
+ * @param  nom Le nom du fichier, au format 8.3 sur une carte SD.
+ * @return     Vrai si le fichier a été tracé en entier, faux s'il n'a pas pu être ouvert ou
+ * 			   s'il est abîmé.
+ */
+bool dessinerFichier(const char *nom) {
+	if (!materielFichierOuvrir(nom)) {
+		return false;
+	}
+
+	tampons[0].taille = tampons[1].taille = -1;							// On repart de tampons vides
+	tamponCourant = 0;													// au début du fichier.
+	positionLecture = 0;
+	nbRepetitions = 0;
+
+	bool valide = true, fini = false;
+	for (int i = 0; i < 4; i++) {										// L'en-tête évite de tracer n'importe quel fichier.
+		valide = valide && lireOctet() == ENTETE_FICHIER[i];
+	}
+
+	commandesOuvrir();
+	tacheEnPlace = moteursTacheAttente(prechargerBloc);					// Les blocs suivants sont lus pendant les mouvements.
+	while (valide && !fini) {
+		valide = executerCode(fini);
+	}
+	moteursTacheAttente(tacheEnPlace);									// La tâche d'avant reprend seule.
+	commandesFermer();
+
+	materielFichierFermer();
+	return valide;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file TortuinoLecteur.h
+ * @brief Définition des fonctions implémentées dans TortuinoLecteur.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoLecteur.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont une fonction et les
+ * codes du format des fichiers de dessin, que partagent les outils qui les écrivent.
+ */
+
+
+# ifndef TORTUINO_LECTEUR_h
+#	define TORTUINO_LECTEUR_h
+
+	const unsigned char	CODE_FIN				=	0;
+	const unsigned char	CODE_AVANCER			=	1;
+	const unsigned char	CODE_TOURNER			=	2;
+	const unsigned char	CODE_MONTER_FEUTRE		=	3;
+	const unsigned char	CODE_DESCENDRE_FEUTRE	=	4;
+	const unsigned char	CODE_REPETER			=	5;
+	const unsigned char	CODE_FIN_REPETER		=	6;
+	const unsigned char	CODE_ARC				=	7;
+
+	const unsigned char	ENTETE_FICHIER[4]		=	{'T', 'R', 'T', 1};
+	const int			TAILLE_BLOC_FICHIER		=	64;
+	const int			UNITES_PAR_CENTIMETRE	=	1000;
+	const int			UNITES_PAR_DEGRE		=	100;
+
+	bool dessinerFichier(const char *nom);
+
+# endif
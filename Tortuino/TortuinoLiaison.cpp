@@ -0,0 +1,329 @@
+# include <stdint.h>
+# include "TortuinoLiaison.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoMesures.h"
+
+
+/**
+ * @file TortuinoLiaison.cpp
+ * @brief Ce fichier exécute des blocs de pas planifiés par un ordinateur et reçus par la liaison série.
+ * @version 1.0
+ *
+ * Le fichier TortuinoLiaison.cpp permet de confier tout le calcul d'un grand dessin à un
+ * ordinateur : celui-ci planifie les mouvements sous forme de blocs de pas, et le robot ne fait
+ * que les exécuter au fur et à mesure qu'ils arrivent par la liaison série du câble USB, au
+ * débit DEBIT_LIAISON. C'est une alternative aux fonctions bloquantes de Tortuino.cpp, qui peut
+ * tout à fait être utilisée dans le même croquis.<br/>
+ *
+ * Un bloc de pas indique le nombre de pas signé de chaque roue, l'intervalle en microsecondes
+ * entre deux pas de la roue qui en a le plus et la position du feutre pendant le bloc. Il est
+ * exécuté à cadence constante par moteursAjouterCadence() : les rampes d'accélération sont
+ * planifiées par l'ordinateur, qui envoie des blocs de plus en plus rapides. Le feutre ne change
+ * de position que lorsque les moteurs sont arrêtés. Les trames envoyées par l'ordinateur
+ * commencent par un octet de type :
+ * - TRAME_BONJOUR ouvre une session, et vide les blocs d'une éventuelle session précédente ;
+ * - TRAME_BLOC est suivie du numéro du bloc modulo 256, en comptant à partir de 0 dans la
+ *   session, puis des pas de la roue gauche et de la roue droite et de l'intervalle, chacun sur
+ *   deux octets en commençant par le poids faible, puis d'un octet de drapeaux dont
+ *   DRAPEAU_FEUTRE_LEVE, et enfin de la somme modulo 256 de ces huit octets ;
+ * - TRAME_FIN est suivie du nombre de blocs de la session modulo 256, et annonce qu'aucun bloc
+ *   ne suivra.
+ *
+ * Le robot répond par REPONSE_CREDITS suivi d'un nombre de blocs, REPONSE_ERREUR suivi du numéro
+ * du bloc qu'il attend lorsqu'une trame est invalide ou qu'un bloc manque, et REPONSE_FINI
+ * lorsque tous les blocs ont été exécutés après une TRAME_FIN. Si un octet a été perdu ou abîmé,
+ * la somme de la trame est fausse : le bloc est rejeté, et la réception se recale sur le
+ * prochain TRAME_BLOC que contenait la trame rejetée, sans jamais interpréter ses autres octets
+ * comme une TRAME_BONJOUR ou une TRAME_FIN. Les blocs qui suivent un bloc rejeté sont ignorés
+ * jusqu'à ce que l'ordinateur renvoie celui-ci, puis ceux-là : un octet abîmé ne coûte qu'un
+ * renvoi, et les blocs sont toujours exécutés dans l'ordre. Un bloc reçu deux fois est ignoré,
+ * et une TRAME_FIN n'est acceptée que si tous les blocs qu'elle annonce ont été reçus.<br/>
+ *
+ * Les blocs reçus attendent leur tour dans un anneau de TAILLE_ANNEAU_LIAISON blocs, d'où ils
+ * passent dans la file des moteurs dès qu'elle a de la place. Pour que ni l'anneau ni le tampon
+ * de réception de la carte ne débordent jamais, le contrôle de flux se fait par crédits :
+ * l'ordinateur ne peut envoyer que le nombre de blocs que le robot lui a accordés. Le robot
+ * n'accorde jamais plus de places que l'anneau n'en a de libres, ni plus de nbMaxCreditsEnVol
+ * trames à la fois, ce que peut contenir le tampon de 64 octets de l'Arduino Uno si les trames
+ * arrivent pendant une attente du feutre. Chaque bloc rangé dans l'anneau rend son crédit, et
+ * l'ordinateur récupère ceux des blocs rejetés ou ignorés en les renvoyant : une trame dont même
+ * le type s'est perdu ne fait donc perdre aucun crédit. Les places libres sont accordées de
+ * nouveau par paquets de seuilCredits. Comme les blocs sont bien plus courts à transmettre qu'à
+ * exécuter, l'anneau reste plein et les moteurs ne manquent jamais de travail ; les fois où cela
+ * arrive tout de même sont comptées par TortuinoMesures.cpp.
+ *
+ * @see liaisonServir()
+ */
+
+
+
+const int	seuilCredits	=	4;					/**< Le nombre de places libérées à partir duquel elles sont accordées à l'ordinateur. */
+const int	tailleTamponSerie	=	64;			/**< La taille en octets du tampon de réception de la liaison série de l'Arduino Uno. */
+const int	nbMaxCreditsEnVol	=	tailleTamponSerie / TAILLE_TRAME_BLOC;	/**< Le nombre maximal de trames accordées et pas encore reçues, qui tiennent ensemble dans ce tampon : 6. */
+
+/**
+ * Un bloc de pas reçu de l'ordinateur.
+ */
+struct BlocPas {
+	int16_t pasGauche;													/**< Le nombre de pas signé de la roue gauche. */
+	int16_t pasDroite;													/**< Le nombre de pas signé de la roue droite. */
+	uint16_t intervalle;												/**< L'intervalle en microsecondes entre deux pas de la roue qui en a le plus. */
+	uint8_t drapeaux;													/**< Les drapeaux du bloc, dont DRAPEAU_FEUTRE_LEVE. */
+};
+
+BlocPas			anneau[TAILLE_ANNEAU_LIAISON];	/**< Les blocs reçus qui ne sont pas encore dans la file des moteurs. */
+uint8_t			teteAnneau		=	0;			/**< L'indice du plus ancien bloc de l'anneau. */
+uint8_t			nbBlocs			=	0;			/**< Le nombre de blocs dans l'anneau. */
+uint8_t			creditsEnVol	=	0;			/**< Le nombre de blocs accordés à l'ordinateur et pas encore rangés dans l'anneau. */
+uint8_t			trame[TAILLE_TRAME_BLOC];		/**< La trame en cours de réception. */
+uint8_t			nbOctetsTrame	=	0;			/**< Le nombre d'octets déjà reçus de la trame en cours. */
+uint8_t			blocAttendu		=	0;			/**< Le numéro modulo 256 du prochain bloc à ranger dans l'anneau. */
+bool			enRejet			=	false;		/**< Vrai entre le rejet d'un bloc et la réception de son renvoi. */
+bool			sessionOuverte	=	false;		/**< Vrai entre une TRAME_BONJOUR et l'exécution de tous les blocs après une TRAME_FIN. */
+bool			finDemandee		=	false;		/**< Vrai si la TRAME_FIN de la session a été reçue. */
+bool			blocRecu		=	false;		/**< Vrai si la session a déjà reçu au moins un bloc. */
+bool			enFamine		=	false;		/**< Vrai tant que les moteurs sont arrêtés faute de blocs. */
+
+
+/**
+ * Accorde à l'ordinateur les places libres de l'anneau, dans la limite de ce que peut contenir
+ * le tampon de réception, si elles sont assez nombreuses ou si l'ordinateur n'a plus aucun
+ * crédit.
+ */
+void accorderCredits() {
+	if (!sessionOuverte || finDemandee) {								// Plus aucun bloc n'est attendu.
+		return;
+	}
+
+	int libres = TAILLE_ANNEAU_LIAISON - nbBlocs - creditsEnVol;
+	if (libres > nbMaxCreditsEnVol - creditsEnVol) {
+		libres = nbMaxCreditsEnVol - creditsEnVol;
+	}
+	if (libres >= seuilCredits || (libres > 0 && creditsEnVol == 0)) {
+		materielSerieEcrire(REPONSE_CREDITS);
+		materielSerieEcrire(libres);
+		creditsEnVol += libres;
+	}
+}
+
+/**
+ * Signale à l'ordinateur une trame invalide ou un bloc manquant, avec le numéro du bloc à
+ * renvoyer.
+ */
+void rejeter() {
+	materielSerieEcrire(REPONSE_ERREUR);
+	materielSerieEcrire(blocAttendu);
+	enRejet = true;
+}
+
+/**
+ * Vérifie la somme d'une trame de bloc complète.
+ *
+ * @return Vrai si la trame n'a pas été abîmée.
+ */
+bool trameIntacte() {
+	uint8_t somme = 0;
+	for (int i = 1; i < TAILLE_TRAME_BLOC - 1; i++) {
+		somme += trame[i];
+	}
+
+	return somme == trame[TAILLE_TRAME_BLOC - 1];
+}
+
+/**
+ * Oublie le début d'une trame abîmée, jusqu'au prochain TRAME_BLOC qu'elle contient : si un
+ * octet a été perdu, c'est là que commence la trame suivante.
+ */
+void recaler() {
+	int debut = 1;
+	while (debut < TAILLE_TRAME_BLOC && trame[debut] != TRAME_BLOC) {
+		debut++;
+	}
+
+	nbOctetsTrame = TAILLE_TRAME_BLOC - debut;
+	for (int i = 0; i < nbOctetsTrame; i++) {
+		trame[i] = trame[debut + i];
+	}
+}
+
+/**
+ * Place le bloc d'une trame intacte dans l'anneau.
+ *
+ * @return Vrai si l'anneau avait de la place.
+ */
+bool rangerBloc() {
+	if (nbBlocs == TAILLE_ANNEAU_LIAISON) {								// Crédits non respectés.
+		return false;
+	}
+
+	BlocPas &bloc = anneau[(teteAnneau + nbBlocs) % TAILLE_ANNEAU_LIAISON];
+	bloc.pasGauche = (int16_t)(trame[2] | (trame[3] << 8));
+	bloc.pasDroite = (int16_t)(trame[4] | (trame[5] << 8));
+	bloc.intervalle = (uint16_t)(trame[6] | (trame[7] << 8));
+	bloc.drapeaux = trame[8];
+	nbBlocs++;
+	blocRecu = true;
+	return true;
+}
+
+/**
+ * Traite une trame de bloc intacte selon son numéro : le bloc attendu est rangé dans l'anneau,
+ * un bloc en avance signale que celui-ci a été perdu, et un bloc déjà reçu est ignoré.
+ */
+void recevoirBloc() {
+	uint8_t avance = trame[1] - blocAttendu;
+	if (avance == 0 && rangerBloc()) {
+		if (creditsEnVol > 0) {											// Le bloc a utilisé son crédit,
+			creditsEnVol--;												// et sa place pourra être accordée de nouveau.
+		}
+		blocAttendu++;
+		enRejet = false;
+	}
+	else if (avance == 0 || (avance < 128 && !enRejet)) {				// Anneau plein, ou bloc perdu avant celui-ci :
+		rejeter();														// les suivants ne sont redemandés qu'une fois.
+	}
+}
+
+/**
+ * Traite une TRAME_FIN complète, qui n'est acceptée que si tous les blocs qu'elle annonce ont
+ * été reçus.
+ *
+ * @param nbBlocsSession Le nombre de blocs de la session modulo 256, second octet de la trame.
+ */
+void recevoirFin(uint8_t nbBlocsSession) {
+	if (nbBlocsSession == blocAttendu) {
+		finDemandee = true;
+	}
+	else {																// Le dernier bloc s'est perdu.
+		rejeter();
+	}
+}
+
+/**
+ * Lit tous les octets reçus et traite les trames complètes. Elle ne fait que remplir l'anneau :
+ * c'est la tâche de fond de la liaison, appelée aussi pendant les attentes des moteurs et du
+ * feutre pour que la liaison série ne déborde pas.
+ */
+void recevoirTrames() {
+	int octet;
+	while ((octet = materielSerieLire()) >= 0) {
+		if (nbOctetsTrame > 0 && trame[0] == TRAME_FIN) {				// Second octet d'une TRAME_FIN.
+			nbOctetsTrame = 0;
+			recevoirFin(octet);
+		}
+		else if (nbOctetsTrame > 0) {									// Suite d'une trame de bloc.
+			trame[nbOctetsTrame++] = octet;
+			if (nbOctetsTrame == TAILLE_TRAME_BLOC) {
+				if (!trameIntacte()) {
+					rejeter();
+					recaler();
+				}
+				else {
+					nbOctetsTrame = 0;
+					recevoirBloc();
+				}
+			}
+		}
+		else if (octet == TRAME_BLOC || octet == TRAME_FIN) {
+			trame[nbOctetsTrame++] = octet;
+		}
+		else if (octet == TRAME_BONJOUR) {								// Une nouvelle session oublie la précédente
+			nbBlocs = 0;												// et accorde l'anneau vide.
+			creditsEnVol = 0;
+			blocAttendu = 0;
+			enRejet = false;
+			sessionOuverte = true;
+			finDemandee = false;
+			blocRecu = false;
+			accorderCredits();
+		}
+		else if (!enRejet) {											// Reste d'une trame dont le type s'est perdu.
+			rejeter();
+		}
+	}
+}
+
+/**
+ * Ouvre la liaison série et prépare la réception des blocs. Les trames sont ensuite traitées par
+ * liaisonActualiser(), mais aussi pendant toutes les attentes de la bibliothèque.
+ */
+void liaisonDemarrer() {
+	materielSerieOuvrir(DEBIT_LIAISON);
+	nbBlocs = 0;
+	creditsEnVol = 0;
+	nbOctetsTrame = 0;
+	blocAttendu = 0;
+	enRejet = false;
+	sessionOuverte = false;
+	enFamine = false;
+	moteursTacheAttente(recevoirTrames);
+}
+
+/**
+ * Fait avancer la liaison sans jamais attendre les moteurs : elle traite les trames reçues, passe
+ * autant de blocs que possible dans la file des moteurs et accorde les places libérées à
+ * l'ordinateur. Seul un changement de position du feutre vers le bas fait attendre qu'il soit
+ * posé. Elle peut être appelée dans la fonction `loop()` d'un croquis.
+ *
+ * @return Faux une fois tous les blocs d'une session exécutés après sa TRAME_FIN, vrai sinon.
+ * @see liaisonDemarrer()
+ */
+bool liaisonActualiser() {
+	recevoirTrames();
+
+	while (nbBlocs > 0) {
+		const BlocPas &bloc = anneau[teteAnneau];
+		const bool leve = (bloc.drapeaux & DRAPEAU_FEUTRE_LEVE) != 0;
+
+		if (leve != feutreEstLeve()) {									// Le feutre ne bouge que moteurs arrêtés.
+			if (moteursOccupes()) {
+				break;
+			}
+			feutrePositionner(leve);
+			feutreAttendrePose();
+			continue;													// L'anneau a pu changer pendant l'attente.
+		}
+		if (!moteursPlaceLibre()) {										// On n'attend jamais une place dans la file.
+			break;
+		}
+
+		moteursAjouterCadence(bloc.pasGauche, bloc.pasDroite,
+			bloc.intervalle > 0 ? 1000000.0 / bloc.intervalle : FREQUENCE_MOTEURS);
+		teteAnneau = (teteAnneau + 1) % TAILLE_ANNEAU_LIAISON;
+		nbBlocs--;
+	}
+	accorderCredits();
+
+	if (sessionOuverte && nbBlocs == 0 && !moteursOccupes()) {
+		if (finDemandee) {												// Tout a été exécuté.
+			sessionOuverte = false;
+			materielSerieEcrire(REPONSE_FINI);
+			return false;
+		}
+		if (blocRecu && !enFamine) {									// Les moteurs attendent un bloc qui n'est pas arrivé.
+			MESURE_FAMINE();
+		}
+		enFamine = blocRecu;
+	}
+	else {
+		enFamine = false;
+	}
+
+	return true;
+}
+
+/**
+ * Exécute les blocs de pas envoyés par l'ordinateur jusqu'à la fin de la session. C'est la seule
+ * fonction à appeler dans un croquis dont tout le dessin est planifié par l'ordinateur, après
+ * initialiser().
+ *
+ * @see liaisonActualiser()
+ */
+void liaisonServir() {
+	liaisonDemarrer();
+	while (liaisonActualiser()) {
+		materielPatienter();
+	}
+}
@@ -0,0 +1,34 @@
+/**
+ * @file TortuinoLiaison.h
+ * @brief Définition des fonctions implémentées dans TortuinoLiaison.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoLiaison.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et les
+ * constantes du protocole, que partagent les outils qui envoient les blocs de pas.
+ */
+
+
+# ifndef TORTUINO_LIAISON_h
+#	define TORTUINO_LIAISON_h
+
+	const unsigned long	DEBIT_LIAISON			=	115200;
+
+	const unsigned char	TRAME_BONJOUR			=	'H';
+	const unsigned char	TRAME_BLOC				=	'B';
+	const unsigned char	TRAME_FIN				=	'T';
+
+	const unsigned char	REPONSE_CREDITS			=	'C';
+	const unsigned char	REPONSE_ERREUR			=	'E';
+	const unsigned char	REPONSE_FINI			=	'F';
+
+	const unsigned char	DRAPEAU_FEUTRE_LEVE		=	1;
+
+	const int			TAILLE_TRAME_BLOC		=	10;
+	const int			TAILLE_ANNEAU_LIAISON	=	16;
+
+	void liaisonDemarrer();
+	bool liaisonActualiser();
+	void liaisonServir();
+
+# endif
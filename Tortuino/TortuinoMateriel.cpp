@@ -0,0 +1,360 @@
+# include <Arduino.h>
+# include <Servo.h>
+# include <avr/interrupt.h>
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoProfils.h"
+# ifdef TORTUINO_LECTEUR_SD
+#	include <SD.h>
+# endif
+
+
+/**
+ * @file TortuinoMateriel.cpp
+ * @brief Ce fichier relie la bibliothèque aux composants du robot à travers la carte Arduino.
+ * @version 1.0
+ *
+ * Le fichier TortuinoMateriel.cpp est le seul de la bibliothèque à parler directement à la carte
+ * Arduino : il écrit sur les broches des bobines des moteurs pas à pas, commande le servomoteur
+ * du feutre, lit le bouton de démarrage différé, lit les fichiers de la carte SD s'il y a un
+ * lecteur, c'est-à-dire si TORTUINO_LECTEUR_SD est défini dans TortuinoProfils.h, communique par
+ * la liaison série et programme le Timer2 qui génère les pas. Le bouton peut aussi être surveillé
+ * pendant que le robot dessine : l'interruption du Timer2 relit alors régulièrement sa broche, ou,
+ * si TORTUINO_BOUTON_PCINT est défini dans TortuinoMateriel.h, c'est l'interruption de changement
+ * d'état de sa broche qui le signale. Le reste de la bibliothèque n'utilise que les fonctions
+ * déclarées dans TortuinoMateriel.h.<br/>
+ *
+ * Une autre version de ces fonctions, MaterielHote.cpp, se trouve dans le dossier OutilsTortuino :
+ * elle permet de compiler la bibliothèque sur un ordinateur et d'y exécuter les dessins sans
+ * robot, en enregistrant les pas et les mouvements du feutre au lieu de les réaliser.<br/>
+ *
+ * Les bobines ne sont pas écrites broche par broche avec `digitalWrite()`, qui cherche à chaque
+ * appel le port et le bit de la broche : materielInitialiser() précalcule pour chaque moteur et
+ * chaque phase le motif de bits à écrire dans le registre de son port (PORTB et PORTD dans le
+ * câblage standard). Un pas ne coûte alors qu'une seule écriture, faite par l'interruption des
+ * moteurs. Si les quatre broches d'un moteur ne sont pas sur le même port, ce moteur revient à
+ * `digitalWrite()`.
+ *
+ * @see materielInitialiser()
+ */
+
+
+
+const int	portsGauche[4]	=	{CablageRobot::GAUCHE_1, CablageRobot::GAUCHE_2, CablageRobot::GAUCHE_3, CablageRobot::GAUCHE_4};	/**< Les broches des quatre bobines du moteur pas à pas de gauche, dans l'ordre de la séquence : 10, 12, 11 et 13 dans le câblage standard. */
+const int	portsDroite[4]	=	{CablageRobot::DROITE_1, CablageRobot::DROITE_2, CablageRobot::DROITE_3, CablageRobot::DROITE_4};	/**< Les broches des quatre bobines du moteur pas à pas de droite, dans l'ordre de la séquence : 2, 4, 3 et 5 dans le câblage standard. */
+
+const byte	sequenceBobines[PHASES_DEMI_PAS]	=	{0b0101, 0b0100, 0b0110, 0b0010, 0b1010, 0b1000, 0b1001, 0b0001};	/**< Les bobines alimentées à chaque phase d'un demi-pas, le bit i correspondant à la broche i ; les pas complets n'en prennent qu'une sur deux. */
+
+const int	FEUTRE_HAUT	=	50,						/**< L'angle de la position haute du servomoteur. Il a été ajusté empiriquement. */
+			FEUTRE_BAS	=	10;						/**< L'angle de la position basse du servomoteur. Il a été ajusté empiriquement. */
+
+const int	portServo	=	CablageRobot::SERVO;	/**< Le numéro de la broche pour le port du servomoteur : 9. */
+const int	portBouton	=	CablageRobot::BOUTON;	/**< Le numéro de la broche qui sert de port pour le bouton permettant le démarrage différé : 7. */
+
+const int	portSD		=	CablageRobot::SD_SELECTION;	/**< Le numéro de la broche qui sélectionne le lecteur de carte SD, ou -1 s'il n'y en a pas. */
+# ifndef TORTUINO_BOUTON_PCINT
+const unsigned char	periodeBouton	=	16;		/**< Le nombre d'interruptions du Timer2 entre deux lectures du bouton surveillé : 3,2 ms, ce qui filtre aussi une partie de ses rebonds. */
+# endif
+
+Servo		servo;								/**< L'objet qui sert à contrôler le servomoteur soulevant et abaissant le feutre du robot. */
+void		(*rappelBouton)(bool)	=	NULL;	/**< La fonction appelée à chaque changement d'état du bouton, ou NULL s'il n'est pas surveillé. */
+# ifndef TORTUINO_BOUTON_PCINT
+volatile uint8_t	*registreBouton;			/**< Le registre d'entrée du port de la broche du bouton, lu par l'interruption du Timer2. */
+uint8_t		masqueBouton;						/**< Le bit de la broche du bouton dans ce registre. */
+bool		boutonAppuye	=	false;			/**< Le dernier état du bouton surveillé transmis à rappelBouton. */
+unsigned char	attenteBouton	=	0;			/**< Le nombre d'interruptions du Timer2 restant avant la prochaine lecture du bouton. */
+# endif
+# ifdef TORTUINO_LECTEUR_SD
+File		fichier;							/**< Le fichier de la carte SD ouvert par materielFichierOuvrir(). */
+bool		carteSDPrete	=	false;			/**< Vrai une fois la carte SD initialisée. */
+# endif
+
+volatile uint8_t	*registresBobines[2];			/**< Le registre du port des broches de chaque moteur, ou NULL s'il faut passer par `digitalWrite()`. */
+uint8_t				masquesBobines[2];				/**< Les bits du registre qu'occupent les broches de chaque moteur. */
+uint8_t				motifsBobines[2][PHASES_BOBINES];	/**< Les bits à écrire dans le registre pour chaque moteur et chaque phase. */
+
+
+/**
+ * Précalcule les motifs de bits des bobines d'un moteur, si ses quatre broches sont sur le même
+ * port.
+ *
+ * @param moteur Le moteur concerné : MOTEUR_GAUCHE ou MOTEUR_DROITE.
+ * @param ports  Les broches de ses bobines, dans l'ordre de la séquence.
+ */
+void preparerBobines(unsigned char moteur, const int *ports) {
+	uint8_t port = digitalPinToPort(ports[0]);
+	registresBobines[moteur] = portOutputRegister(port);
+	masquesBobines[moteur] = 0;
+
+	for (int i = 0; i < 4; i++) {
+		if (digitalPinToPort(ports[i]) != port) {						// Une écriture ne peut changer qu'un seul port.
+			registresBobines[moteur] = NULL;
+			return;
+		}
+		masquesBobines[moteur] |= digitalPinToBitMask(ports[i]);
+	}
+
+	for (int phase = 0; phase < PHASES_BOBINES; phase++) {
+		byte sequence = sequenceBobines[phase * PHASES_DEMI_PAS / PHASES_BOBINES];
+		motifsBobines[moteur][phase] = 0;
+		for (int i = 0; i < 4; i++) {
+			if ((sequence >> i) & 1) {
+				motifsBobines[moteur][phase] |= digitalPinToBitMask(ports[i]);
+			}
+		}
+	}
+}
+
+/**
+ * Prépare les broches du robot et programme le Timer2 pour qu'il déclenche moteursInterruption()
+ * à la fréquence FREQUENCE_MOTEURS. Elle est appelée par initialiser().
+ */
+void materielInitialiser() {
+	servo.attach(portServo);											// Affectation du port pour le servomoteur.
+	pinMode(portBouton, INPUT_PULLUP);									// Mode de la broche pour le bouton : entrée.
+# ifndef TORTUINO_BOUTON_PCINT
+	registreBouton = portInputRegister(digitalPinToPort(portBouton));	// Elle sera lue sans passer par digitalRead().
+	masqueBouton = digitalPinToBitMask(portBouton);
+# endif
+
+	for (int i = 0; i < 4; i++) {										// Toutes les broches des bobines
+		pinMode(portsGauche[i], OUTPUT);								// sont des sorties.
+		pinMode(portsDroite[i], OUTPUT);
+	}
+	preparerBobines(MOTEUR_GAUCHE, portsGauche);						// Puis on calcule une fois pour toutes
+	preparerBobines(MOTEUR_DROITE, portsDroite);						// ce qu'il faudra écrire à chaque pas.
+
+	noInterrupts();
+	TCCR2A = _BV(WGM21);												// Mode CTC : le compteur revient à 0 quand il atteint OCR2A,
+	TCCR2B = _BV(CS22);													// avec un prédiviseur de 64,
+	OCR2A = F_CPU / 64 / FREQUENCE_MOTEURS - 1;							// ce qui donne la fréquence voulue;
+	TCNT2 = 0;
+	TIMSK2 |= _BV(OCIE2A);												// et on active l'interruption associée.
+	interrupts();
+}
+
+/**
+ * Alimente les bobines d'un moteur pas à pas selon la phase donnée. Elle est appelée par
+ * moteursInterruption() à chaque pas : les interruptions y sont donc déjà coupées, et la lecture
+ * suivie de l'écriture du registre ne peut pas être interrompue par le servomoteur qui partage
+ * le même port.
+ *
+ * @param moteur Le moteur concerné : MOTEUR_GAUCHE ou MOTEUR_DROITE.
+ * @param phase  La phase à appliquer, de 0 à PHASES_BOBINES - 1.
+ */
+void materielBobines(unsigned char moteur, unsigned char phase) {
+	volatile uint8_t *registre = registresBobines[moteur];
+	if (registre != NULL) {												// Les quatre bobines d'un coup,
+		*registre = (*registre & ~masquesBobines[moteur]) | motifsBobines[moteur][phase];
+		return;
+	}
+
+	const int *ports = moteur == MOTEUR_GAUCHE ? portsGauche : portsDroite;
+	byte motif = sequenceBobines[phase * PHASES_DEMI_PAS / PHASES_BOBINES];	// ou bien une à une.
+	for (int i = 0; i < 4; i++) {
+		digitalWrite(ports[i], (motif >> i) & 1 ? HIGH : LOW);
+	}
+}
+
+/**
+ * Envoie le servomoteur du feutre en position haute ou basse, sans attendre qu'il y soit.
+ *
+ * @param leve Vrai pour la position haute, faux pour la position basse.
+ */
+void materielFeutre(bool leve) {
+	servo.write(leve ? FEUTRE_HAUT : FEUTRE_BAS);
+}
+
+/**
+ * Lit l'état du bouton de démarrage différé. Sa broche est tirée à l'état haut : il est donc
+ * appuyé quand elle est à l'état bas.
+ *
+ * @return Vrai si le bouton est appuyé.
+ */
+bool materielBoutonAppuye() {
+	return digitalRead(portBouton) == LOW;
+}
+
+/**
+ * Surveille le bouton de démarrage différé : la fonction donnée est appelée, depuis une
+ * interruption, à chacun de ses changements. Par défaut, c'est l'interruption du Timer2 qui relit
+ * sa broche toutes les periodeBouton interruptions. Si TORTUINO_BOUTON_PCINT est défini, c'est
+ * l'interruption de changement d'état de sa broche qui est utilisée, plus réactive ; la broche du
+ * câblage standard, la 7, étant sur le port D, c'est alors le vecteur PCINT2, ce qui empêche
+ * d'utiliser la bibliothèque SoftwareSerial dans le même croquis.
+ *
+ * @param rappel La fonction qui reçoit le nouvel état du bouton, vrai s'il vient d'être appuyé ; elle
+ * 				 doit être courte. NULL arrête la surveillance.
+ */
+void materielBoutonSurveiller(void (*rappel)(bool appuye)) {
+	noInterrupts();
+	rappelBouton = rappel;
+# ifndef TORTUINO_BOUTON_PCINT
+	boutonAppuye = materielBoutonAppuye();								// Seuls les changements suivants sont transmis.
+	attenteBouton = periodeBouton;
+# else
+	if (rappel != NULL) {
+		*digitalPinToPCMSK(portBouton) |= _BV(digitalPinToPCMSKbit(portBouton));
+		*digitalPinToPCICR(portBouton) |= _BV(digitalPinToPCICRbit(portBouton));
+	}
+	else {
+		*digitalPinToPCMSK(portBouton) &= ~_BV(digitalPinToPCMSKbit(portBouton));
+	}
+# endif
+	interrupts();
+}
+
+/**
+ * Donne le temps écoulé depuis le démarrage de la carte.
+ *
+ * @return Le temps en millisecondes, qui repasse à 0 après environ 50 jours.
+ */
+unsigned long materielMillis() {
+	return millis();
+}
+
+/**
+ * Donne le temps écoulé depuis le démarrage de la carte, plus finement que materielMillis().
+ *
+ * @return Le temps en microsecondes, à quatre microsecondes près sur une carte à 16 MHz ; il
+ * 		   repasse à 0 après environ 70 minutes.
+ */
+unsigned long materielMicros() {
+	return micros();
+}
+
+/**
+ * Attend pendant une durée donnée. Les moteurs continuent de tourner pendant ce temps.
+ *
+ * @param ms La durée en millisecondes.
+ */
+void materielDelai(unsigned long ms) {
+	delay(ms);
+}
+
+/**
+ * Appelée à chaque tour des boucles d'attente de la bibliothèque. Sur l'Arduino, il n'y a rien à
+ * faire : c'est l'interruption du Timer2 qui fait avancer les moteurs pendant ce temps.
+ */
+void materielPatienter() {
+}
+
+/**
+ * Ouvre un fichier de la carte SD en lecture, en fermant celui qui l'était. La carte est
+ * initialisée à la première ouverture ; il faut pour cela que TORTUINO_LECTEUR_SD soit défini
+ * dans TortuinoProfils.h. Sinon, la bibliothèque SD n'est pas compilée dans le croquis et aucun
+ * fichier ne peut être ouvert.
+ *
+ * @param  nom Le nom du fichier, au format 8.3 de la carte.
+ * @return     Vrai si le fichier a pu être ouvert.
+ */
+bool materielFichierOuvrir(const char *nom) {
+	materielFichierFermer();
+
+# ifdef TORTUINO_LECTEUR_SD
+	if (portSD < 0) {													// Pas de lecteur, pas de fichier.
+		return false;
+	}
+	if (!carteSDPrete) {
+		carteSDPrete = SD.begin(portSD);
+	}
+	if (carteSDPrete) {
+		fichier = SD.open(nom, FILE_READ);
+	}
+
+	return fichier;
+# else
+	return false;
+# endif
+}
+
+/**
+ * Lit une partie du fichier ouvert par materielFichierOuvrir(). L'interruption des moteurs
+ * continue pendant la lecture.
+ *
+ * @param  position La position en octets du début de la lecture dans le fichier.
+ * @param  tampon   Le tampon où écrire les octets lus.
+ * @param  taille   Le nombre d'octets à lire.
+ * @return          Le nombre d'octets lus, plus petit que taille à la fin du fichier, ou -1
+ * 					en cas d'erreur.
+ */
+int materielFichierLire(unsigned long position, unsigned char *tampon, int taille) {
+# ifdef TORTUINO_LECTEUR_SD
+	if (!fichier || !fichier.seek(position)) {
+		return -1;
+	}
+
+	return fichier.read(tampon, taille);
+# else
+	return -1;
+# endif
+}
+
+/**
+ * Ferme le fichier ouvert par materielFichierOuvrir(), s'il y en a un.
+ */
+void materielFichierFermer() {
+# ifdef TORTUINO_LECTEUR_SD
+	if (fichier) {
+		fichier.close();
+	}
+# endif
+}
+
+/**
+ * Ouvre la liaison série de la carte, celle du câble USB, sur les broches 0 et 1.
+ *
+ * @param debit Le débit de la liaison, en bits par seconde.
+ */
+void materielSerieOuvrir(unsigned long debit) {
+	Serial.begin(debit);
+}
+
+/**
+ * Lit un octet reçu sur la liaison série, sans attendre.
+ *
+ * @return L'octet reçu, ou -1 si aucun n'attend.
+ */
+int materielSerieLire() {
+	return Serial.read();
+}
+
+/**
+ * Envoie un octet sur la liaison série. Elle n'attend que si le tampon d'envoi est plein.
+ *
+ * @param octet L'octet à envoyer.
+ */
+void materielSerieEcrire(unsigned char octet) {
+	Serial.write(octet);
+}
+
+/**
+ * La routine d'interruption du Timer2, qui délègue tout le travail des moteurs à
+ * moteursInterruption(), et relit de temps en temps le bouton s'il est surveillé.
+ */
+ISR(TIMER2_COMPA_vect) {
+	moteursInterruption();
+# ifndef TORTUINO_BOUTON_PCINT
+	if (rappelBouton == NULL || --attenteBouton != 0) {
+		return;
+	}
+	attenteBouton = periodeBouton;
+	bool appuye = (*registreBouton & masqueBouton) == 0;				// La broche est tirée à l'état haut.
+	if (appuye != boutonAppuye) {
+		boutonAppuye = appuye;
+		rappelBouton(appuye);
+	}
+# endif
+}
+
+# ifdef TORTUINO_BOUTON_PCINT
+/**
+ * La routine d'interruption de changement d'état des broches du port D, dont celle du bouton.
+ * Elle n'est compilée que si TORTUINO_BOUTON_PCINT est défini, pour laisser ce vecteur libre.
+ */
+ISR(PCINT2_vect) {
+	if (rappelBouton != NULL) {
+		rappelBouton(materielBoutonAppuye());
+	}
+}
+# endif
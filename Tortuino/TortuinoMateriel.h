@@ -0,0 +1,41 @@
+/**
+ * @file TortuinoMateriel.h
+ * @brief Définition des fonctions que doit implémenter chaque version du matériel.
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête commun à toutes les versions du matériel sur lequel
+ * s'exécute la bibliothèque : TortuinoMateriel.cpp pour l'Arduino du robot, et
+ * MaterielHote.cpp du dossier OutilsTortuino pour un ordinateur. Ici, ce sont des
+ * fonctions et quelques constantes partagées.
+ */
+
+
+# ifndef TORTUINO_MATERIEL_h
+#	define TORTUINO_MATERIEL_h
+
+//#	define TORTUINO_BOUTON_PCINT
+
+	const unsigned int	FREQUENCE_MOTEURS	=	5000;	/**< La fréquence en Hz à laquelle moteursInterruption() doit être appelée. C'est aussi la cadence maximale d'un moteur. */
+
+	const unsigned char	MOTEUR_GAUCHE	=	0;
+	const unsigned char	MOTEUR_DROITE	=	1;
+
+	void materielInitialiser();
+	void materielBobines(unsigned char moteur, unsigned char phase);
+	void materielFeutre(bool leve);
+	bool materielBoutonAppuye();
+	void materielBoutonSurveiller(void (*rappel)(bool appuye));
+	unsigned long materielMillis();
+	unsigned long materielMicros();
+	void materielDelai(unsigned long ms);
+	void materielPatienter();
+
+	bool materielFichierOuvrir(const char *nom);
+	int materielFichierLire(unsigned long position, unsigned char *tampon, int taille);
+	void materielFichierFermer();
+
+	void materielSerieOuvrir(unsigned long debit);
+	int materielSerieLire();
+	void materielSerieEcrire(unsigned char octet);
+
+# endif
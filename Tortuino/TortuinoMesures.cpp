@@ -0,0 +1,192 @@
+# include "TortuinoMesures.h"
+# include "TortuinoLiaison.h"
+
+
+/**
+ * @file TortuinoMesures.cpp
+ * @brief Ce fichier compte ce que fait la bibliothèque, lorsque TORTUINO_MESURES ou TORTUINO_CHRONOS est défini.
+ * @version 1.0
+ *
+ * Le fichier TortuinoMesures.cpp tient quelques compteurs sur l'exécution de la bibliothèque :
+ * le nombre d'appels aux fonctions de base, la profondeur maximale atteinte par les dessins de
+ * TortuinoDessins.cpp ou par la pile de TortuinoLSysteme.cpp et la distance réellement parcourue
+ * feutre levé et feutre baissé, une fois les commandes combinées par TortuinoCommandes.cpp, ainsi
+ * que le nombre de fois où TortuinoLecteur.cpp a dû attendre la lecture d'un bloc et où les
+ * moteurs de TortuinoLiaison.cpp ont manqué de blocs de pas. Un observateur peut aussi y être
+ * placé pour recevoir chaque commande au moment de son exécution. Compteurs et observateur ne
+ * sont compilés que si la macro TORTUINO_MESURES est définie, ce que font les outils du dossier
+ * OutilsTortuino ; sur le robot, les macros de TortuinoMesures.h ne font rien et ne coûtent donc
+ * ni mémoire ni temps.<br/>
+ *
+ * Sur le robot, c'est plutôt le temps qui manque : la macro TORTUINO_CHRONOS, qu'il suffit de
+ * décommenter au début de TortuinoMesures.h, y chronomètre la bibliothèque avec materielMicros().
+ * Le temps est réparti entre cinq phases, dont une seule est en cours à chaque instant : le
+ * programme de l'utilisateur, le calcul des commandes (conversions en pas, vitesses de jonction),
+ * l'attente des pas des moteurs, celle du servomoteur du feutre et celle du bouton. Une attente
+ * bascule dans sa phase en entrant, puis revient à la précédente en sortant, si bien que la somme
+ * des phases est exactement le temps écoulé. Chaque commande exécutée est aussi chronométrée,
+ * attentes comprises, selon son type. Le temps passé dans l'interruption des moteurs est pris à
+ * la phase qu'elle interrompt. Le rapport est envoyé sur la liaison série par rapporter(), ce que
+ * fait aussi stopper(), sous la forme d'une ligne par compteur :
+ *
+ * {@code
+ * 	chronos
+ * 	programme 1 503120
+ * 	calcul 412 61348
+ * 	pas 388 48113976
+ * 	...
+ * 	fin
+ * }
+ *
+ * chacune donnant le nom du compteur, le nombre de fois où il a démarré et le temps cumulé en
+ * microsecondes. Il ne faut pour cela que deux lectures de l'horloge et quelques additions par
+ * attente et par commande, soit une dizaine de microsecondes sur une carte à 16 MHz.
+ *
+ * @see mesuresEffacer()
+ * @see chronosRapport()
+ */
+
+
+
+# ifdef TORTUINO_MESURES
+
+Mesures		mesures	=	{0, 0, 0, 0, 0, 0, NULL};					/**< Les mesures accumulées depuis le dernier appel à mesuresEffacer(), et l'observateur des commandes exécutées. */
+
+
+/**
+ * Remet toutes les mesures à zéro. L'observateur des commandes est conservé.
+ */
+void mesuresEffacer() {
+	mesures.primitives = 0;
+	mesures.profondeurMax = 0;
+	mesures.distanceLevee = 0;
+	mesures.distanceBaissee = 0;
+	mesures.lecturesBloquantes = 0;
+	mesures.famines = 0;
+}
+
+# endif
+
+# ifdef TORTUINO_CHRONOS
+
+const char	*nomsPhases[NB_PHASES_CHRONOS]			=	{"programme", "calcul", "pas", "feutre", "bouton"};	/**< Les noms des phases dans le rapport, dans l'ordre de CHRONO_PROGRAMME à CHRONO_BOUTON. */
+const char	*nomsPrimitives[NB_PRIMITIVES_CHRONOS]	=	{"avancer", "tournerGauche", "monterFeutre", "descendreFeutre", "arcGauche"};	/**< Les noms des commandes dans le rapport, dans l'ordre des types de TortuinoCommandes.h. */
+
+Chronos		chronos;									/**< Les temps accumulés depuis le dernier appel à chronosEffacer(), et la phase en cours. */
+bool		serieChronos	=	false;					/**< Vrai une fois la liaison série ouverte pour le rapport. */
+
+
+/**
+ * Passe à une autre phase, en ajoutant à celle qui se termine le temps écoulé depuis son début.
+ * Elle est appelée par les macros CHRONO_PHASE et CHRONO_REPRENDRE.
+ *
+ * @param  phase   La phase qui commence.
+ * @param  compter Vrai si c'est une nouvelle entrée dans cette phase, faux si l'on y revient
+ * 				   après une phase imbriquée.
+ * @return         La phase qui se termine, à reprendre ensuite.
+ */
+unsigned char chronosBasculer(unsigned char phase, bool compter) {
+	unsigned long maintenant = materielMicros();
+	unsigned char precedente = chronos.phase;
+
+	chronos.phases[precedente].micros += maintenant - chronos.debutPhase;	// Différence correcte même quand l'horloge repasse à 0.
+	chronos.phases[phase].nb += compter ? 1 : 0;
+	chronos.phase = phase;
+	chronos.debutPhase = maintenant;
+	return precedente;
+}
+
+/**
+ * Ajoute au compteur d'un type de commande une exécution qui vient de se terminer.
+ *
+ * @param type  Le type de la commande, selon TortuinoCommandes.h.
+ * @param debut L'instant en microsecondes où son exécution a commencé.
+ */
+void chronosPrimitive(unsigned char type, unsigned long debut) {
+	chronos.primitives[type].nb++;
+	chronos.primitives[type].micros += materielMicros() - debut;
+}
+
+/**
+ * Remet tous les chronomètres à zéro, et repart de la phase du programme.
+ */
+void chronosEffacer() {
+	for (int i = 0; i < NB_PHASES_CHRONOS; i++) {
+		chronos.phases[i].nb = 0;
+		chronos.phases[i].micros = 0;
+	}
+	for (int i = 0; i < NB_PRIMITIVES_CHRONOS; i++) {
+		chronos.primitives[i].nb = 0;
+		chronos.primitives[i].micros = 0;
+	}
+	chronos.phases[CHRONO_PROGRAMME].nb = 1;
+	chronos.phase = CHRONO_PROGRAMME;
+	chronos.debutPhase = materielMicros();
+}
+
+/**
+ * Envoie un texte sur la liaison série, caractère par caractère.
+ *
+ * @param texte Le texte terminé par un caractère nul.
+ */
+void ecrireTexte(const char *texte) {
+	while (*texte != 0) {
+		materielSerieEcrire(*texte++);
+	}
+}
+
+/**
+ * Envoie un nombre en décimal sur la liaison série, sans passer par `printf()`.
+ *
+ * @param nombre Le nombre à écrire.
+ */
+void ecrireNombre(unsigned long long nombre) {
+	char chiffres[21];
+	int i = sizeof(chiffres) - 1;
+	chiffres[i] = 0;
+	do {																// Les chiffres sont obtenus du dernier au premier.
+		chiffres[--i] = '0' + nombre % 10;
+		nombre /= 10;
+	} while (nombre != 0);
+
+	ecrireTexte(chiffres + i);
+}
+
+/**
+ * Envoie la ligne d'un compteur sur la liaison série.
+ *
+ * @param nom    Le nom du compteur.
+ * @param chrono Son nombre de démarrages et son temps cumulé.
+ */
+void ecrireChrono(const char *nom, const Chrono &chrono) {
+	ecrireTexte(nom);
+	materielSerieEcrire(' ');
+	ecrireNombre(chrono.nb);
+	materielSerieEcrire(' ');
+	ecrireNombre(chrono.micros);
+	materielSerieEcrire('\n');
+}
+
+/**
+ * Envoie le rapport des chronomètres sur la liaison série, ouverte au débit DEBIT_LIAISON si elle
+ * ne l'était pas. La phase en cours est d'abord arrêtée à l'instant présent, sans être
+ * interrompue ; le temps d'envoi du rapport lui sera compté.
+ */
+void chronosRapport() {
+	chronosBasculer(chronos.phase, false);
+	if (!serieChronos) {
+		materielSerieOuvrir(DEBIT_LIAISON);
+		serieChronos = true;
+	}
+
+	ecrireTexte("chronos\n");
+	for (int i = 0; i < NB_PHASES_CHRONOS; i++) {
+		ecrireChrono(nomsPhases[i], chronos.phases[i]);
+	}
+	for (int i = 0; i < NB_PRIMITIVES_CHRONOS; i++) {
+		ecrireChrono(nomsPrimitives[i], chronos.primitives[i]);
+	}
+	ecrireTexte("fin\n");
+}
+
+# endif
@@ -0,0 +1,97 @@
+/**
+ * @file TortuinoMesures.h
+ * @brief Définition des mesures implémentées dans TortuinoMesures.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoMesures.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des macros qui ne
+ * font rien si TORTUINO_MESURES ou TORTUINO_CHRONOS n'est pas défini, ainsi que des
+ * fonctions et le type des mesures lorsqu'il l'est.
+ */
+
+
+# ifndef TORTUINO_MESURES_h
+#	define TORTUINO_MESURES_h
+
+//#	define TORTUINO_CHRONOS
+
+#	ifdef TORTUINO_MESURES
+#		include <stddef.h>
+#		include "TortuinoCommandes.h"
+
+		struct Mesures {
+			unsigned long primitives;
+			int profondeurMax;
+			double distanceLevee;
+			double distanceBaissee;
+			unsigned long lecturesBloquantes;
+			unsigned long famines;
+			void (*observateur)(const Commande &commande);
+		};
+
+		extern Mesures mesures;
+
+		void mesuresEffacer();
+
+#		define MESURE_PRIMITIVE()		(mesures.primitives++)
+#		define MESURE_PROFONDEUR(p)		((p) > mesures.profondeurMax ? (void)(mesures.profondeurMax = (p)) : (void)0)
+#		define MESURE_DEPLACEMENT(d, leve)	((leve) ? (void)(mesures.distanceLevee += fabs(d)) : (void)(mesures.distanceBaissee += fabs(d)))
+#		define MESURE_COMMANDE(c)		(mesures.observateur != NULL ? mesures.observateur(c) : (void)0)
+#		define MESURE_LECTURE_BLOQUANTE()	(mesures.lecturesBloquantes++)
+#		define MESURE_FAMINE()			(mesures.famines++)
+#	else
+#		define MESURE_PRIMITIVE()		((void)0)
+#		define MESURE_PROFONDEUR(p)		((void)0)
+#		define MESURE_DEPLACEMENT(d, leve)	((void)0)
+#		define MESURE_COMMANDE(c)		((void)0)
+#		define MESURE_LECTURE_BLOQUANTE()	((void)0)
+#		define MESURE_FAMINE()			((void)0)
+#	endif
+
+#	ifdef TORTUINO_CHRONOS
+#		include "TortuinoMateriel.h"
+
+		const unsigned char	CHRONO_PROGRAMME	=	0;
+		const unsigned char	CHRONO_CALCUL		=	1;
+		const unsigned char	CHRONO_PAS			=	2;
+		const unsigned char	CHRONO_FEUTRE		=	3;
+		const unsigned char	CHRONO_BOUTON		=	4;
+
+		const unsigned char	NB_PHASES_CHRONOS		=	5;
+		const unsigned char	NB_PRIMITIVES_CHRONOS	=	5;
+
+		struct Chrono {
+			unsigned long nb;
+			unsigned long long micros;
+		};
+
+		struct Chronos {
+			Chrono phases[NB_PHASES_CHRONOS];
+			Chrono primitives[NB_PRIMITIVES_CHRONOS];
+			unsigned char phase;
+			unsigned long debutPhase;
+		};
+
+		extern Chronos chronos;
+
+		unsigned char chronosBasculer(unsigned char phase, bool compter);
+		void chronosPrimitive(unsigned char type, unsigned long debut);
+		void chronosEffacer();
+		void chronosRapport();
+
+#		define CHRONO_PHASE(p, precedente)		unsigned char precedente = chronosBasculer(p, true)
+#		define CHRONO_REPRENDRE(precedente)		((void)chronosBasculer(precedente, false))
+#		define CHRONO_DEBUT(debut)				unsigned long debut = materielMicros()
+#		define CHRONO_PRIMITIVE(type, debut)	chronosPrimitive(type, debut)
+#		define CHRONO_EFFACER()					chronosEffacer()
+#		define CHRONO_RAPPORT()					chronosRapport()
+#	else
+#		define CHRONO_PHASE(p, precedente)		((void)0)
+#		define CHRONO_REPRENDRE(precedente)		((void)0)
+#		define CHRONO_DEBUT(debut)				((void)0)
+#		define CHRONO_PRIMITIVE(type, debut)	((void)0)
+#		define CHRONO_EFFACER()					((void)0)
+#		define CHRONO_RAPPORT()					((void)0)
+#	endif
+
+# endif
@@ -0,0 +1,567 @@
+# include <stdint.h>
+# include <stdlib.h>
+# include <math.h>
+# include "TortuinoMoteurs.h"
+# include "TortuinoMateriel.h"
+# include "TortuinoProfils.h"
+# include "TortuinoMesures.h"
+
+
+/**
+ * @file TortuinoMoteurs.cpp
+ * @brief Ce fichier implémente le moteur de mouvement qui fait tourner les deux roues en même temps.
+ * @version 1.0
+ *
+ * Le fichier TortuinoMoteurs.cpp remplace les appels bloquants à `Stepper::step()` qui faisaient
+ * tourner les deux moteurs pas à pas l'un après l'autre. Les pas sont ici générés par une
+ * interruption périodique du Timer2 de l'Arduino, programmée par TortuinoMateriel.cpp, qui appelle
+ * moteursInterruption() : à chaque interruption, un accumulateur de phase décide si la roue qui
+ * a le plus de pas à faire doit avancer d'un pas, et l'autre roue la suit en proportion grâce à
+ * l'algorithme de Bresenham. Les deux roues tournent ainsi ensemble et à la bonne cadence, même
+ * lorsqu'elles n'ont pas le même nombre de pas à faire. Les bobines sont alimentées par
+ * materielBobines(), ce qui permet aussi d'exécuter ce code sur un ordinateur.<br/>
+ *
+ * Les déplacements à réaliser sont appelés des segments : ce sont des couples de nombres de pas,
+ * un pour chaque roue, placés dans une petite file circulaire. Le programme principal ajoute les
+ * segments avec moteursAjouter() pendant que l'interruption les consomme, ce qui permet au segment
+ * suivant de démarrer sans temps mort. Les fonctions bloquantes de Tortuino.cpp se contentent
+ * d'ajouter leur segment puis d'attendre sa fin avec moteursAttendre().<br/>
+ *
+ * Chaque segment suit un profil de vitesse trapézoïdal : il démarre à une vitesse suffisamment
+ * basse pour que les moteurs ne décrochent pas, accélère jusqu'à sa vitesse maximale, puis
+ * décélère à temps pour s'arrêter à nouveau à la vitesse de démarrage sur son dernier pas. Le
+ * nombre de pas passés à accélérer est compté : dès qu'il ne reste plus que ce nombre de pas à
+ * faire, la décélération commence, ce qui la rend symétrique de l'accélération sans aucun calcul
+ * coûteux dans l'interruption. Deux profils sont disponibles, un pour le tracé et un pour les
+ * déplacements feutre levé, choisis par le programme principal segment par segment. Un segment
+ * peut aussi avoir une cadence fixe, sans rampe, quand sa vitesse a déjà été planifiée ailleurs :
+ * c'est le cas des blocs de pas reçus par TortuinoLiaison.cpp.<br/>
+ *
+ * Enfin, un segment peut être enchaîné avec le suivant : il démarre alors directement à la vitesse
+ * à laquelle le précédent s'est terminé, et ne décélère que jusqu'à sa propre vitesse de sortie.
+ * Son compteur de rampe part du nombre de pas qu'il aurait fallu pour accélérer de la vitesse de
+ * démarrage à sa vitesse d'entrée, moins celui qu'il faudra pour freiner jusqu'à sa vitesse de
+ * sortie : l'interruption n'a ainsi rien de plus à calculer. C'est au programme principal de
+ * choisir des vitesses que les segments ont la place d'atteindre, ce que fait
+ * moteursAjouterEnchaine(). Le programme principal ne peut toutefois pas savoir à coup sûr si le
+ * segment précédent sera encore en cours quand le sien arrivera : c'est donc l'interruption qui en
+ * décide en le sortant de la file. Si les moteurs se sont arrêtés entre-temps, faute de segment,
+ * le segment enchaîné et ceux qui le suivent dans la chaîne démarrent et s'arrêtent à la vitesse
+ * de démarrage, jusqu'au premier segment qui démarre lui-même de l'arrêt.<br/>
+ *
+ * Les moteurs peuvent enfin être suspendus au milieu d'un segment, puis repartir de la vitesse de
+ * démarrage, ou abandonner tous leurs segments : ces deux demandes ne font que lever un drapeau lu
+ * par l'interruption, et peuvent donc venir d'une autre interruption, comme celle du bouton. Après
+ * une pause, le segment interrompu s'arrête à la vitesse de démarrage, et la chaîne qui le suit
+ * est traitée comme après un arrêt faute de segment. Lors d'un abandon, les pas qui ne seront pas
+ * faits sont comptés, pour que TortuinoOdometrie.cpp puisse les retirer de la pose du robot.<br/>
+ *
+ * Notez que le Timer2 est aussi celui qu'utilise la fonction `tone()` de l'Arduino : les deux ne
+ * peuvent donc pas être utilisés ensemble. Le Timer1 est quant à lui laissé à la bibliothèque Servo.
+ *
+ * @see moteursAjouter(long pasGauche, long pasDroite, unsigned char profil)
+ * @see moteursProfil(unsigned char profil, float vitesseDepart, float vitesseMax, float acceleration)
+ * @see moteursInterruption()
+ */
+
+
+
+const unsigned int	frequenceMoteurs	=	FREQUENCE_MOTEURS;	/**< La fréquence en Hz de l'interruption qui génère les pas : 5000. C'est aussi la cadence maximale d'un moteur. */
+const int			tailleFileMoteurs	=	4;		/**< Le nombre de segments pouvant attendre leur tour dans la file circulaire. */
+const int			nbProfils			=	2;		/**< Le nombre de profils de vitesse : PROFIL_TRACE et PROFIL_DEPLACEMENT. */
+
+/**
+ * Un segment de mouvement : le nombre de pas signé que chacune des deux roues doit faire.
+ * Le signe suit la convention de la bibliothèque Stepper : positif pour incrémenter la phase.
+ */
+struct Segment {
+	long pasGauche;														/**< Le nombre de pas signé de la roue gauche. */
+	long pasDroite;														/**< Le nombre de pas signé de la roue droite. */
+	unsigned char profil;												/**< Le profil de vitesse à suivre : PROFIL_TRACE ou PROFIL_DEPLACEMENT. */
+	uint32_t cadence;													/**< La vitesse constante du segment, sans rampe, ou 0 pour suivre son profil. */
+	uint32_t vitesseEntree;												/**< La vitesse à laquelle le segment démarre, ou 0 pour la vitesse de démarrage du profil. */
+	uint32_t vitesseSortie;												/**< La vitesse à laquelle le segment se termine, ou 0 pour la vitesse de démarrage du profil. */
+	long rampeInitiale;													/**< La valeur de départ du compteur de rampe, qui tient compte de ces deux vitesses. */
+};
+
+/**
+ * Un profil de vitesse trapézoïdal. Toutes les vitesses sont exprimées en fractions de pas
+ * par interruption sur 32 bits, directement utilisables par l'accumulateur de phase.
+ */
+struct Profil {
+	uint32_t vitesseDepart;												/**< La vitesse de démarrage et d'arrêt, sans risque de décrochage. */
+	uint32_t vitesseMax;												/**< La vitesse atteinte en fin d'accélération. */
+	uint32_t acceleration;												/**< La vitesse ajoutée ou retirée à chaque interruption pendant les rampes. */
+};
+
+Segment				fileMoteurs[tailleFileMoteurs];	/**< La file circulaire des segments en attente. */
+volatile uint8_t	teteFile	=	0,			/**< L'indice du prochain segment que l'interruption va démarrer. */
+					finFile		=	0;			/**< L'indice de la prochaine case libre de la file. */
+volatile bool		segmentActif	=	false;		/**< Vrai tant qu'un segment est en cours d'exécution par l'interruption. */
+volatile bool		suspendus		=	false;		/**< Vrai tant que les moteurs sont suspendus par moteursSuspendre(). */
+volatile bool		abandon			=	false;		/**< Vrai tant que l'interruption doit abandonner tous les segments, selon moteursAbandonner(). */
+volatile long		pasAbandonnesGauche	=	0,	/**< Le nombre de pas signé que la roue gauche n'a pas faits depuis le début de l'abandon, hors segments à cadence fixe. */
+					pasAbandonnesDroite	=	0;	/**< Le nombre de pas signé que la roue droite n'a pas faits depuis le début de l'abandon, hors segments à cadence fixe. */
+bool				desenchaines	=	false;		/**< Vrai si les moteurs se sont arrêtés depuis le dernier segment démarré de l'arrêt : les segments enchaînés ne peuvent plus partir de leur vitesse d'entrée. */
+Profil				profils[nbProfils];				/**< Les profils de vitesse, réglés par moteursProfil(). */
+Profil				profilCadence;					/**< Le profil sans rampe du segment en cours, s'il a une cadence. */
+
+long				pasRestants,					/**< Le nombre de pas restant à faire sur la roue qui en a le plus. */
+					pasTotal,						/**< Le nombre total de pas de la roue qui en a le plus pour le segment en cours. */
+					pasRampe,						/**< Le nombre de pas faits pendant l'accélération, et donc à garder pour la décélération. */
+					pasAbsGauche,					/**< La valeur absolue du nombre de pas de la roue gauche du segment en cours. */
+					pasAbsDroite,					/**< La valeur absolue du nombre de pas de la roue droite du segment en cours. */
+					erreurGauche,					/**< L'erreur de Bresenham accumulée par la roue gauche. */
+					erreurDroite;					/**< L'erreur de Bresenham accumulée par la roue droite. */
+signed char			sensGauche,						/**< Le sens de rotation de la roue gauche pour le segment en cours : 1 ou -1. */
+					sensDroite;						/**< Le sens de rotation de la roue droite pour le segment en cours : 1 ou -1. */
+uint8_t				phaseGauche	=	0,				/**< La phase actuelle du moteur de gauche, de 0 à PHASES_BOBINES - 1. */
+					phaseDroite	=	0;				/**< La phase actuelle du moteur de droite, de 0 à PHASES_BOBINES - 1. */
+uint32_t			accumulateur,					/**< L'accumulateur de phase : un pas est fait à chacun de ses débordements. */
+					vitesseCourante,				/**< La vitesse actuelle, ajoutée à l'accumulateur à chaque interruption. */
+					vitesseArret;					/**< La vitesse à laquelle le segment en cours doit finir de décélérer. */
+const Profil		*profilSegment;					/**< Le profil de vitesse du segment en cours. */
+TacheAttente		tacheAttente	=	0;		/**< La tâche de fond à faire pendant les attentes, ou 0 s'il n'y en a pas. */
+
+
+/**
+ * Convertit une cadence en pas par seconde en une fraction de pas par interruption sur 32 bits,
+ * bornée à un peu moins d'un pas par interruption.
+ *
+ * @param  pasParSeconde La cadence en pas par seconde.
+ * @return               La fraction de pas par interruption correspondante.
+ */
+uint32_t pasParInterruption(float pasParSeconde) {
+	if (pasParSeconde >= frequenceMoteurs - 1) {						// On ne peut pas faire plus d'un pas par interruption.
+		pasParSeconde = frequenceMoteurs - 1;
+	}
+
+	return (uint32_t)(pasParSeconde / frequenceMoteurs * 4294967296.0);
+}
+
+/**
+ * Règle un des profils de vitesse utilisés par les segments ajoutés par la suite. Les vitesses
+ * concernent la roue qui a le plus de pas à faire ; elles ne peuvent dépasser frequenceMoteurs.
+ *
+ * @param profil        Le profil à régler : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @param vitesseDepart La vitesse en pas par seconde à laquelle le moteur démarre et s'arrête.
+ * @param vitesseMax    La vitesse maximale en pas par seconde.
+ * @param acceleration  L'accélération et la décélération en pas par seconde au carré.
+ */
+void moteursProfil(unsigned char profil, float vitesseDepart, float vitesseMax, float acceleration) {
+	Profil nouveau;
+	nouveau.vitesseDepart = pasParInterruption(vitesseDepart);
+	nouveau.vitesseMax = pasParInterruption(vitesseMax);
+	nouveau.acceleration = pasParInterruption(acceleration / frequenceMoteurs);	// Gain de vitesse par interruption.
+
+	if (nouveau.vitesseMax < nouveau.vitesseDepart) {					// Un profil ne peut pas démarrer plus vite que son maximum.
+		nouveau.vitesseDepart = nouveau.vitesseMax;
+	}
+	if (nouveau.acceleration == 0) {									// Et il faut bien finir par accélérer.
+		nouveau.acceleration = 1;
+	}
+
+	moteursAttendre();													// On ne change pas un profil en cours d'utilisation.
+	profils[profil] = nouveau;
+}
+
+/**
+ * Empêche le compilateur de déplacer les lectures et écritures de la mémoire d'un côté à l'autre
+ * de son appel. La file n'est pas volatile : sans cette barrière, les champs d'une case pourraient
+ * être écrits après le finFile qui la publie, ou lus après le teteFile qui la libère.
+ */
+inline void barriereMemoire() {
+	__asm__ __volatile__ ("" ::: "memory");
+}
+
+/**
+ * Place un segment dans la file des mouvements à réaliser, en attendant qu'une place se libère
+ * si elle est pleine.
+ *
+ * @param pasGauche Le nombre de pas signé que doit faire la roue gauche.
+ * @param pasDroite Le nombre de pas signé que doit faire la roue droite.
+ * @param profil    Le profil de vitesse à suivre : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @param cadence   La vitesse constante du segment, ou 0 pour suivre le profil.
+ * @param entree    La vitesse d'entrée du segment, ou 0 pour démarrer à celle du profil.
+ * @param sortie    La vitesse de sortie du segment, ou 0 pour s'arrêter à celle du profil.
+ * @param rampe     La valeur de départ du compteur de rampe.
+ */
+void ajouterSegment(long pasGauche, long pasDroite, unsigned char profil, uint32_t cadence, uint32_t entree = 0, uint32_t sortie = 0, long rampe = 0) {
+	if (pasGauche == 0 && pasDroite == 0) {								// Un segment vide n'a rien à faire.
+		return;
+	}
+
+	uint8_t suivant = (finFile + 1) % tailleFileMoteurs;
+	if (suivant == teteFile) {											// On attend une place libre dans la file.
+		CHRONO_PHASE(CHRONO_PAS, phasePrecedente);
+		while (suivant == teteFile) {
+			moteursPatienter();
+		}
+		CHRONO_REPRENDRE(phasePrecedente);
+	}
+
+	fileMoteurs[finFile].pasGauche = pasGauche;							// On remplit la case,
+	fileMoteurs[finFile].pasDroite = pasDroite;
+	fileMoteurs[finFile].profil = profil;
+	fileMoteurs[finFile].cadence = cadence;
+	fileMoteurs[finFile].vitesseEntree = entree;
+	fileMoteurs[finFile].vitesseSortie = sortie;
+	fileMoteurs[finFile].rampeInitiale = rampe;
+	barriereMemoire();
+	finFile = suivant;													// et seulement ensuite on la rend visible à l'interruption.
+}
+
+/**
+ * Ajoute un segment à la file des mouvements à réaliser. Si la file est pleine, la fonction
+ * attend qu'une place se libère. Le segment démarre dès que ceux qui le précèdent sont finis.
+ *
+ * @param pasGauche Le nombre de pas signé que doit faire la roue gauche.
+ * @param pasDroite Le nombre de pas signé que doit faire la roue droite.
+ * @param profil    Le profil de vitesse à suivre : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @see moteursAttendre()
+ */
+void moteursAjouter(long pasGauche, long pasDroite, unsigned char profil) {
+	ajouterSegment(pasGauche, pasDroite, profil, 0);
+}
+
+/**
+ * Calcule le nombre de pas qu'il faut pour accélérer de la vitesse de démarrage d'un profil à une
+ * vitesse donnée, à l'accélération du profil.
+ *
+ * @param  limites La vitesse de démarrage, la vitesse maximale et l'accélération du profil, comme
+ * 				   les donne moteursLimites().
+ * @param  vitesse La vitesse à atteindre, en pas par seconde.
+ * @return         Le nombre de pas de la rampe.
+ */
+long pasPourAtteindre(const float *limites, float vitesse) {
+	return vitesse > limites[0] ? (long)((vitesse * vitesse - limites[0] * limites[0]) / (2 * limites[2])) : 0;
+}
+
+/**
+ * Ajoute à la file un segment enchaîné avec ses voisins : il démarre à la vitesse à laquelle le
+ * segment précédent s'est terminé et se termine à celle à laquelle le suivant démarrera, sans
+ * repasser par la vitesse de démarrage. La vitesse de sortie est ramenée à ce que le segment a la
+ * place d'atteindre depuis sa vitesse d'entrée ; c'est à l'appelant de s'assurer que le segment
+ * suivant aura lui aussi la place de freiner.
+ *
+ * @param pasGauche     Le nombre de pas signé que doit faire la roue gauche.
+ * @param pasDroite     Le nombre de pas signé que doit faire la roue droite.
+ * @param profil        Le profil de vitesse à suivre : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @param vitesseEntree La vitesse en pas par seconde de la roue qui a le plus de pas au début du
+ * 						segment, ou 0 pour démarrer à la vitesse de démarrage du profil.
+ * @param vitesseSortie La vitesse en pas par seconde de cette roue à la fin du segment, ou 0 pour
+ * 						s'arrêter à la vitesse de démarrage du profil.
+ * @see moteursLimites(unsigned char profil, float *limites)
+ */
+void moteursAjouterEnchaine(long pasGauche, long pasDroite, unsigned char profil, float vitesseEntree, float vitesseSortie) {
+	float limites[3];
+	moteursLimites(profil, limites);
+
+	long pasTotal = labs(pasGauche) > labs(pasDroite) ? labs(pasGauche) : labs(pasDroite);
+	long entree = pasPourAtteindre(limites, vitesseEntree);
+	long sortie = pasPourAtteindre(limites, vitesseSortie);
+	if (sortie > entree + pasTotal) {									// Le segment est trop court pour atteindre cette vitesse.
+		sortie = entree + pasTotal;
+		vitesseSortie = sqrt(limites[0] * limites[0] + 2 * limites[2] * sortie);
+	}
+
+	ajouterSegment(pasGauche, pasDroite, profil, 0,
+		vitesseEntree > limites[0] ? pasParInterruption(vitesseEntree) : 0,
+		vitesseSortie > limites[0] ? pasParInterruption(vitesseSortie) : 0, entree - sortie);
+}
+
+/**
+ * Donne les réglages d'un profil de vitesse, pour que le programme principal puisse planifier
+ * les vitesses des segments enchaînés.
+ *
+ * @param profil  Le profil : PROFIL_TRACE ou PROFIL_DEPLACEMENT.
+ * @param limites Reçoit la vitesse de démarrage et la vitesse maximale en pas par seconde, puis
+ * 				  l'accélération en pas par seconde au carré.
+ */
+void moteursLimites(unsigned char profil, float *limites) {
+	limites[0] = profils[profil].vitesseDepart / 4294967296.0 * frequenceMoteurs;
+	limites[1] = profils[profil].vitesseMax / 4294967296.0 * frequenceMoteurs;
+	limites[2] = profils[profil].acceleration / 4294967296.0 * frequenceMoteurs * frequenceMoteurs;
+}
+
+/**
+ * Ajoute à la file un segment parcouru à vitesse constante, sans rampe d'accélération ni de
+ * décélération. C'est à celui qui l'a calculé de s'assurer que les moteurs peuvent démarrer
+ * directement à cette vitesse, comme le fait l'ordinateur qui envoie les blocs de pas de
+ * TortuinoLiaison.cpp.
+ *
+ * @param pasGauche     Le nombre de pas signé que doit faire la roue gauche.
+ * @param pasDroite     Le nombre de pas signé que doit faire la roue droite.
+ * @param pasParSeconde La cadence de la roue qui a le plus de pas à faire.
+ * @see moteursAjouter(long pasGauche, long pasDroite, unsigned char profil)
+ */
+void moteursAjouterCadence(long pasGauche, long pasDroite, float pasParSeconde) {
+	uint32_t cadence = pasParInterruption(pasParSeconde);
+	ajouterSegment(pasGauche, pasDroite, PROFIL_TRACE, cadence > 0 ? cadence : 1);
+}
+
+/**
+ * Indique si la file des segments a une place libre, c'est-à-dire si moteursAjouter() peut
+ * rendre la main sans attendre.
+ *
+ * @return Vrai si un segment peut être ajouté immédiatement.
+ */
+bool moteursPlaceLibre() {
+	return (finFile + 1) % tailleFileMoteurs != teteFile;
+}
+
+/**
+ * Indique si les moteurs ont encore des pas à faire.
+ *
+ * @return Vrai si un segment est en cours ou en attente.
+ */
+bool moteursOccupes() {
+	return teteFile != finFile || segmentActif;							// Dans cet ordre, pour ne pas rater un segment qui démarre entre les deux lectures.
+}
+
+/**
+ * Bloque jusqu'à ce que tous les segments ajoutés aient été réalisés.
+ */
+void moteursAttendre() {
+	if (!moteursOccupes()) {
+		return;
+	}
+
+	CHRONO_PHASE(CHRONO_PAS, phasePrecedente);
+	while (moteursOccupes()) {
+		moteursPatienter();
+	}
+	CHRONO_REPRENDRE(phasePrecedente);
+}
+
+/**
+ * Choisit une tâche de fond à faire pendant que la bibliothèque attend les moteurs ou le feutre.
+ * Elle est appelée à chaque tour des boucles d'attente, pendant que l'interruption continue de
+ * générer les pas : elle doit donc être courte, et ne jamais ajouter de segment elle-même.
+ * Celle qui était en place est renvoyée, pour que la nouvelle puisse l'appeler à son tour et
+ * qu'elle soit remise en place ensuite.
+ *
+ * @param  tache La tâche de fond, ou 0 pour ne plus en avoir.
+ * @return       La tâche de fond précédente, ou 0 s'il n'y en avait pas.
+ * @see moteursPatienter()
+ */
+TacheAttente moteursTacheAttente(TacheAttente tache) {
+	TacheAttente precedente = tacheAttente;
+	tacheAttente = tache;
+	return precedente;
+}
+
+/**
+ * Fait un tour de boucle d'attente : la tâche de fond s'il y en a une, puis materielPatienter().
+ */
+void moteursPatienter() {
+	if (tacheAttente != 0) {
+		tacheAttente();
+	}
+
+	materielPatienter();
+}
+
+/**
+ * Suspend les moteurs au milieu de leur segment, ou les fait repartir. Ils s'arrêtent net, ce que
+ * les moteurs pas à pas supportent à ces vitesses, et repartent de la vitesse de démarrage de leur
+ * profil en accélérant à nouveau. Rien ne garantit plus alors qu'ils atteindront la vitesse de
+ * sortie prévue : le segment s'arrête donc à la vitesse de démarrage, et les segments enchaînés
+ * qui le suivent ne partent pas de leur vitesse d'entrée. Elle peut être appelée depuis une
+ * interruption.
+ *
+ * @param suspendre Vrai pour suspendre les moteurs, faux pour les faire repartir.
+ */
+void moteursSuspendre(bool suspendre) {
+	if (!suspendre && suspendus) {										// L'interruption ne touche à rien tant qu'ils sont suspendus.
+		desenchaines = true;											// La chaîne repart de l'arrêt,
+		if (segmentActif) {												// comme le segment interrompu.
+			vitesseCourante = profilSegment->vitesseDepart;
+			vitesseArret = profilSegment->vitesseDepart;
+			pasRampe = 0;
+		}
+	}
+	barriereMemoire();
+	suspendus = suspendre;
+}
+
+/**
+ * Fait abandonner aux moteurs le segment en cours et tous ceux de la file, ainsi que ceux qui y
+ * seront ajoutés tant que l'abandon dure. Les pas abandonnés ne sont jamais faits, mais sont
+ * comptés par moteursPasAbandonnes(). Elle peut être appelée depuis une interruption pour
+ * commencer l'abandon, mais pas pour le terminer.
+ *
+ * @param abandonner Vrai pour commencer l'abandon, faux pour le terminer.
+ */
+void moteursAbandonner(bool abandonner) {
+	if (abandonner && !abandon) {										// Un nouvel abandon compte ses pas depuis zéro.
+		pasAbandonnesGauche = 0;
+		pasAbandonnesDroite = 0;
+	}
+	if (!abandonner && abandon) {										// L'interruption vide la file à son prochain passage :
+		moteursAttendre();												// on la laisse compter ce qu'elle y trouve.
+	}
+	abandon = abandonner;
+}
+
+/**
+ * Donne les pas que les moteurs n'ont pas faits depuis le début du dernier abandon : le reste du
+ * segment interrompu et la totalité des suivants. Les segments à cadence fixe, que la pose du
+ * robot ne suit pas, n'y sont pas comptés.
+ *
+ * @param pasGauche Reçoit le nombre de pas signé abandonnés par la roue gauche.
+ * @param pasDroite Reçoit le nombre de pas signé abandonnés par la roue droite.
+ * @see moteursAbandonner(bool abandonner)
+ */
+void moteursPasAbandonnes(long &pasGauche, long &pasDroite) {
+	pasGauche = pasAbandonnesGauche;
+	pasDroite = pasAbandonnesDroite;
+}
+
+/**
+ * Donne le nombre de pas qu'une roue n'a pas encore faits dans le segment en cours. L'erreur de
+ * Bresenham partant de la moitié de pasTotal, la roue en a fait l'arrondi de sa part des pas de
+ * la roue qui donne le rythme.
+ *
+ * @param  pasAbs La valeur absolue du nombre de pas de la roue pour ce segment.
+ * @return        Le nombre de pas qui lui restent à faire.
+ */
+long pasRestantsRoue(long pasAbs) {
+	return pasAbs - (long)(((int64_t)(pasTotal - pasRestants) * pasAbs + pasTotal / 2) / pasTotal);
+}
+
+/**
+ * Abandonne le segment en cours et tous ceux de la file, en comptant les pas qui ne seront pas
+ * faits. Elle n'est appelée que par l'interruption.
+ */
+void abandonnerSegments() {
+	if (segmentActif && profilSegment != &profilCadence) {				// Une seule division, une fois par abandon.
+		pasAbandonnesGauche += sensGauche * pasRestantsRoue(pasAbsGauche);
+		pasAbandonnesDroite += sensDroite * pasRestantsRoue(pasAbsDroite);
+	}
+	segmentActif = false;
+
+	while (teteFile != finFile) {
+		barriereMemoire();												// La case n'est lue qu'après finFile.
+		const Segment &segment = fileMoteurs[teteFile];
+		if (segment.cadence == 0) {
+			pasAbandonnesGauche += segment.pasGauche;
+			pasAbandonnesDroite += segment.pasDroite;
+		}
+		teteFile = (teteFile + 1) % tailleFileMoteurs;
+	}
+}
+
+/**
+ * Démarre le segment en tête de file : prépare les compteurs de Bresenham et les sens.
+ */
+void demarrerSegment() {
+	barriereMemoire();													// La case n'est lue qu'après finFile.
+	const Segment &segment = fileMoteurs[teteFile];
+
+	sensGauche = segment.pasGauche < 0 ? -1 : 1;
+	sensDroite = segment.pasDroite < 0 ? -1 : 1;
+	pasAbsGauche = labs(segment.pasGauche);
+	pasAbsDroite = labs(segment.pasDroite);
+	pasTotal = pasAbsGauche > pasAbsDroite ? pasAbsGauche : pasAbsDroite;	// La roue qui a le plus de pas donne le rythme.
+	pasRestants = pasTotal;
+	erreurGauche = pasTotal / 2;										// On centre l'erreur pour répartir les pas de l'autre roue.
+	erreurDroite = pasTotal / 2;
+	if (segment.cadence != 0) {											// Un segment à cadence fixe n'a pas de rampe :
+		profilCadence.vitesseDepart = segment.cadence;					// il démarre, roule et s'arrête à la même vitesse.
+		profilCadence.vitesseMax = segment.cadence;
+		profilCadence.acceleration = 1;
+		profilSegment = &profilCadence;
+	}
+	else {
+		profilSegment = &profils[segment.profil];
+	}
+	if (segment.vitesseEntree == 0) {									// Un segment qui démarre de l'arrêt
+		desenchaines = false;											// peut de nouveau être rejoint par le suivant.
+	}
+	if (desenchaines) {													// Le précédent ne l'a pas mené à sa vitesse d'entrée :
+		vitesseCourante = profilSegment->vitesseDepart;					// il démarre et s'arrête lentement, sans rampe d'avance.
+		vitesseArret = profilSegment->vitesseDepart;
+		pasRampe = 0;
+	}
+	else {
+		vitesseCourante = segment.vitesseEntree != 0 ? segment.vitesseEntree : profilSegment->vitesseDepart;	// On démarre lentement, ou à la sortie du précédent,
+		vitesseArret = segment.vitesseSortie != 0 ? segment.vitesseSortie : profilSegment->vitesseDepart;
+		pasRampe = segment.rampeInitiale;								// et rien n'a encore été fait en accélérant.
+	}
+	accumulateur = 0;
+
+	segmentActif = true;
+	barriereMemoire();
+	teteFile = (teteFile + 1) % tailleFileMoteurs;						// La case est libérée pour le programme principal.
+}
+
+/**
+ * Le cœur du moteur de mouvement, appelé à chaque interruption du Timer2. Il fait évoluer la
+ * vitesse selon le profil trapézoïdal du segment en cours, l'ajoute à l'accumulateur de phase et,
+ * à chaque débordement de celui-ci, fait un pas sur chacune des roues qui doivent en faire un
+ * selon l'algorithme de Bresenham.
+ */
+void moteursInterruption() {
+	if (abandon) {														// Rien de ce qui est demandé ne sera fait,
+		abandonnerSegments();
+		return;
+	}
+	if (suspendus) {													// ni rien fait pendant une pause.
+		return;
+	}
+
+	if (!segmentActif) {												// Si rien n'est en cours,
+		if (teteFile == finFile) {										// et que rien n'attend, il n'y a rien à faire
+			desenchaines = true;										// et les moteurs sont arrêtés;
+			return;
+		}
+		demarrerSegment();												// sinon on démarre le segment suivant.
+	}
+
+	bool accelere = false;
+	if (pasRestants <= pasRampe) {										// S'il ne reste que les pas nécessaires pour freiner,
+		if (vitesseCourante > vitesseArret + profilSegment->acceleration) {
+			vitesseCourante -= profilSegment->acceleration;				// on décélère,
+		}
+		else {
+			vitesseCourante = vitesseArret;								// jusqu'à la vitesse d'arrêt;
+		}
+	}
+	else if (vitesseCourante < profilSegment->vitesseMax) {				// sinon, tant que le maximum n'est pas atteint,
+		accelere = true;												// on accélère.
+		if (profilSegment->vitesseMax - vitesseCourante > profilSegment->acceleration) {
+			vitesseCourante += profilSegment->acceleration;
+		}
+		else {
+			vitesseCourante = profilSegment->vitesseMax;
+		}
+	}
+
+	accumulateur += vitesseCourante;
+	if (accumulateur >= vitesseCourante) {								// Pas de débordement : pas de pas cette fois-ci.
+		return;
+	}
+
+	if (accelere) {														// Chaque pas fait en accélérant
+		pasRampe++;														// devra être refait en freinant.
+	}
+
+	erreurGauche += pasAbsGauche;										// Bresenham : chaque roue avance en proportion
+	if (erreurGauche >= pasTotal) {										// de son nombre de pas.
+		erreurGauche -= pasTotal;
+		phaseGauche = (phaseGauche + sensGauche) & (PHASES_BOBINES - 1);
+		materielBobines(MOTEUR_GAUCHE, phaseGauche);
+	}
+
+	erreurDroite += pasAbsDroite;
+	if (erreurDroite >= pasTotal) {
+		erreurDroite -= pasTotal;
+		phaseDroite = (phaseDroite + sensDroite) & (PHASES_BOBINES - 1);
+		materielBobines(MOTEUR_DROITE, phaseDroite);
+	}
+
+	if (--pasRestants == 0) {											// Le segment est fini.
+		segmentActif = false;
+	}
+}
@@ -0,0 +1,34 @@
+/**
+ * @file TortuinoMoteurs.h
+ * @brief Définition des fonctions implémentées dans TortuinoMoteurs.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoMoteurs.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions.
+ */
+
+
+# ifndef TORTUINO_MOTEURS_h
+#	define TORTUINO_MOTEURS_h
+
+	const unsigned char	PROFIL_TRACE		=	0;
+	const unsigned char	PROFIL_DEPLACEMENT	=	1;
+
+	typedef void (*TacheAttente)();
+
+	void moteursProfil(unsigned char profil, float vitesseDepart, float vitesseMax, float acceleration);
+	void moteursAjouter(long pasGauche, long pasDroite, unsigned char profil);
+	void moteursAjouterCadence(long pasGauche, long pasDroite, float pasParSeconde);
+	void moteursAjouterEnchaine(long pasGauche, long pasDroite, unsigned char profil, float vitesseEntree, float vitesseSortie);
+	void moteursLimites(unsigned char profil, float *limites);
+	bool moteursPlaceLibre();
+	void moteursAttendre();
+	bool moteursOccupes();
+	TacheAttente moteursTacheAttente(TacheAttente tache);
+	void moteursPatienter();
+	void moteursSuspendre(bool suspendre);
+	void moteursAbandonner(bool abandonner);
+	void moteursPasAbandonnes(long &pasGauche, long &pasDroite);
+	void moteursInterruption();
+
+# endif
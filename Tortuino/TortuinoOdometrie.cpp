@@ -0,0 +1,447 @@
+# include "TortuinoOdometrie.h"
+# include "TortuinoProfils.h"
+# include <math.h>
+# include <stdlib.h>
+
+
+/**
+ * @file TortuinoOdometrie.cpp
+ * @brief Ce fichier convertit les distances et les angles en pas de moteur, en virgule fixe.
+ * @version 1.0
+ *
+ * Le fichier TortuinoOdometrie.cpp réalise les conversions entre les grandeurs manipulées par
+ * l'utilisateur, en centimètres ou en degrés, et les pas que chaque roue doit faire. L'Arduino
+ * n'a pas d'unité de calcul flottant : chaque division ou multiplication de `float` y est
+ * émulée et coûte cher. Les conversions sont donc faites en virgule fixe Q16.16, c'est-à-dire
+ * sur des entiers de 32 bits dont les 16 bits de poids faible représentent la partie
+ * fractionnaire. Les facteurs de conversion viennent du profil du robot, calculé à la compilation
+ * dans TortuinoProfils.h, et ne sont calculés en `float` que si l'on calibre le robot à la main
+ * avec odometrieCalibrer().<br/>
+ *
+ * Une roue ne peut faire qu'un nombre entier de pas, mais la fraction de pas qui ne peut pas
+ * être faite n'est plus perdue : elle est gardée dans un résidu propre à chaque roue et reportée
+ * sur le mouvement suivant. Les milliers de segments d'un floconVonKoch() de niveau 6 ou d'un
+ * arbreAsymetrique() de niveau 15 ne dérivent donc plus à force d'être tronqués un par un :
+ * l'erreur sur la position de chaque roue reste toujours inférieure à un demi-pas.<br/>
+ *
+ * Les pas que chaque mouvement fait réellement faire aux roues servent aussi à suivre la pose du
+ * robot : sa position en centimètres et son cap en degrés, en Q16.16, par rapport à l'endroit où
+ * il a été initialisé. Les sinus et cosinus dont ce suivi a besoin sont calculés par l'algorithme
+ * <a href="https://fr.wikipedia.org/wiki/CORDIC">CORDIC</a>, qui n'utilise que des additions, des
+ * décalages et une table de seize arcs tangentes : allerA(float x, float y) peut ainsi rejoindre
+ * exactement un point connu, sans qu'un dessin ait à recalculer ses longueurs à la main. La pose
+ * est mise à jour dès qu'un mouvement est converti en pas : c'est celle où sera le robot une fois
+ * finis les mouvements confiés aux moteurs. Si ceux-ci en abandonnent, odometrieRetirer() en
+ * retire les pas qui n'ont pas été faits.
+ *
+ * @see odometrieTranslation(int32_t distanceQ16, long &pasGauche, long &pasDroite)
+ * @see odometrieRotation(int32_t angleQ16, long &pasGauche, long &pasDroite)
+ * @see odometriePose()
+ */
+
+
+
+const int32_t	UN_Q16		=	65536;				/**< La valeur 1 en virgule fixe Q16.16. */
+const int32_t	DEMI_TOUR_Q16	=	180L * 65536;	/**< Un angle de 180° en Q16.16. */
+const int32_t	RADIANS_PAR_DEGRE_Q24	=	292803;	/**< Le nombre de radians d'un degré, pi / 180, en Q8.24. */
+const int32_t	GAIN_CORDIC	=	39797;				/**< L'inverse du gain des itérations de CORDIC, 0,60725, en Q16.16. */
+const int		NB_ITERATIONS_CORDIC	=	16;		/**< Le nombre d'itérations de CORDIC, une par bit de la partie fractionnaire. */
+const int32_t	anglesCordic[NB_ITERATIONS_CORDIC]	=	{	/**< Les angles arctan(2^-i) en degrés en Q16.16, dont CORDIC tourne à l'itération i. */
+	2949120,	1740967,	919879,	466945,	234379,	117304,	58666,	29335,
+	14668,	7334,	3667,	1833,	917,	458,	229,	115
+};
+
+Geometrie		geometrie	=	ProfilStandard::geometrie();	/**< La géométrie du robot utilisé et ses facteurs de conversion. */
+int32_t			residuGauche		=	UN_Q16 / 2,	/**< La fraction de pas de la roue gauche pas encore faite, en Q16.16. Le demi-pas initial arrondit au plus proche. */
+				residuDroite		=	UN_Q16 / 2;	/**< La fraction de pas de la roue droite pas encore faite, en Q16.16. Le demi-pas initial arrondit au plus proche. */
+Pose			pose		=	{0, 0, 0};			/**< La position en centimètres et le cap en degrés du robot, en Q16.16, d'après les pas confiés à ses moteurs. */
+
+const int		tailleHistorique	=	8;			/**< Le nombre de mouvements dont les pas sont gardés : plus que les moteurs n'en peuvent abandonner, c'est-à-dire leur file, le segment en cours et celui ajouté pendant que l'abandon commence. */
+
+/**
+ * Les pas d'un mouvement déjà comptés dans la pose, gardés pour pouvoir l'en retirer si les
+ * moteurs l'abandonnent.
+ */
+struct Mouvement {
+	long pasGauche;														/**< Le nombre de pas signé de la roue gauche. */
+	long pasDroite;														/**< Le nombre de pas signé de la roue droite. */
+};
+
+Mouvement		historique[tailleHistorique];	/**< Les derniers mouvements comptés dans la pose, dans une file circulaire. */
+uint8_t			finHistorique	=	0,			/**< L'indice de la case où sera gardé le prochain mouvement. */
+				nbHistorique	=	0;			/**< Le nombre de mouvements gardés. */
+
+
+/**
+ * Convertit une valeur décimale en virgule fixe Q16.16. C'est la seule opération flottante
+ * faite par mouvement, à l'entrée de la bibliothèque.
+ *
+ * @param  valeur La valeur à convertir, entre -32768 et 32767.
+ * @return        La valeur en Q16.16, arrondie au plus proche.
+ */
+int32_t versQ16(float valeur) {
+	return (int32_t)lround(valeur * UN_Q16);
+}
+
+/**
+ * Multiplie deux nombres en virgule fixe Q16.16.
+ *
+ * @param  a Le premier facteur en Q16.16.
+ * @param  b Le second facteur en Q16.16.
+ * @return   Le produit en Q16.16.
+ */
+int32_t multiplierQ16(int32_t a, int32_t b) {
+	return (int32_t)(((int64_t)a * b) / UN_Q16);						// Le produit intermédiaire tient sur 64 bits.
+}
+
+/**
+ * Ramène un angle entre -180° exclu et 180° inclus.
+ *
+ * @param  angleQ16 L'angle en degrés en Q16.16.
+ * @return          Le même angle à un nombre de tours près, en Q16.16.
+ */
+int32_t normaliserAngleQ16(int32_t angleQ16) {
+	while (angleQ16 > DEMI_TOUR_Q16) {
+		angleQ16 -= 2 * DEMI_TOUR_Q16;
+	}
+	while (angleQ16 <= -DEMI_TOUR_Q16) {
+		angleQ16 += 2 * DEMI_TOUR_Q16;
+	}
+	return angleQ16;
+}
+
+/**
+ * Calcule le cosinus et le sinus d'un angle par CORDIC en mode rotation : le vecteur de départ
+ * est tourné de plus ou moins arctan(2^-i) à chaque itération jusqu'à ce que l'angle restant soit
+ * nul, ce qui ne demande que des additions et des décalages.
+ *
+ * @param angleQ16 L'angle en degrés en Q16.16.
+ * @param cosinus  Reçoit son cosinus en Q16.16.
+ * @param sinus    Reçoit son sinus en Q16.16.
+ */
+void cosinusSinusQ16(int32_t angleQ16, int32_t &cosinus, int32_t &sinus) {
+	int32_t z = normaliserAngleQ16(angleQ16);
+	bool oppose = false;
+	if (z > DEMI_TOUR_Q16 / 2) {										// CORDIC ne converge qu'entre -99° et 99° :
+		z -= DEMI_TOUR_Q16;												// au-delà, on calcule pour l'angle opposé
+		oppose = true;													// et on change les signes à la fin.
+	}
+	else if (z < -DEMI_TOUR_Q16 / 2) {
+		z += DEMI_TOUR_Q16;
+		oppose = true;
+	}
+
+	int32_t x = GAIN_CORDIC, y = 0;										// Le gain des rotations est compensé dès le départ.
+	for (int i = 0; i < NB_ITERATIONS_CORDIC; i++) {
+		int32_t dx = y >> i, dy = x >> i;
+		if (z >= 0) {
+			x -= dx;
+			y += dy;
+			z -= anglesCordic[i];
+		}
+		else {
+			x += dx;
+			y -= dy;
+			z += anglesCordic[i];
+		}
+	}
+
+	cosinus = oppose ? -x : x;
+	sinus = oppose ? -y : y;
+}
+
+/**
+ * Calcule les coordonnées polaires d'un vecteur par CORDIC en mode vectoriel : le vecteur est
+ * tourné vers l'axe des abscisses en cumulant les angles dont il a fallu le tourner. Les
+ * coordonnées ne doivent pas dépasser 100 mètres, pour que les calculs tiennent sur 32 bits.
+ *
+ * @param  x        L'abscisse du vecteur en Q16.16.
+ * @param  y        Son ordonnée en Q16.16.
+ * @param  angleQ16 Reçoit sa direction en degrés en Q16.16, entre -180° exclu et 180° inclus.
+ * @return          Sa norme en Q16.16.
+ */
+int32_t polaireQ16(int32_t x, int32_t y, int32_t &angleQ16) {
+	int32_t z = 0;
+	if (x < 0) {														// Le vecteur est d'abord ramené du côté des abscisses positives.
+		x = -x;
+		y = -y;
+		z = DEMI_TOUR_Q16;
+	}
+
+	for (int i = 0; i < NB_ITERATIONS_CORDIC; i++) {
+		int32_t dx = y >> i, dy = x >> i;
+		if (y > 0) {
+			x += dx;
+			y -= dy;
+			z += anglesCordic[i];
+		}
+		else {
+			x -= dx;
+			y += dy;
+			z -= anglesCordic[i];
+		}
+	}
+
+	angleQ16 = normaliserAngleQ16(z);
+	return multiplierQ16(x, GAIN_CORDIC);
+}
+
+/**
+ * Adopte la géométrie d'un des profils de TortuinoProfils.h, dont les facteurs de conversion
+ * ont été calculés à la compilation. Elle est appelée par initialiser(char couleur).
+ *
+ * @param nouvelle La géométrie du robot, par exemple `ProfilBleu::geometrie()`.
+ */
+void odometrieProfil(const Geometrie &nouvelle) {
+	geometrie = nouvelle;
+}
+
+/**
+ * Calcule les facteurs de conversion à partir de dimensions mesurées à la main. Elle est appelée
+ * par initialiser(float braquage) pour calibrer un robot sans avoir à le recompiler ; c'est le
+ * seul endroit où la conversion fait des calculs flottants.
+ *
+ * @param perimetre  Le périmètre des roues en centimètres.
+ * @param braquage   Le rayon de braquage en centimètres.
+ * @param pasParTour Le nombre de pas d'un moteur pour un tour de roue.
+ */
+void odometrieCalibrer(float perimetre, float braquage, int pasParTour) {
+	float parCentimetre = pasParTour / perimetre;
+	float parDegre = M_PI / 180 * braquage * parCentimetre;				// Une rotation fait parcourir à chaque roue un arc de cercle de rayon le braquage.
+
+	geometrie.perimetre = perimetre;
+	geometrie.braquage = braquage;
+	geometrie.pasParTour = pasParTour;
+	geometrie.pasParCentimetre = versQ16(parCentimetre);
+	geometrie.pasParDegre = versQ16(parDegre);
+	for (int i = 0; i < nbAnglesCourants; i++) {
+		geometrie.pasAngles[i] = versQ16(anglesCourants[i] * parDegre);
+	}
+	geometrie.avanceParPas = lround(0.5 / parCentimetre * 16777216);
+	geometrie.rotationParPas = lround(0.5 / parDegre * 16777216);
+}
+
+/**
+ * Donne la géométrie du robot utilisé.
+ *
+ * @return La géométrie et les facteurs de conversion actuels.
+ */
+const Geometrie &odometrieGeometrie() {
+	return geometrie;
+}
+
+/**
+ * Ajoute une avance à la position d'une roue et en déduit le nombre entier de pas à faire.
+ * La fraction restante est gardée dans le résidu pour le mouvement suivant. L'avance est sur
+ * 64 bits : en Q16.16, 32 bits ne compteraient que 32767 pas, soit moins de cinq mètres, et
+ * moitié moins en demi-pas.
+ *
+ * @param  residu La fraction de pas que la roue n'a pas encore faite, en Q16.16.
+ * @param  avance L'avance à ajouter, en pas au format Q16.16.
+ * @return        Le nombre entier de pas que la roue doit faire.
+ */
+long avancerRoue(int32_t &residu, int64_t avance) {
+	int64_t total = residu + avance;
+	residu = (int32_t)(total & (UN_Q16 - 1));							// La partie fractionnaire, toujours positive,
+	return (long)((total - residu) / UN_Q16);							// et la partie entière, arrondie vers le bas même si négative.
+}
+
+/**
+ * Multiplie un nombre entier par un facteur en Q8.24, en arrondissant au plus proche.
+ *
+ * @param  n       Le nombre entier, par exemple de pas.
+ * @param  facteur Le facteur en Q8.24.
+ * @return         Le produit en Q16.16.
+ */
+int32_t multiplierQ24(int32_t n, int32_t facteur) {
+	return (int32_t)(((int64_t)n * facteur + (1 << 7)) >> 8);			// Un décalage, pas une division : l'Arduino n'a pas de diviseur.
+}
+
+/**
+ * Met à jour la pose du robot d'après les pas que ses roues viennent de recevoir. La moitié de
+ * leur différence est l'avance du feutre, la moitié de leur somme sa rotation, obtenues par une
+ * multiplication chacune, sans aucune division. Le feutre parcourt alors un arc, dont la corde est
+ * l'avance multipliée par sin(a) / a pour a la moitié de l'angle, dans la direction du cap pris
+ * à mi-chemin.
+ *
+ * @param pasGauche Le nombre de pas signé de la roue gauche.
+ * @param pasDroite Le nombre de pas signé de la roue droite.
+ */
+void suivrePose(long pasGauche, long pasDroite) {
+	int32_t avance = multiplierQ24(pasDroite - pasGauche, geometrie.avanceParPas);
+	int32_t rotation = multiplierQ24(pasDroite + pasGauche, geometrie.rotationParPas);
+
+	int32_t corde = avance;
+	int32_t demiAngle = rotation / 2;
+	if (demiAngle != 0 && avance != 0) {
+		int32_t demiAngleAbsolu = demiAngle < 0 ? -demiAngle : demiAngle;	// sin(a) / a est pair : le signe ne compte pas.
+		int32_t radians = (int32_t)(((int64_t)demiAngleAbsolu * RADIANS_PAR_DEGRE_Q24 + (1L << 23)) >> 24);
+		int32_t carre = multiplierQ16(radians, radians);
+		if (demiAngleAbsolu < DEMI_TOUR_Q16 / 6) {						// En dessous de 30°, le développement limité
+			corde = multiplierQ16(avance, UN_Q16 - carre / 6 + multiplierQ16(carre, carre) / 120);	// est plus précis que la division.
+		}
+		else {															// Au-delà, seul un grand arc, rare, paie une division.
+			int32_t cosinus, sinus;
+			cosinusSinusQ16(demiAngleAbsolu, cosinus, sinus);
+			corde = (int32_t)(((int64_t)avance * sinus + (avance < 0 ? -radians : radians) / 2) / radians);
+		}
+	}
+
+	int32_t cosinus, sinus;
+	cosinusSinusQ16(pose.cap + demiAngle, cosinus, sinus);
+	pose.x += multiplierQ16(corde, cosinus);
+	pose.y += multiplierQ16(corde, sinus);
+	pose.cap = normaliserAngleQ16(pose.cap + rotation);
+}
+
+/**
+ * Compte un mouvement dans la pose, et le garde dans l'historique pour pouvoir l'en retirer.
+ *
+ * @param pasGauche Le nombre de pas signé de la roue gauche.
+ * @param pasDroite Le nombre de pas signé de la roue droite.
+ */
+void suivreMouvement(long pasGauche, long pasDroite) {
+	suivrePose(pasGauche, pasDroite);
+
+	historique[finHistorique].pasGauche = pasGauche;
+	historique[finHistorique].pasDroite = pasDroite;
+	finHistorique = (finHistorique + 1) % tailleHistorique;
+	if (nbHistorique < tailleHistorique) {
+		nbHistorique++;
+	}
+}
+
+/**
+ * Convertit une translation en nombres de pas pour chaque roue, en reportant les fractions de
+ * pas des mouvements précédents.
+ *
+ * @param distanceQ16 La distance en centimètres en Q16.16, négative pour reculer.
+ * @param pasGauche   Reçoit le nombre de pas signé de la roue gauche.
+ * @param pasDroite   Reçoit le nombre de pas signé de la roue droite.
+ */
+void odometrieTranslation(int32_t distanceQ16, long &pasGauche, long &pasDroite) {
+	int64_t avance = (int64_t)distanceQ16 * geometrie.pasParCentimetre / UN_Q16;	// Le nombre de pas ne tient pas sur 32 bits au-delà de 4,6 m.
+	pasDroite = avancerRoue(residuDroite, avance);						// Les moteurs se font face :
+	pasGauche = avancerRoue(residuGauche, -avance);						// pour avancer, ils tournent en sens opposés.
+	suivreMouvement(pasGauche, pasDroite);
+}
+
+/**
+ * Convertit un angle en nombre de pas de chaque roue, en Q16.16. Les angles entiers les plus
+ * courants sont lus dans la table précalculée du profil ; les autres sont multipliés.
+ *
+ * @param  angleQ16 L'angle en degrés en Q16.16.
+ * @return          Le nombre de pas de chaque roue en Q16.16, du signe de l'angle.
+ */
+int32_t pasRotation(int32_t angleQ16) {
+	if ((angleQ16 & (UN_Q16 - 1)) == 0) {								// Si l'angle est un nombre entier de degrés,
+		int32_t degres = angleQ16 / UN_Q16;
+		for (int i = 0; i < nbAnglesCourants; i++) {					// on le cherche parmi les angles courants.
+			if (degres == anglesCourants[i]) {
+				return geometrie.pasAngles[i];
+			}
+			if (degres == -anglesCourants[i]) {
+				return -geometrie.pasAngles[i];
+			}
+		}
+	}
+
+	return multiplierQ16(angleQ16, geometrie.pasParDegre);
+}
+
+/**
+ * Convertit une rotation sur place en nombres de pas pour chaque roue, en reportant les
+ * fractions de pas des mouvements précédents.
+ *
+ * @param angleQ16  L'angle en degrés vers la gauche en Q16.16, négatif vers la droite.
+ * @param pasGauche Reçoit le nombre de pas signé de la roue gauche.
+ * @param pasDroite Reçoit le nombre de pas signé de la roue droite.
+ */
+void odometrieRotation(int32_t angleQ16, long &pasGauche, long &pasDroite) {
+	int32_t avance = pasRotation(angleQ16);
+	pasDroite = avancerRoue(residuDroite, avance);						// Pour tourner, les deux moteurs tournent
+	pasGauche = avancerRoue(residuGauche, avance);						// dans le même sens.
+	suivreMouvement(pasGauche, pasDroite);
+}
+
+/**
+ * Convertit un arc de cercle en nombres de pas pour chaque roue, en reportant les fractions de
+ * pas des mouvements précédents. Un arc est la somme d'une translation et d'une rotation faites
+ * en même temps : la roue extérieure parcourt la translation plus l'arc du braquage, la roue
+ * intérieure la translation moins cet arc.
+ *
+ * @param distanceQ16 La distance parcourue par le feutre le long de l'arc, en centimètres en
+ * 					  Q16.16, négative pour reculer.
+ * @param angleQ16    L'angle en degrés dont le robot tourne vers la gauche en Q16.16, négatif
+ * 					  vers la droite.
+ * @param pasGauche   Reçoit le nombre de pas signé de la roue gauche.
+ * @param pasDroite   Reçoit le nombre de pas signé de la roue droite.
+ */
+void odometrieArc(int32_t distanceQ16, int32_t angleQ16, long &pasGauche, long &pasDroite) {
+	int32_t avance = multiplierQ16(distanceQ16, geometrie.pasParCentimetre);
+	int32_t rotation = pasRotation(angleQ16);
+	pasDroite = avancerRoue(residuDroite, avance + rotation);
+	pasGauche = avancerRoue(residuGauche, rotation - avance);
+	suivreMouvement(pasGauche, pasDroite);
+}
+
+/**
+ * Donne le facteur de conversion des distances en pas.
+ *
+ * @return Le nombre de pas d'une roue par centimètre parcouru, en Q16.16.
+ */
+int32_t odometriePasParCentimetre() {
+	return geometrie.pasParCentimetre;
+}
+
+/**
+ * Donne la pose du robot, d'après tous les pas qu'ont reçus ses roues depuis odometrieOrigine().
+ * L'axe des abscisses suit le cap de départ, celui des ordonnées part vers la gauche du robot.
+ *
+ * @return La position en centimètres et le cap en degrés vers la gauche, en Q16.16.
+ */
+const Pose &odometriePose() {
+	return pose;
+}
+
+/**
+ * Retire de la pose des pas que les moteurs ont abandonnés sans les faire, pour qu'elle redevienne
+ * celle où le robot s'est arrêté. Les pas abandonnés sont toujours ceux des derniers mouvements :
+ * ils sont retirés du plus récent au plus ancien, chacun en parcourant son arc à l'envers, et le
+ * premier mouvement qui n'a été abandonné qu'en partie n'en perd que le reste. Au-delà des
+ * tailleHistorique derniers mouvements, le reste serait retiré d'un seul arc.
+ *
+ * @param pasGauche Le nombre de pas signé abandonnés par la roue gauche.
+ * @param pasDroite Le nombre de pas signé abandonnés par la roue droite.
+ */
+void odometrieRetirer(long pasGauche, long pasDroite) {
+	while ((pasGauche != 0 || pasDroite != 0) && nbHistorique > 0) {
+		finHistorique = (finHistorique + tailleHistorique - 1) % tailleHistorique;
+		nbHistorique--;
+		const Mouvement &mouvement = historique[finHistorique];
+		if (labs(mouvement.pasGauche) >= labs(pasGauche) && labs(mouvement.pasDroite) >= labs(pasDroite)) {
+			break;														// Le mouvement interrompu : seul le reste est retiré.
+		}
+
+		suivrePose(-mouvement.pasGauche, -mouvement.pasDroite);			// Un mouvement entièrement abandonné.
+		pasGauche -= mouvement.pasGauche;
+		pasDroite -= mouvement.pasDroite;
+	}
+
+	suivrePose(-pasGauche, -pasDroite);
+}
+
+/**
+ * Prend la pose actuelle du robot comme origine de ses coordonnées et de son cap. Elle est
+ * appelée par initialiser(). Les fractions de pas reportées par chaque roue repartent aussi du
+ * demi-pas, pour qu'un même dessin fasse toujours les mêmes pas à partir de l'origine, quels que
+ * soient les mouvements faits avant.
+ */
+void odometrieOrigine() {
+	pose.x = 0;
+	pose.y = 0;
+	pose.cap = 0;
+	residuGauche = UN_Q16 / 2;
+	residuDroite = UN_Q16 / 2;
+	nbHistorique = 0;
+}
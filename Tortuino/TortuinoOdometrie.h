@@ -0,0 +1,41 @@
+/**
+ * @file TortuinoOdometrie.h
+ * @brief Définition des fonctions implémentées dans TortuinoOdometrie.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoOdometrie.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions et le
+ * type de la pose du robot.
+ */
+
+
+# ifndef TORTUINO_ODOMETRIE_h
+#	define TORTUINO_ODOMETRIE_h
+
+#	include <stdint.h>
+#	include "TortuinoProfils.h"
+
+	struct Pose {
+		int32_t x;
+		int32_t y;
+		int32_t cap;
+	};
+
+	int32_t versQ16(float valeur);
+	int32_t multiplierQ16(int32_t a, int32_t b);
+	int32_t normaliserAngleQ16(int32_t angleQ16);
+	void cosinusSinusQ16(int32_t angleQ16, int32_t &cosinus, int32_t &sinus);
+	int32_t polaireQ16(int32_t x, int32_t y, int32_t &angleQ16);
+
+	void odometrieProfil(const Geometrie &nouvelle);
+	void odometrieCalibrer(float perimetre, float braquage, int pasParTour);
+	const Geometrie &odometrieGeometrie();
+	void odometrieTranslation(int32_t distanceQ16, long &pasGauche, long &pasDroite);
+	void odometrieRotation(int32_t angleQ16, long &pasGauche, long &pasDroite);
+	void odometrieArc(int32_t distanceQ16, int32_t angleQ16, long &pasGauche, long &pasDroite);
+	int32_t odometriePasParCentimetre();
+	const Pose &odometriePose();
+	void odometrieRetirer(long pasGauche, long pasDroite);
+	void odometrieOrigine();
+
+# endif
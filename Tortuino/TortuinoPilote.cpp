@@ -0,0 +1,228 @@
+# include <stddef.h>
+# include "TortuinoPilote.h"
+# include "TortuinoCommandes.h"
+# include "TortuinoFeutre.h"
+# include "TortuinoMateriel.h"
+# include "TortuinoMoteurs.h"
+# include "TortuinoOdometrie.h"
+
+
+/**
+ * @file TortuinoPilote.cpp
+ * @brief Ce fichier fait avancer les commandes du robot depuis `loop()`, sans jamais attendre.
+ * @version 1.0
+ *
+ * Le fichier TortuinoPilote.cpp est une alternative aux fonctions bloquantes de Tortuino.cpp,
+ * qui ne rendent la main qu'une fois leur mouvement fini. Après piloteDemarrer(), les fonctions
+ * de base comme avancer() ou monterFeutre() ne font plus que placer leur commande dans la file
+ * de TortuinoCommandes.cpp, où elle peut toujours se combiner avec les autres. C'est
+ * piloteActualiser(), appelée à chaque tour de `loop()`, qui démarre chaque commande dès que le
+ * robot est prêt à l'exécuter, sans jamais attendre ni les moteurs ni le feutre : le croquis
+ * garde la main pendant tout le dessin, pour lire la liaison série ou une carte SD par exemple.
+ *
+ * {@code
+ * 	void setup() {
+ * 		initialiser();
+ * 		piloteDemarrer();
+ * 	}
+ *
+ * 	void loop() {
+ * 		if (piloteLibre() && Serial.available() > 0) {	// Une commande reçue pendant que le robot roule
+ * 			avancer(Serial.parseFloat());				// est ajoutée aux autres,
+ * 		}
+ * 		piloteActualiser();								// et toutes avancent à leur rythme.
+ * 	}
+ * }
+ *
+ * La file ne garde que seize commandes : une commande ajoutée alors qu'elle est pleine, ce que
+ * piloteLibre() permet d'éviter, attend que la plus ancienne ait été exécutée. Les dessins de
+ * TortuinoDessins.cpp, qui en produisent bien plus, se comportent donc comme avant, à ceci près
+ * que leurs seize dernières commandes sont laissées à piloteActualiser().<br/>
+ *
+ * Le bouton du robot devient en même temps une télécommande, surveillée par interruption : un
+ * appui court met le dessin en pause, les moteurs s'arrêtant au milieu de leur mouvement, et un
+ * second le fait reprendre ; un appui d'au moins dureeAppuiLong l'abandonne. Le bouton n'agit que
+ * si le robot a quelque chose à faire, ce qui laisse attendreBouton() fonctionner comme avant :
+ * les moteurs tournent, ou des commandes attendaient au dernier appel de piloteActualiser(), car
+ * l'interruption ne lit pas la file. Cela marche aussi pendant les fonctions bloquantes, qui
+ * attendent simplement la fin de la pause. Après un abandon, les commandes sont ignorées et le
+ * feutre est levé une fois, hors de l'interruption, si bien qu'un dessin bloquant se termine
+ * aussitôt, jusqu'à l'appel de piloteReprendre() : position() donne alors l'endroit où le robot
+ * s'est arrêté, dans les mêmes coordonnées qu'avant l'abandon.
+ *
+ * @see piloteActualiser()
+ */
+
+
+
+const unsigned long	dureeAppuiLong	=	1000;		/**< La durée en ms à partir de laquelle un appui sur le bouton abandonne le dessin au lieu de le mettre en pause. */
+const unsigned long	delaiRebond		=	30;			/**< La durée en ms pendant laquelle les changements d'état du bouton qui en suivent un autre sont des rebonds, ignorés. */
+
+volatile bool			enPause			=	false;	/**< Vrai pendant une pause demandée par le bouton ou par piloteSuspendre(). */
+volatile bool			abandonne		=	false;	/**< Vrai après un abandon, jusqu'à piloteReprendre(). */
+volatile bool			appuiEnCours	=	false;	/**< Vrai entre un appui sur le bouton et son relâchement. */
+volatile unsigned long	debutAppui		=	0;		/**< L'instant en ms du dernier appui sur le bouton. */
+volatile unsigned long	dernierChangement	=	0;	/**< L'instant en ms du dernier changement d'état du bouton retenu. */
+volatile bool			travailEnAttente	=	false;	/**< Vrai si des commandes attendaient dans la file au dernier appel de piloteActualiser() : l'interruption du bouton ne lit pas la file elle-même. */
+volatile bool			feutreALever	=	false;	/**< Vrai entre un abandon et le moment où le programme principal lève le feutre. */
+
+
+/**
+ * Reçoit, depuis l'interruption de sa broche, chaque changement d'état du bouton, et met en pause,
+ * fait reprendre ou abandonne le dessin lorsqu'il est relâché.
+ *
+ * @param appuye Vrai si le bouton vient d'être appuyé.
+ */
+void changementBouton(bool appuye) {
+	unsigned long maintenant = materielMillis();
+	if (maintenant - dernierChangement < delaiRebond) {					// Un rebond du contact.
+		return;
+	}
+	dernierChangement = maintenant;
+
+	if (appuye) {
+		debutAppui = maintenant;
+		appuiEnCours = true;
+		return;
+	}
+	if (!appuiEnCours) {
+		return;
+	}
+	appuiEnCours = false;
+
+	if (!enPause && !moteursOccupes() && !travailEnAttente) {			// Rien à interrompre : c'est peut-être
+		return;															// attendreBouton() qui attend cet appui.
+	}
+	if (maintenant - debutAppui >= dureeAppuiLong) {
+		abandonne = true;
+		feutreALever = true;											// Le servomoteur n'est commandé que hors de l'interruption.
+		enPause = false;
+		moteursAbandonner(true);										// Les moteurs se vident d'eux-mêmes,
+		moteursSuspendre(false);										// et ne doivent pas rester suspendus pour cela.
+	}
+	else {
+		enPause = !enPause;
+		moteursSuspendre(enPause);
+	}
+}
+
+/**
+ * Passe au pilotage sans attente : les commandes de base ne sont plus exécutées par les fonctions
+ * qui les ajoutent, mais par piloteActualiser(), et le bouton est surveillé par interruption.
+ * Elle s'appelle après initialiser(), dont l'attente du bouton n'est pas concernée.
+ *
+ * @see piloteArreter()
+ */
+void piloteDemarrer() {
+	commandesDifferer(true);
+	travailEnAttente = commandesProchaine() != NULL;
+	appuiEnCours = false;
+	materielBoutonSurveiller(changementBouton);
+}
+
+/**
+ * Fait avancer le dessin sans jamais attendre : démarre toutes les commandes en attente que le
+ * robot peut exécuter dès maintenant. Elle peut être appelée aussi souvent que l'on veut, par
+ * exemple à chaque tour de `loop()` ; plus elle l'est, moins le robot reste arrêté entre deux
+ * commandes.
+ *
+ * @return Vrai tant que des commandes attendent ou que les moteurs tournent, faux une fois le
+ * 		   dessin fini.
+ * @see piloteDemarrer()
+ */
+bool piloteActualiser() {
+	if (!enPause) {
+		while (demarrerProchaine()) {
+		}
+	}
+	piloteLeverFeutre();
+
+	travailEnAttente = commandesProchaine() != NULL;
+	return travailEnAttente || moteursOccupes();
+}
+
+/**
+ * Lève le feutre une seule fois après un abandon, ce que l'interruption du bouton laisse au
+ * programme principal. Elle est appelée par piloteActualiser() et par chaque commande ignorée.
+ */
+void piloteLeverFeutre() {
+	if (feutreALever) {
+		feutreALever = false;
+		feutrePositionner(true);
+	}
+}
+
+/**
+ * Indique si une commande peut être ajoutée sans attendre, c'est-à-dire si la file n'est pas
+ * pleine.
+ *
+ * @return Vrai si la prochaine commande ajoutée rendra la main immédiatement.
+ */
+bool piloteLibre() {
+	return !commandesPleine();
+}
+
+/**
+ * Met le dessin en pause comme le ferait un appui court sur le bouton.
+ *
+ * @see piloteReprendre()
+ */
+void piloteSuspendre() {
+	if (!abandonne) {
+		enPause = true;
+		moteursSuspendre(true);
+	}
+}
+
+/**
+ * Fait reprendre le dessin après une pause, ou permet d'en commencer un nouveau après un
+ * abandon : les commandes encore en attente sont oubliées, et les pas que les moteurs n'ont pas
+ * faits sont retirés de la pose, si bien que position() donne l'endroit où le robot s'est arrêté,
+ * feutre levé, dans les coordonnées de initialiser(). allerA(float x, float y) peut ainsi le
+ * ramener à un point connu, comme son point de départ.
+ */
+void piloteReprendre() {
+	if (abandonne) {
+		commandesVider();												// Elles sont ignorées tant que dure l'abandon.
+		moteursAbandonner(false);
+		long pasGauche, pasDroite;
+		moteursPasAbandonnes(pasGauche, pasDroite);
+		odometrieRetirer(pasGauche, pasDroite);
+		travailEnAttente = false;
+		abandonne = false;
+	}
+
+	enPause = false;
+	moteursSuspendre(false);
+}
+
+/**
+ * Indique si le dessin est en pause.
+ *
+ * @return Vrai entre une pause et sa reprise.
+ */
+bool piloteEnPause() {
+	return enPause;
+}
+
+/**
+ * Indique si le dessin a été abandonné par un appui long sur le bouton.
+ *
+ * @return Vrai entre l'abandon et l'appel de piloteReprendre().
+ */
+bool piloteAbandonne() {
+	return abandonne;
+}
+
+/**
+ * Revient aux fonctions bloquantes : la surveillance du bouton s'arrête, et les commandes encore
+ * en attente sont exécutées avant de rendre la main.
+ *
+ * @see piloteDemarrer()
+ */
+void piloteArreter() {
+	materielBoutonSurveiller(NULL);
+	piloteReprendre();
+	commandesDifferer(false);
+	commandesVider();
+}
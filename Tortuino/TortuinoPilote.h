@@ -0,0 +1,24 @@
+/**
+ * @file TortuinoPilote.h
+ * @brief Définition des fonctions implémentées dans TortuinoPilote.cpp
+ * @version 1.0
+ *
+ * Ce fichier constitue l'en-tête de TortuinoPilote.cpp. Il permet de préciser ce
+ * qui sera rendu accessible à d'autres programmes. Ici, ce sont des fonctions.
+ */
+
+
+# ifndef TORTUINO_PILOTE_h
+#	define TORTUINO_PILOTE_h
+
+	void piloteDemarrer();
+	bool piloteActualiser();
+	void piloteLeverFeutre();
+	bool piloteLibre();
+	void piloteSuspendre();
+	void piloteReprendre();
+	bool piloteEnPause();
+	bool piloteAbandonne();
+	void piloteArreter();
+
+# endif
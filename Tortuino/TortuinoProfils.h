@@ -0,0 +1,163 @@
+/**
+ * @file TortuinoProfils.h
+ * @brief Les profils de géométrie de chaque robot, calculés à la compilation.
+ * @version 1.0
+ *
+ * Ce fichier décrit la géométrie de chacun des robots Tortuino : le diamètre de leurs roues, leur
+ * diamètre de braquage, le nombre de pas par tour de leurs moteurs et leur câblage. Chaque robot,
+ * identifié par sa couleur, a son propre type ProfilRobot dont tous les facteurs de conversion
+ * sont calculés par le compilateur grâce à `constexpr` : l'Arduino n'en calcule aucun, pas même
+ * à l'initialisation. Pour convertir un mouvement en pas, il ne fait qu'une conversion de
+ * flottant en virgule fixe par appel, celle de la distance ou de l'angle donné par versQ16() ;
+ * tout le reste se calcule en entiers, sauf le découpage d'un arc en morceaux. Les nombres de
+ * pas des angles les plus utilisés par les dessins (45, 60, 90, 120 et 135 degrés) sont aussi
+ * précalculés, ce qui évite même la multiplication pour ces rotations-là.<br/>
+ *
+ * Le nombre de pas par tour dépend aussi du mode de pas des moteurs, choisi par PHASES_BOBINES :
+ * en demi-pas, la séquence des bobines a huit phases au lieu de quatre, ce qui double la
+ * résolution et adoucit la rotation. Tous les facteurs de conversion, ainsi que stepsPerRevolution
+ * et distanceToStep(), suivent automatiquement ce choix.<br/>
+ *
+ * Les longueurs sont données en micromètres pour pouvoir être des paramètres de template, qui ne
+ * peuvent pas être des nombres décimaux. Pour calibrer un robot, c'est donc ici qu'il faut
+ * modifier son diamètre de braquage ; initialiser(float braquage) reste disponible pour essayer
+ * une valeur sans recompiler.
+ */
+
+
+# ifndef TORTUINO_PROFILS_h
+#	define TORTUINO_PROFILS_h
+
+//#	define TORTUINO_LECTEUR_SD
+
+#	include <stdint.h>
+#	include <math.h>
+
+	const int	PHASES_PAS_COMPLET		=	4;				/**< Le nombre de phases de la séquence des bobines en pas complets : deux bobines sont toujours alimentées. */
+	const int	PHASES_DEMI_PAS			=	8;				/**< Le nombre de phases de la séquence des bobines en demi-pas : une ou deux bobines alternativement. */
+	const int	PHASES_BOBINES			=	PHASES_PAS_COMPLET;	/**< Le mode de pas des moteurs : PHASES_PAS_COMPLET, ou PHASES_DEMI_PAS pour doubler la résolution. */
+
+	const int	PAS_PAR_TOUR_28BYJ48	=	64 * 64 / 2 * PHASES_BOBINES / PHASES_PAS_COMPLET;	/**< Le nombre de pas par tour du moteur pas à pas 28BYJ-48 dans le mode choisi ; c'est une donnée constructeur. */
+
+	const int	nbAnglesCourants	=	5;				/**< Le nombre d'angles dont le nombre de pas est précalculé. */
+	const int	anglesCourants[nbAnglesCourants]	=	{45, 60, 90, 120, 135};	/**< Les angles en degrés dont le nombre de pas est précalculé. */
+
+	/**
+	 * La géométrie d'un robot telle qu'utilisée par TortuinoOdometrie.cpp : ses dimensions et les
+	 * facteurs de conversion qui en découlent, en virgule fixe Q16.16. Les facteurs inverses, qui
+	 * convertissent les pas en centimètres ou en degrés pour suivre la pose, sont en Q8.24 : un pas
+	 * ne fait qu'une fraction de centimètre ou de degré, dont ils gardent ainsi plus de chiffres.
+	 */
+	struct Geometrie {
+		float perimetre;											/**< Le périmètre des roues du robot tel que mesuré avec le pneu, en centimètres. */
+		float braquage;												/**< Le rayon de braquage du robot, en centimètres. */
+		int pasParTour;												/**< Le nombre de pas d'un moteur pour un tour de roue. */
+		int32_t pasParCentimetre;									/**< Le nombre de pas d'une roue par centimètre parcouru, en Q16.16. */
+		int32_t pasParDegre;										/**< Le nombre de pas de chaque roue par degré de rotation sur place, en Q16.16. */
+		int32_t pasAngles[nbAnglesCourants];						/**< Le nombre de pas de chaque roue pour chacun des anglesCourants, en Q16.16. */
+		int32_t avanceParPas;										/**< L'avance du feutre en centimètres lorsqu'une seule roue fait un pas en avant, en Q8.24. */
+		int32_t rotationParPas;										/**< La rotation du robot en degrés lorsqu'une seule roue fait un pas, en Q8.24. */
+	};
+
+	/**
+	 * Le câblage standard d'un robot Tortuino : les broches des bobines des deux moteurs pas à
+	 * pas, dans l'ordre de la séquence, et celles du servomoteur et du bouton. Il n'a pas de
+	 * lecteur de carte SD.
+	 */
+	struct CablageTortuino {
+		static const int GAUCHE_1 = 10, GAUCHE_2 = 12, GAUCHE_3 = 11, GAUCHE_4 = 13;
+		static const int DROITE_1 = 2, DROITE_2 = 4, DROITE_3 = 3, DROITE_4 = 5;
+		static const int SERVO = 9;
+		static const int BOUTON = 7;
+		static const int SD_SELECTION = -1;
+	};
+
+	/**
+	 * Le câblage d'un robot équipé d'un lecteur de carte SD. Le lecteur utilise le bus SPI, dont
+	 * les broches 11, 12 et 13 sont celles du moteur de gauche dans le câblage standard : ce
+	 * moteur est donc déplacé sur les broches A0 à A3, et le lecteur est sélectionné par la 8.
+	 */
+	struct CablageLecteurSD {
+		static const int GAUCHE_1 = 14, GAUCHE_2 = 16, GAUCHE_3 = 15, GAUCHE_4 = 17;
+		static const int DROITE_1 = 2, DROITE_2 = 4, DROITE_3 = 3, DROITE_4 = 5;
+		static const int SERVO = 9;
+		static const int BOUTON = 7;
+		static const int SD_SELECTION = 8;
+	};
+
+#	ifdef TORTUINO_LECTEUR_SD
+	typedef CablageLecteurSD	CablageRobot;				/**< Le câblage utilisé par TortuinoMateriel.cpp, avec le lecteur de carte SD. */
+#	else
+	typedef CablageTortuino	CablageRobot;					/**< Le câblage utilisé par TortuinoMateriel.cpp ; décommenter TORTUINO_LECTEUR_SD pour lire des dessins sur une carte SD. */
+#	endif
+
+	/**
+	 * Convertit à la compilation une valeur décimale en virgule fixe Q16.16, arrondie au plus proche.
+	 *
+	 * @param  valeur La valeur à convertir.
+	 * @return        La valeur en Q16.16.
+	 */
+	constexpr int32_t constanteQ16(double valeur) {
+		return (int32_t)(valeur * 65536.0 + (valeur < 0 ? -0.5 : 0.5));
+	}
+
+	/**
+	 * Convertit à la compilation une valeur décimale en virgule fixe Q8.24, arrondie au plus proche.
+	 *
+	 * @param  valeur La valeur à convertir, entre -128 et 127.
+	 * @return        La valeur en Q8.24.
+	 */
+	constexpr int32_t constanteQ24(double valeur) {
+		return (int32_t)(valeur * 16777216.0 + (valeur < 0 ? -0.5 : 0.5));
+	}
+
+	/**
+	 * Le profil d'un robot, entièrement déterminé à la compilation par ses paramètres.
+	 *
+	 * @tparam DIAMETRE_ROUE     Le diamètre des roues avec le pneu, en micromètres.
+	 * @tparam DIAMETRE_BRAQUAGE Le diamètre de braquage, c'est-à-dire l'écart entre les roues, en micromètres.
+	 * @tparam PAS_PAR_TOUR      Le nombre de pas d'un moteur pour un tour de roue.
+	 * @tparam CABLAGE           Le câblage du robot.
+	 */
+	template <long DIAMETRE_ROUE, long DIAMETRE_BRAQUAGE, int PAS_PAR_TOUR = PAS_PAR_TOUR_28BYJ48, class CABLAGE = CablageTortuino>
+	struct ProfilRobot {
+		typedef CABLAGE Cablage;
+
+		static constexpr double perimetre() {
+			return M_PI * DIAMETRE_ROUE / 10000.0;
+		}
+
+		static constexpr double braquage() {
+			return DIAMETRE_BRAQUAGE / 20000.0;
+		}
+
+		static constexpr double parCentimetre() {
+			return PAS_PAR_TOUR / perimetre();
+		}
+
+		static constexpr double parDegre() {
+			return M_PI / 180 * braquage() * parCentimetre();				// Une rotation fait parcourir à chaque roue un arc de cercle de rayon le braquage.
+		}
+
+		static constexpr Geometrie geometrie() {
+			return Geometrie {
+				(float)perimetre(), (float)braquage(), PAS_PAR_TOUR,
+				constanteQ16(parCentimetre()), constanteQ16(parDegre()),
+				{
+					constanteQ16(45 * parDegre()), constanteQ16(60 * parDegre()), constanteQ16(90 * parDegre()),
+					constanteQ16(120 * parDegre()), constanteQ16(135 * parDegre())
+				},
+				constanteQ24(0.5 / parCentimetre()), constanteQ24(0.5 / parDegre())
+			};
+		}
+	};
+
+	typedef ProfilRobot<92000, 113000>	ProfilStandard;		/**< Le profil par défaut, utilisé par initialiser(). */
+	typedef ProfilRobot<92000, 113000>	ProfilBlanc;		/**< Le robot 'w'. */
+	typedef ProfilRobot<92000, 113000>	ProfilJaune;		/**< Le robot 'j'. */
+	typedef ProfilRobot<92000, 110000>	ProfilBleu;			/**< Le robot 'b'. */
+	typedef ProfilRobot<92000, 105000>	ProfilVert;			/**< Le robot 'v'. */
+	typedef ProfilRobot<92000, 113000>	ProfilRouge;		/**< Le robot 'r'. */
+	typedef ProfilRobot<92000, 113000>	ProfilNoir;			/**< Le robot 'n'. */
+
+# endif